@@ -0,0 +1,233 @@
+#ifndef ANALYTIC_H
+#define ANALYTIC_H
+
+#include "common/random_generator.h"
+#include <map>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * Аналитические решения стационарных систем массового обслуживания
+ *
+ * Формулы Эрланга B и C для M/M/c и M/M/c/K и формула Поллачека-Хинчина
+ * для M/G/1. Средние показатели не зависят от порядка выбора из очереди,
+ * пока дисциплина не смотрит на длительность обслуживания и не простаивает
+ * при непустой очереди (FIFO, LIFO, RANDOM, PRIORITY без ключей,
+ * ROUND_ROBIN), поэтому дисциплина в решение не входит.
+ */
+namespace Analytic {
+
+/**
+ * Средние показатели системы; имена в metrics() совпадают с
+ * ReplicationRunner::collect_metrics()
+ *
+ * exact - все средние известны точно; utilization_known - известна хотя бы
+ * средняя загрузка ядер (для G/G/c с бесконечным буфером это ρ при ρ < 1),
+ * которая служит управляющей переменной при моделировании.
+ */
+struct Result {
+    std::string model;                 // "M/M/4", "M/M/2/10", "M/G/1" (пусто - решения нет)
+    bool exact = false;
+    bool utilization_known = false;
+    double rho = 0.0;                  // предложенная нагрузка λE[S]/c
+    double utilization = 0.0;          // доля времени занятости ядра
+    double wait_time = 0.0;            // W_q
+    double system_time = 0.0;          // W
+    double queue_length = 0.0;         // L_q
+    double jobs_in_system = 0.0;       // L
+    double loss_probability = 0.0;
+    double p0 = 0.0;                   // вероятность пустой системы
+
+    std::map<std::string, double> metrics() const {
+        return {
+            {"avg_wait_time", wait_time},
+            {"avg_system_time", system_time},
+            {"server_utilization", utilization},
+            {"loss_probability", loss_probability},
+            {"avg_queue_length", queue_length},
+            {"avg_jobs_in_system", jobs_in_system},
+            {"rho", rho}
+        };
+    }
+};
+
+/**
+ * Формула Эрланга B: вероятность отказа в M/M/c/c при нагрузке a = λ/μ
+ * Рекуррентно B(k) = a·B(k-1) / (k + a·B(k-1)), без факториалов и степеней
+ */
+inline double erlang_b(int c, double a) {
+    if (c < 0 || a < 0.0) {
+        throw std::invalid_argument("Формула Эрланга B: c и нагрузка должны быть неотрицательными");
+    }
+    double b = 1.0;
+    for (int k = 1; k <= c; ++k) {
+        b = a * b / (k + a * b);
+    }
+    return b;
+}
+
+/**
+ * Формула Эрланга C: вероятность ожидания в M/M/c при a = λ/μ < c
+ */
+inline double erlang_c(int c, double a) {
+    if (c < 1 || a >= c) {
+        throw std::invalid_argument("Формула Эрланга C требует c ≥ 1 и a < c");
+    }
+    double b = erlang_b(c, a);
+    return c * b / (c - a * (1.0 - b));
+}
+
+namespace detail {
+
+inline Result unstable(std::string model, double rho) {
+    Result r;
+    r.model = std::move(model);
+    r.rho = rho;
+    double inf = std::numeric_limits<double>::infinity();
+    r.wait_time = r.system_time = r.queue_length = r.jobs_in_system = inf;
+    r.utilization = 1.0;
+    return r;
+}
+
+} // namespace detail
+
+/**
+ * M/M/c с бесконечным буфером; при ρ ≥ 1 стационарного режима нет
+ * (exact = false, средние бесконечны)
+ */
+inline Result mmc(double lambda, double mu, int c) {
+    if (lambda <= 0.0 || mu <= 0.0 || c < 1) {
+        throw std::invalid_argument("M/M/c: λ, μ и c должны быть положительными");
+    }
+    std::string model = "M/M/" + std::to_string(c);
+    double a = lambda / mu;
+    double rho = a / c;
+    if (rho >= 1.0) return detail::unstable(model, rho);
+
+    Result r;
+    r.model = model;
+    r.exact = r.utilization_known = true;
+    r.rho = r.utilization = rho;
+    double wait_probability = erlang_c(c, a);
+    r.queue_length = wait_probability * rho / (1.0 - rho);
+    r.wait_time = r.queue_length / lambda;
+    r.system_time = r.wait_time + 1.0 / mu;
+    r.jobs_in_system = lambda * r.system_time;
+    // Ровно c заданий в системе с вероятностью C(1 - ρ), и P0 = π_c · c! / a^c
+    r.p0 = wait_probability * (1.0 - rho);
+    for (int k = c; k >= 1; --k) r.p0 *= k / a;
+    return r;
+}
+
+/**
+ * M/M/c/K: buffer мест ожидания, то есть не больше c + buffer заданий в
+ * системе; buffer = 0 - система с отказами Эрланга. Стационарна при любой ρ.
+ */
+inline Result mmck(double lambda, double mu, int c, int buffer) {
+    if (lambda <= 0.0 || mu <= 0.0 || c < 1 || buffer < 0) {
+        throw std::invalid_argument("M/M/c/K: λ, μ, c должны быть положительными, буфер - неотрицательным");
+    }
+    int capacity = c + buffer;
+    double a = lambda / mu;
+
+    // Ненормированные вероятности p_n / p_0 с масштабированием против переполнения
+    double empty = 1.0;
+    double term = 1.0;
+    double total = 1.0;
+    double jobs = 0.0;
+    double waiting = 0.0;
+    for (int n = 1; n <= capacity; ++n) {
+        term *= a / std::min(n, c);
+        total += term;
+        jobs += n * term;
+        waiting += std::max(n - c, 0) * term;
+        if (total > 1e250) {
+            empty /= total;
+            term /= total;
+            jobs /= total;
+            waiting /= total;
+            total = 1.0;
+        }
+    }
+
+    Result r;
+    r.model = "M/M/" + std::to_string(c) + "/" + std::to_string(capacity);
+    r.exact = r.utilization_known = true;
+    r.rho = a / c;
+    r.loss_probability = term / total;
+    r.p0 = empty / total;
+    r.jobs_in_system = jobs / total;
+    r.queue_length = waiting / total;
+    double effective_lambda = lambda * (1.0 - r.loss_probability);
+    r.utilization = effective_lambda / (c * mu);
+    r.system_time = r.jobs_in_system / effective_lambda;
+    r.wait_time = r.queue_length / effective_lambda;
+    return r;
+}
+
+/**
+ * M/G/1 по формуле Поллачека-Хинчина: W_q = λE[S²] / (2(1 - ρ))
+ */
+inline Result mg1(double lambda, double mean, double variance) {
+    if (lambda <= 0.0 || mean <= 0.0 || variance < 0.0) {
+        throw std::invalid_argument("M/G/1: λ и E[S] должны быть положительными, дисперсия - неотрицательной");
+    }
+    std::string model = variance == 0.0 ? "M/D/1" : "M/G/1";
+    double rho = lambda * mean;
+    if (rho >= 1.0) return detail::unstable(model, rho);
+
+    Result r;
+    r.model = model;
+    r.exact = r.utilization_known = true;
+    r.rho = r.utilization = rho;
+    r.p0 = 1.0 - rho;
+    r.wait_time = lambda * (variance + mean * mean) / (2.0 * (1.0 - rho));
+    r.system_time = r.wait_time + mean;
+    r.queue_length = lambda * r.wait_time;
+    r.jobs_in_system = lambda * r.system_time;
+    return r;
+}
+
+inline Result md1(double lambda, double mean) {
+    return mg1(lambda, mean, 0.0);
+}
+
+/**
+ * Решение для конфигурации симулятора по генераторам прибытий и обслуживания
+ *
+ * Пуассоновский поток и экспоненциальное обслуживание - M/M/c или M/M/c/K;
+ * пуассоновский поток, одно ядро и бесконечный буфер - M/G/1. Во всех
+ * остальных случаях точного решения нет (exact = false), но при бесконечном
+ * буфере и ρ < 1 средняя загрузка ядер всё равно равна ρ.
+ */
+inline Result solve(const RandomGenerator& arrival, const RandomGenerator& service,
+                    int cores, int buffer) {
+    if (cores < 1) {
+        throw std::invalid_argument("Количество ядер должно быть положительным");
+    }
+    double lambda = 1.0 / arrival.mean();
+    bool poisson = dynamic_cast<const ExponentialGenerator*>(&arrival) != nullptr;
+    bool exponential = dynamic_cast<const ExponentialGenerator*>(&service) != nullptr;
+
+    if (poisson && exponential) {
+        double mu = 1.0 / service.mean();
+        return buffer < 0 ? mmc(lambda, mu, cores) : mmck(lambda, mu, cores, buffer);
+    }
+    if (poisson && cores == 1 && buffer < 0) {
+        return mg1(lambda, service.mean(), service.variance());
+    }
+
+    Result r;
+    r.rho = lambda * service.mean() / cores;
+    if (buffer < 0 && r.rho < 1.0) {
+        r.utilization_known = true;
+        r.utilization = r.rho;
+    }
+    return r;
+}
+
+} // namespace Analytic
+
+#endif // ANALYTIC_H
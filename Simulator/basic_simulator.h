@@ -0,0 +1,326 @@
+#ifndef BASIC_SIMULATOR_H
+#define BASIC_SIMULATOR_H
+
+#include "simulator.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * Шаблонный цикл событий Simulator и его статически типизированный вариант
+ *
+ * Цикл параметризован точными типами генераторов и дисциплины очереди.
+ * Для final-классов (ExponentialGenerator, DeterministicGenerator,
+ * ErlangGenerator, UniformGenerator, FIFOStrategy) вызовы в цикле
+ * разрешаются на этапе компиляции и встраиваются; с базовыми типами
+ * RandomGenerator и QueueStrategy<int> получается универсальный цикл
+ * с виртуальными вызовами. Simulator выбирает экземпляр по динамическим
+ * типам при конструировании (Simulator::select_kernel()). Множество событий
+ * по умолчанию (бинарная куча) тоже вызывается статически.
+ *
+ * Параметр Profiled добавляет замеры фаз (Profiling::ScopedPhase): при
+ * false замеры - пустые объекты и не порождают кода.
+ */
+
+// ==================== ПРИВЯЗКА ЯДРА ====================
+
+template<typename ArrivalDist, typename ServiceDist, typename Discipline>
+void Simulator::bind_kernel(const char* name) {
+    constexpr bool all_final = std::is_final<ArrivalDist>::value &&
+                               std::is_final<ServiceDist>::value &&
+                               std::is_final<Discipline>::value;
+    if (all_final && dynamic_cast<EventSets::BinaryHeapEventSet<Event>*>(event_queue_.get())) {
+        bind_kernel_with_events<ArrivalDist, ServiceDist, Discipline, EventSets::BinaryHeapEventSet<Event>>(name);
+    } else {
+        bind_kernel_with_events<ArrivalDist, ServiceDist, Discipline, EventSets::EventSet<Event>>(name);
+    }
+}
+
+template<typename ArrivalDist, typename ServiceDist, typename Discipline, typename Events>
+void Simulator::bind_kernel_with_events(const char* name) {
+    static_assert(std::is_base_of<RandomGenerator, ArrivalDist>::value &&
+                  std::is_base_of<RandomGenerator, ServiceDist>::value,
+                  "Распределения должны наследовать RandomGenerator");
+    static_assert(std::is_base_of<QueueDisciplines::QueueStrategy<int>, Discipline>::value,
+                  "Дисциплина должна наследовать QueueStrategy<int>");
+    
+    kernel_.start = &Simulator::start_events<ArrivalDist, Events>;
+    kernel_.advance = &Simulator::advance_events<ArrivalDist, ServiceDist, Discipline, Events, false>;
+    kernel_.advance_profiled =
+        &Simulator::advance_events<ArrivalDist, ServiceDist, Discipline, Events, Profiling::ENABLED>;
+    kernel_.name = name;
+    kernel_.specialized = std::is_final<ArrivalDist>::value &&
+                          std::is_final<ServiceDist>::value &&
+                          std::is_final<Discipline>::value;
+}
+
+// ==================== ГЛАВНЫЙ ЦИКЛ МОДЕЛИРОВАНИЯ ====================
+
+template<typename ArrivalDist, typename Events>
+void Simulator::start_events() {
+    initialize();
+    started_ = true;
+    
+    // Планируем первое прибытие
+    schedule_next_arrival<ArrivalDist, Events, false>();
+}
+
+// Единый цикл событий: продолжает моделирование с текущего состояния до
+// условия остановки. run(), run_until_jobs() и run_until() вызывают его
+// сразу после start(), resume() и run_until_precision() - с места остановки.
+template<typename ArrivalDist, typename ServiceDist, typename Discipline, typename Events, bool Profiled>
+void Simulator::advance_events(const StopCondition& stop) {
+    using Probe = Profiling::ScopedPhase<Profiled>;
+    Events& events = static_cast<Events&>(*event_queue_);
+    const bool check_predicate = static_cast<bool>(stop.predicate);
+    if constexpr (Profiled) profile_->begin(active_jobs_.allocations());
+    
+    long long iteration_count = 0;
+    const long long MAX_ITERATIONS = 100000000;
+    bool interrupted = false;
+    
+    // Главный цикл событий: обрабатываются события с временем не позже горизонта
+    while (!events.empty() && events.top().time <= stop.time_limit &&
+           jobs_completed_ < stop.jobs_limit) {
+        // Точки телеметрии до ближайшего события: состояние с прошлого события
+        if (telemetry_ && events.top().time > telemetry_->next_time() &&
+            sample_telemetry(events.top().time, false)) {
+            interrupted = true;
+            break;
+        }
+        
+        iteration_count++;
+        
+        if (iteration_count > MAX_ITERATIONS) {
+            std::cout << "Прервано: достигнуто максимальное количество итераций\n";
+            interrupted = true;
+            break;
+        }
+        
+        uint64_t event_start = 0;
+        if constexpr (Profiled) event_start = Profiling::ticks();
+        
+        // Извлекаем ближайшее событие
+        Event next_event;
+        {
+            Probe probe(profile_.get(), Profiling::EVENT_SET);
+            next_event = events.pop();
+        }
+        events_processed_++;
+        
+        // Обновляем время
+        current_time_ = next_event.time;
+        
+        // Обновляем статистику занятости
+        {
+            Probe probe(profile_.get(), Profiling::STATISTICS);
+            update_busy_statistics();
+        }
+        
+        // Обрабатываем событие
+        switch (next_event.type) {
+            case Event::ARRIVAL:
+                process_arrival<ArrivalDist, ServiceDist, Discipline, Events, Profiled>();
+                break;
+            case Event::DEPARTURE:
+                process_departure<Discipline, Events, Profiled>(next_event.job_handle, next_event.core_id);
+                break;
+        }
+        if constexpr (Profiled) profile_->add_event(next_event.type, Profiling::ticks() - event_start);
+        
+        if (check_predicate && stop.predicate(*this)) {
+            interrupted = true;
+            break;
+        }
+    }
+    
+    // При остановке по времени модельное время доводится до горизонта:
+    // занятость учитывается на всём [0, T]
+    if (!interrupted && jobs_completed_ < stop.jobs_limit && std::isfinite(stop.time_limit)) {
+        current_time_ = std::max(current_time_, stop.time_limit);
+    }
+    
+    // Финальный сбор статистики
+    update_busy_statistics();
+    if (telemetry_ && !interrupted) sample_telemetry(current_time_, true);
+    if constexpr (Profiled) profile_->end(active_jobs_.allocations());
+}
+
+// ==================== ОБРАБОТКА СОБЫТИЙ ====================
+
+template<typename ArrivalDist, typename ServiceDist, typename Discipline, typename Events, bool Profiled>
+void Simulator::process_arrival() {
+    using Probe = Profiling::ScopedPhase<Profiled>;
+    ServiceDist& service = static_cast<ServiceDist&>(*service_generator_);
+    Discipline& discipline = static_cast<Discipline&>(*queue_strategy_);
+    
+    total_arrivals_++;
+    
+    // Генерируем время обслуживания
+    double service_time;
+    {
+        Probe probe(profile_.get(), Profiling::RNG);
+        service_time = service_variates_.next(service);
+    }
+    service_work_ += service_time;
+    
+    // Создаем задание
+    bool empty = active_jobs_.size() == 0;
+    int handle = add_job(service_time);
+    Job& new_job = active_jobs_[handle];
+    
+    // Захватываем свободное ядро по правилу выбора
+    bool lost = false;
+    int free_core = cores_.acquire(new_job.id, current_time_, current_time_ + service_time);
+    
+    if (free_core != -1) {
+        // Начинаем обслуживание немедленно
+        new_job.start_time = current_time_;
+        schedule_departure<Events, Profiled>(handle, free_core, service_time);
+    } else {
+        Probe probe(profile_.get(), Profiling::QUEUE);
+        
+        // Все ядра заняты - проверяем буфер
+        if (buffer_full<Discipline>()) {
+            // Буфер полон - теряем задание
+            jobs_lost_++;
+            lost = true;
+            active_jobs_.release(handle);
+        } else {
+            // Помещаем в очередь дескриптор: запись остаётся в таблице заданий
+            discipline.push(handle);
+            if constexpr (Profiled) profile_->observe_queue(discipline.size());
+        }
+    }
+    if (intervals_) intervals_->add_arrival(current_time_, lost);
+    if (sensitivity_) sensitivity_->on_arrival(handle, current_time_, service_time, empty, lost);
+    
+    // Планируем следующее прибытие
+    schedule_next_arrival<ArrivalDist, Events, Profiled>();
+}
+
+template<typename Discipline, typename Events, bool Profiled>
+void Simulator::process_departure(int job_handle, int core_id) {
+    using Probe = Profiling::ScopedPhase<Profiled>;
+    Discipline& discipline = static_cast<Discipline&>(*queue_strategy_);
+    
+    // Находим задание
+    if (!active_jobs_.contains(job_handle)) {
+        std::cerr << "Ошибка: задание с дескриптором " << job_handle << " не найдено\n";
+        return;
+    }
+    
+    Job& job = active_jobs_[job_handle];
+    job.finish_time = current_time_;
+    
+    // Записываем статистику
+    {
+        Probe probe(profile_.get(), Profiling::STATISTICS);
+        record_wait_time(job.wait_time());
+        record_system_time(job.system_time());
+        if (intervals_) intervals_->add_departure(job.arrival_time, job.wait_time(), job.system_time());
+        if (sensitivity_) sensitivity_->on_departure(job_handle, job.wait_time(), job.system_time());
+    }
+    
+    // Увеличиваем счетчик обработанных заданий
+    jobs_completed_++;
+    
+    // Удаляем задание
+    active_jobs_.release(job_handle);
+    
+    // Проверяем очередь: ядро переходит к следующему заданию без освобождения
+    int next_handle = -1;
+    {
+        Probe probe(profile_.get(), Profiling::QUEUE);
+        if (!discipline.empty()) next_handle = discipline.pop();
+    }
+    if (next_handle != -1) {
+        // Начинаем обслуживание следующего задания
+        if (active_jobs_.contains(next_handle)) {
+            Job& job_to_start = active_jobs_[next_handle];
+            job_to_start.start_time = current_time_;
+            
+            double service_time = job_to_start.service_time;
+            cores_.reassign(core_id, job_to_start.id, current_time_ + service_time);
+            if (sensitivity_) sensitivity_->on_start(next_handle);
+            schedule_departure<Events, Profiled>(next_handle, core_id, service_time);
+            return;
+        }
+    }
+    
+    // Освобождаем ядро
+    cores_.release(core_id, current_time_);
+}
+
+// ==================== ПЛАНИРОВАНИЕ И БУФЕР ====================
+
+template<typename ArrivalDist, typename Events, bool Profiled>
+void Simulator::schedule_next_arrival() {
+    ArrivalDist& arrivals = static_cast<ArrivalDist&>(*arrival_generator_);
+    double interval;
+    {
+        Profiling::ScopedPhase<Profiled> probe(profile_.get(), Profiling::RNG);
+        interval = arrival_variates_.next(arrivals);
+    }
+    if (sensitivity_) sensitivity_->on_interarrival(interval);
+    double arrival_time = current_time_ + interval;
+    
+    push_event<Events, Profiled>(Event(arrival_time, Event::ARRIVAL));
+}
+
+template<typename Events, bool Profiled>
+void Simulator::push_event(Event event) {
+    Profiling::ScopedPhase<Profiled> probe(profile_.get(), Profiling::EVENT_SET);
+    event.seq = next_event_seq_++;
+    Events& events = static_cast<Events&>(*event_queue_);
+    events.push(event);
+    if constexpr (Profiled) profile_->observe_event_set(events.size());
+}
+
+template<typename Events, bool Profiled>
+void Simulator::schedule_departure(int job_handle, int core_id, double service_time) {
+    double departure_time = current_time_ + service_time;
+    push_event<Events, Profiled>(Event(departure_time, job_handle, core_id));
+}
+
+template<typename Discipline>
+bool Simulator::buffer_full() const {
+    if (buffer_capacity_ == -1) return false;
+    const Discipline& discipline = static_cast<const Discipline&>(*queue_strategy_);
+    return static_cast<int>(discipline.size()) >= buffer_capacity_;
+}
+
+// ==================== СТАТИЧЕСКИ ТИПИЗИРОВАННЫЙ СИМУЛЯТОР ====================
+
+/**
+ * Симулятор с типами распределений и дисциплины, заданными на этапе компиляции
+ *
+ * Пример: BasicSimulator<ExponentialGenerator, ErlangGenerator,
+ *                        QueueDisciplines::FIFOStrategy<int>>
+ * Цикл событий связывается с этими типами без проверок во время выполнения;
+ * в остальном это обычный Simulator.
+ */
+template<typename ArrivalDist, typename ServiceDist, typename Discipline>
+class BasicSimulator : public Simulator {
+public:
+    BasicSimulator(std::unique_ptr<ArrivalDist> arrival_gen,
+                   std::unique_ptr<ServiceDist> service_gen,
+                   std::unique_ptr<Discipline> discipline,
+                   int num_cores = 1,
+                   int buffer_cap = -1,
+                   EventSetType event_set_type = EventSetType::BINARY_HEAP)
+        : Simulator(std::move(arrival_gen), std::move(service_gen), std::move(discipline),
+                    num_cores, buffer_cap, event_set_type) {
+        bind_kernel<ArrivalDist, ServiceDist, Discipline>("BasicSimulator");
+    }
+    
+    ArrivalDist& arrival_distribution() { return static_cast<ArrivalDist&>(arrival_generator()); }
+    ServiceDist& service_distribution() { return static_cast<ServiceDist&>(service_generator()); }
+    Discipline& discipline() { return static_cast<Discipline&>(queue_strategy()); }
+};
+
+// Универсальный вариант - все вызовы виртуальные (эталон для сравнения)
+using GenericSimulator = BasicSimulator<RandomGenerator, RandomGenerator, QueueDisciplines::QueueStrategy<int>>;
+
+#endif // BASIC_SIMULATOR_H
@@ -0,0 +1,53 @@
+// Сравнение реализаций множества событий на полном цикле моделирования M/M/c.
+// Для каждой реализации измеряется пропускная способность (событий/с)
+// в зависимости от числа ядер c и загрузки ρ.
+
+#include "simulator.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int jobs = (argc > 1) ? atoi(argv[1]) : 200000;
+
+    vector<int> core_counts = {1, 4, 16, 64, 256};
+    vector<double> loads = {0.5, 0.8, 0.95};
+    double mu = 1.0;
+
+    cout << "ПРОПУСКНАЯ СПОСОБНОСТЬ МНОЖЕСТВ СОБЫТИЙ (M/M/c, FIFO, " << jobs << " заданий)\n";
+    cout << "--------------------------------------------------------------------\n";
+    cout << "Реализация      Ядра  ρ     События     Время(мс) Событий/с\n";
+    cout << "--------------------------------------------------------------------\n";
+
+    for (auto type : EventSets::EventSetFactory<Event>::get_all_types()) {
+        string set_name = EventSets::EventSetFactory<Event>::type_to_string(type);
+
+        for (int cores : core_counts) {
+            for (double rho : loads) {
+                double lambda = rho * mu * cores;
+                Simulator sim(GeneratorFactory::create_exponential(lambda),
+                              GeneratorFactory::create_exponential(mu),
+                              cores, -1,
+                              QueueDisciplines::QueueStrategyFactory<Job>::Type::FIFO,
+                              type);
+
+                auto start = chrono::steady_clock::now();
+                sim.run_until_jobs(jobs);
+                auto end = chrono::steady_clock::now();
+
+                double ms = chrono::duration<double, milli>(end - start).count();
+                double rate = (ms > 0) ? sim.events_processed() / (ms / 1000.0) : 0.0;
+
+                cout << fixed << setprecision(2);
+                cout << left << setw(16) << set_name << setw(6) << cores << setw(6) << rho
+                     << setw(12) << sim.events_processed() << setw(10) << ms
+                     << setprecision(0) << rate << "\n";
+            }
+        }
+    }
+
+    return 0;
+}
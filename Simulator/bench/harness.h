@@ -0,0 +1,195 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+// Минимальный каркас микробенчмарков в духе Google Benchmark.
+//
+// Бенчмарк - фабрика замера: make() выполняет подготовку (не измеряется) и
+// возвращает тело, которое обрабатывает не меньше n элементов и возвращает
+// их фактическое число. Число элементов подбирается удвоением, пока замер не
+// займёт min_time; затем выполняется repetitions повторов с этим числом, у
+// каждого своя свежая подготовка. Все зёрна фиксированы, поэтому повторы и
+// прогоны на разных коммитах выполняют одну и ту же работу.
+//
+// Результаты пишутся в JSON по строке на бенчмарк; compare() читает такой
+// файл как базовый и находит регрессии по медиане нс на элемент.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+// Не даёт компилятору выбросить вычисление значения
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+using Body = std::function<uint64_t(uint64_t n)>;
+
+struct Benchmark {
+    std::string name;       // группа/вариант, например "event_set/BINARY_HEAP/1024"
+    std::string unit;       // что считается элементом: op, value, event
+    std::function<Body()> make;
+};
+
+struct Result {
+    std::string name;
+    std::string unit;
+    uint64_t items;                 // элементов в одном повторе
+    size_t repetitions;
+    double ns_median;               // нс на элемент
+    double ns_min;
+    double ns_stddev;
+
+    double items_per_second() const { return ns_median > 0.0 ? 1e9 / ns_median : 0.0; }
+};
+
+struct Options {
+    std::string filter;             // подстрока имени (пустая - все)
+    double min_time = 0.1;          // с на повтор
+    size_t repetitions = 5;
+};
+
+class Registry {
+private:
+    std::vector<Benchmark> benchmarks_;
+
+    static double time_ns(const Body& body, uint64_t n, uint64_t& items) {
+        auto start = std::chrono::steady_clock::now();
+        items = body(n);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+public:
+    void add(std::string name, std::string unit, std::function<Body()> make) {
+        benchmarks_.push_back(Benchmark{std::move(name), std::move(unit), std::move(make)});
+    }
+
+    Result run(const Benchmark& benchmark, const Options& options) const {
+        // Калибровка числа элементов
+        uint64_t n = 1;
+        uint64_t items = 0;
+        while (true) {
+            double ns = time_ns(benchmark.make(), n, items);
+            if (ns >= options.min_time * 1e9 || n >= (uint64_t(1) << 40)) break;
+            double scale = ns > 0.0 ? options.min_time * 1e9 / ns : 10.0;
+            n = std::max(n * 2, static_cast<uint64_t>(n * std::min(scale * 1.2, 10.0)));
+        }
+
+        std::vector<double> samples;
+        for (size_t r = 0; r < options.repetitions; ++r) {
+            double ns = time_ns(benchmark.make(), n, items);
+            samples.push_back(ns / std::max<uint64_t>(items, 1));
+        }
+        std::sort(samples.begin(), samples.end());
+        double mean = 0.0;
+        for (double s : samples) mean += s;
+        mean /= samples.size();
+        double var = 0.0;
+        for (double s : samples) var += (s - mean) * (s - mean);
+        size_t m = samples.size();
+        double median = m % 2 ? samples[m / 2] : 0.5 * (samples[m / 2 - 1] + samples[m / 2]);
+        return Result{benchmark.name, benchmark.unit, items, m, median, samples.front(),
+                      m > 1 ? std::sqrt(var / (m - 1)) : 0.0};
+    }
+
+    std::vector<Result> run_all(const Options& options, std::ostream& log) const {
+        std::vector<Result> results;
+        // Кириллица - по два байта на букву, поэтому заголовок выровнен вручную
+        log << "Бенчмарк                                     нс/элем       мин         σ          элем/с  ед.\n";
+        log << std::string(94, '-') << "\n";
+        for (const auto& benchmark : benchmarks_) {
+            if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+            Result r = run(benchmark, options);
+            log << std::fixed << std::setprecision(2);
+            log << std::left << std::setw(40) << r.name << std::right
+                << std::setw(12) << r.ns_median << std::setw(10) << r.ns_min << std::setw(10) << r.ns_stddev
+                << std::setprecision(0) << std::setw(16) << r.items_per_second() << "  " << r.unit << "\n";
+            results.push_back(r);
+        }
+        return results;
+    }
+};
+
+inline void write_json(const std::string& path, const std::vector<Result>& results, const Options& options) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Не удалось создать " + path);
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n";
+    out << "  \"context\": {\"compiler\": \"" << __VERSION__ << "\", \"min_time\": " << options.min_time
+        << ", \"repetitions\": " << options.repetitions << "},\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"unit\": \"" << r.unit << "\", \"items\": " << r.items
+            << ", \"repetitions\": " << r.repetitions << ", \"ns_median\": " << r.ns_median
+            << ", \"ns_min\": " << r.ns_min << ", \"ns_stddev\": " << r.ns_stddev
+            << ", \"items_per_second\": " << r.items_per_second() << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Медианы нс на элемент из файла write_json() (по строке на бенчмарк)
+inline std::map<std::string, double> read_medians(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Не удалось открыть " + path);
+    std::map<std::string, double> medians;
+    std::string line;
+    const std::string name_key = "\"name\": \"";
+    const std::string median_key = "\"ns_median\": ";
+    while (std::getline(in, line)) {
+        size_t name = line.find(name_key);
+        size_t median = line.find(median_key);
+        if (name == std::string::npos || median == std::string::npos) continue;
+        name += name_key.size();
+        size_t name_end = line.find('"', name);
+        medians[line.substr(name, name_end - name)] = std::stod(line.substr(median + median_key.size()));
+    }
+    return medians;
+}
+
+/**
+ * Сравнение с базовым прогоном: регрессия - медиана выросла больше чем в
+ * (1 + tolerance) раз. Возвращает число регрессий; бенчмарки, которых нет в
+ * базовом файле, только перечисляются.
+ */
+inline int compare(const std::vector<Result>& results, const std::string& baseline_path,
+                   double tolerance, std::ostream& log) {
+    std::map<std::string, double> baseline = read_medians(baseline_path);
+    int regressions = 0;
+    log << "\nСРАВНЕНИЕ С " << baseline_path << " (допуск " << std::fixed << std::setprecision(0)
+        << tolerance * 100 << "%)\n";
+    log << "Бенчмарк                                    база(нс)  сейчас(нс)     изм.\n";
+    log << std::string(76, '-') << "\n";
+    for (const Result& r : results) {
+        auto it = baseline.find(r.name);
+        log << std::left << std::setw(40) << r.name << std::right << std::setprecision(2);
+        if (it == baseline.end()) {
+            log << std::setw(12) << "-" << std::setw(12) << r.ns_median << "  новый\n";
+            continue;
+        }
+        double change = it->second > 0.0 ? r.ns_median / it->second - 1.0 : 0.0;
+        bool regressed = change > tolerance;
+        regressions += regressed;
+        log << std::setw(12) << it->second << std::setw(12) << r.ns_median
+            << std::showpos << std::setw(9) << change * 100 << "%" << std::noshowpos
+            << (regressed ? "  РЕГРЕССИЯ" : "") << "\n";
+    }
+    return regressions;
+}
+
+} // namespace Bench
+
+#endif // BENCH_HARNESS_H
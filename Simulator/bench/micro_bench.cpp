@@ -0,0 +1,411 @@
+// Набор воспроизводимых микробенчмарков по компонентам: множества событий,
+// дисциплины очереди, генераторы случайных величин, цикл событий целиком,
+// многоклассовые дисциплины с вытеснением, пакетная рекурсия Линдли и
+// процессы на сопрограммах против обработчиков событий.
+//
+//   micro_bench [--filter подстрока] [--min-time с] [--repetitions n]
+//               [--out результат.json] [--compare база.json] [--tolerance доля]
+//
+// Зёрна фиксированы; результаты пишутся в JSON, --compare завершается с
+// кодом 1 при регрессии медианы больше допуска (по умолчанию 10%).
+
+#include "harness.h"
+#include "simulator.h"
+#include "multiclass_simulator.h"
+#include "lindley.h"
+#include "process/station.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+constexpr uint64_t SEED = 42;
+using QueueFactory = QueueDisciplines::QueueStrategyFactory<int>;
+using EventSetFactory = EventSets::EventSetFactory<Event>;
+
+// Модель hold: множество из size событий, операция - извлечь минимум и
+// вставить его же с экспоненциальным приращением времени
+void register_event_sets(Bench::Registry& registry) {
+    for (auto type : EventSetFactory::get_all_types()) {
+        for (size_t size : {16, 1024, 65536}) {
+            registry.add("event_set/" + EventSetFactory::type_to_string(type) + "/" + to_string(size), "op",
+                         [type, size]() -> Bench::Body {
+                shared_ptr<EventSets::EventSet<Event>> events = EventSetFactory::create(type);
+                auto increments = make_shared<vector<double>>(4096);
+                mt19937_64 rng(SEED);
+                exponential_distribution<double> exp(1.0);
+                for (double& inc : *increments) inc = exp(rng) * size;
+                unsigned long long seq = 0;
+                for (size_t i = 0; i < size; ++i) {
+                    Event e(exp(rng) * size, Event::ARRIVAL);
+                    e.seq = seq++;
+                    events->push(e);
+                }
+                return [events, increments, seq](uint64_t n) mutable {
+                    const vector<double>& inc = *increments;
+                    for (uint64_t i = 0; i < n; ++i) {
+                        Event e = events->pop();
+                        e.time += inc[i & 4095];
+                        e.seq = seq++;
+                        events->push(e);
+                    }
+                    Bench::do_not_optimize(events->top().time);
+                    return n;
+                };
+            });
+        }
+    }
+}
+
+// Отмена в индексированной куче: снимается одно из size запланированных событий
+// и планируется замена (так вытеснение переносит завершение обслуживания)
+void register_event_cancel(Bench::Registry& registry) {
+    for (size_t size : {16, 1024, 65536}) {
+        registry.add("event_set/INDEXED_HEAP/cancel/" + to_string(size), "op", [size]() -> Bench::Body {
+            auto events = make_shared<EventSets::IndexedHeapEventSet<Event>>();
+            auto ids = make_shared<vector<int>>(size);
+            auto times = make_shared<vector<double>>(4096);
+            mt19937_64 rng(SEED);
+            exponential_distribution<double> exp(1.0);
+            for (double& t : *times) t = exp(rng) * size;
+            unsigned long long seq = 0;
+            for (size_t i = 0; i < size; ++i) {
+                Event e(exp(rng) * size, Event::ARRIVAL);
+                e.seq = seq++;
+                (*ids)[i] = events->schedule(e);
+            }
+            return [events, ids, times, seq, size](uint64_t n) mutable {
+                vector<int>& pending = *ids;
+                const vector<double>& t = *times;
+                for (uint64_t i = 0; i < n; ++i) {
+                    size_t slot = (i * 2654435761u) % size;
+                    events->cancel(pending[slot]);
+                    Event e(t[i & 4095], Event::ARRIVAL);
+                    e.seq = seq++;
+                    pending[slot] = events->schedule(e);
+                }
+                Bench::do_not_optimize(events->top().time);
+                return n;
+            };
+        });
+    }
+}
+
+// Очередь из 64 дескрипторов заданий (так её использует симулятор),
+// операция - вставка и извлечение одного дескриптора
+void register_disciplines(Bench::Registry& registry) {
+    for (auto type : QueueFactory::get_all_types()) {
+        registry.add("queue/" + QueueFactory::type_to_string(type), "op", [type]() -> Bench::Body {
+            shared_ptr<QueueDisciplines::QueueStrategy<int>> queue = QueueFactory::create(type);
+            queue->seed(SEED);
+            for (int i = 0; i < 64; ++i) queue->push(i);
+            return [queue](uint64_t n) {
+                int checksum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    queue->push(static_cast<int>(i & 4095));
+                    checksum += queue->pop();
+                }
+                Bench::do_not_optimize(checksum);
+                return n;
+            };
+        });
+    }
+}
+
+// Суточная таблица интенсивности по часам со средним 1 (нестационарный поток)
+RateTable daily_rates(RateTable::Shape shape) {
+    vector<double> hours, rates;
+    for (int h = 0; h <= 24; ++h) {
+        hours.push_back(h);
+        rates.push_back(1.0 + 0.8 * sin(2.0 * M_PI * h / 24.0));
+    }
+    if (shape == RateTable::Shape::PIECEWISE_LINEAR) return RateTable::piecewise_linear(hours, rates);
+    rates.pop_back();
+    return RateTable::piecewise_constant(hours, rates);
+}
+
+// Поштучный виртуальный generate() и пакетный generate_batch()
+void register_generators(Bench::Registry& registry) {
+    struct Case {
+        string name;
+        function<unique_ptr<RandomGenerator>()> make;
+    };
+    vector<Case> cases = {
+        {"exponential", [] { return GeneratorFactory::create_exponential(1.0, SEED); }},
+        {"uniform", [] { return GeneratorFactory::create_uniform(0.5, 1.5, SEED); }},
+        {"deterministic", [] { return GeneratorFactory::create_deterministic(1.0); }},
+        {"erlang3", [] { return GeneratorFactory::create_erlang(3, 3.0, SEED); }},
+        {"nhpp-const24", [] { return GeneratorFactory::create_nhpp(daily_rates(RateTable::Shape::PIECEWISE_CONSTANT), SEED); }},
+        {"nhpp-linear24", [] { return GeneratorFactory::create_nhpp(daily_rates(RateTable::Shape::PIECEWISE_LINEAR), SEED); }},
+    };
+    for (const auto& c : cases) {
+        auto make = c.make;
+        registry.add("rng/" + c.name + "/generate", "value", [make]() -> Bench::Body {
+            shared_ptr<RandomGenerator> gen = make();
+            return [gen](uint64_t n) {
+                double sum = 0.0;
+                for (uint64_t i = 0; i < n; ++i) sum += gen->generate();
+                Bench::do_not_optimize(sum);
+                return n;
+            };
+        });
+        registry.add("rng/" + c.name + "/batch", "value", [make]() -> Bench::Body {
+            shared_ptr<RandomGenerator> gen = make();
+            auto buffer = make_shared<vector<double>>(VariateBuffer::CAPACITY);
+            return [gen, buffer](uint64_t n) {
+                double sum = 0.0;
+                const size_t batch = buffer->size();
+                uint64_t done = 0;
+                for (; done < n; done += batch) {
+                    gen->generate_batch(buffer->data(), batch);
+                    sum += (*buffer)[batch - 1];
+                }
+                Bench::do_not_optimize(sum);
+                return done;
+            };
+        });
+    }
+}
+
+// Полный цикл событий; элемент - обработанное событие
+void register_systems(Bench::Registry& registry) {
+    struct Case {
+        string name;
+        double lambda;
+        int cores;
+        int buffer;
+        bool deterministic;
+    };
+    vector<Case> cases = {
+        {"M/M/1", 0.8, 1, -1, false},
+        {"M/M/16", 12.8, 16, -1, false},
+        {"M/D/1", 0.8, 1, -1, true},
+        {"M/M/1/10", 0.95, 1, 10, false},
+        {"M/M/4/8", 4.8, 4, 8, false},     // перегрузка ρ = 1.2, заметные потери
+    };
+    for (const auto& c : cases) {
+        registry.add("system/" + c.name, "event", [c]() -> Bench::Body {
+            auto service = c.deterministic ? GeneratorFactory::create_deterministic(1.0)
+                                           : GeneratorFactory::create_exponential(1.0);
+            shared_ptr<Simulator> sim = make_shared<Simulator>(GeneratorFactory::create_exponential(c.lambda),
+                                                               std::move(service), c.cores, c.buffer);
+            return [sim](uint64_t n) {
+                sim->seed(SEED);
+                sim->run_until_jobs(static_cast<int>(max<uint64_t>(1, n / 2)));
+                Bench::do_not_optimize(sim->avg_wait_time());
+                return static_cast<uint64_t>(sim->events_processed());
+            };
+        });
+    }
+}
+
+// Два класса M/M/1 с общей нагрузкой ρ = 0.8: цена приоритетов и вытеснения
+// относительно FIFO той же системы; элемент - обработанное событие
+void register_multiclass(Bench::Registry& registry) {
+    for (auto scheduling : MultiClassSimulator::all_schedulings()) {
+        registry.add("multiclass/" + MultiClassSimulator::scheduling_name(scheduling), "event",
+                     [scheduling]() -> Bench::Body {
+            auto sim = make_shared<MultiClassSimulator>(1, -1, scheduling);
+            sim->add_class(GeneratorFactory::create_exponential(0.4), GeneratorFactory::create_exponential(2.0), 0);
+            sim->add_class(GeneratorFactory::create_exponential(0.6), GeneratorFactory::create_exponential(1.0), 1);
+            return [sim](uint64_t n) {
+                sim->seed(SEED);
+                sim->run_until_jobs(static_cast<long long>(max<uint64_t>(1, n / 2)));
+                Bench::do_not_optimize(sim->avg_wait_time());
+                return static_cast<uint64_t>(sim->events_processed());
+            };
+        });
+    }
+}
+
+// Рекурсия Линдли для M/M/1 и M/D/1 с ρ = 0.8: одна репликация и пакет из
+// 64 репликаций в ногу; элемент - задание (в цикле событий - два события)
+void register_lindley(Bench::Registry& registry) {
+    for (bool deterministic : {false, true}) {
+        for (size_t lanes : {1, 64}) {
+            string name = string(deterministic ? "M/D/1" : "M/M/1") + "/" + to_string(lanes);
+            registry.add("lindley/" + name, "job", [deterministic, lanes]() -> Bench::Body {
+                auto service = deterministic ? GeneratorFactory::create_deterministic(1.0)
+                                             : GeneratorFactory::create_exponential(1.0);
+                auto engine = make_shared<Lindley::BatchEngine>(*GeneratorFactory::create_exponential(0.8),
+                                                                *service);
+                vector<uint64_t> seeds(lanes);
+                for (size_t i = 0; i < lanes; ++i) seeds[i] = GeneratorFactory::derive_seed(SEED, i);
+                return [engine, seeds](uint64_t n) {
+                    long long jobs = static_cast<long long>(max<uint64_t>(1, n / seeds.size()));
+                    auto results = engine->run_until_jobs(seeds, jobs);
+                    Bench::do_not_optimize(results[0].wait_sum);
+                    return static_cast<uint64_t>(jobs * seeds.size());
+                };
+            });
+        }
+    }
+}
+
+// Одна станция двумя способами: обработчики событий Simulator и процессы на
+// сопрограммах (с пулом кадров и без); элемент - ушедшее задание
+void register_process(Bench::Registry& registry) {
+    struct Case {
+        string name;
+        double lambda;
+        int cores;
+        int buffer;
+    };
+    vector<Case> cases = {
+        {"M/M/1", 0.8, 1, -1},
+        {"M/M/4/8", 3.6, 4, 8},
+    };
+    for (const auto& c : cases) {
+        registry.add("process/routines/" + c.name, "job", [c]() -> Bench::Body {
+            shared_ptr<Simulator> sim = make_shared<Simulator>(GeneratorFactory::create_exponential(c.lambda),
+                                                               GeneratorFactory::create_exponential(1.0),
+                                                               c.cores, c.buffer);
+            return [sim, c](uint64_t n) {
+                sim->seed(SEED);
+                sim->run(static_cast<double>(max<uint64_t>(1, n)) / c.lambda);
+                Bench::do_not_optimize(sim->avg_wait_time());
+                return static_cast<uint64_t>(sim->jobs_completed());
+            };
+        });
+        for (bool pooled : {true, false}) {
+            string style = pooled ? "coroutines/" : "coroutines-heap/";
+            registry.add("process/" + style + c.name, "job", [c, pooled]() -> Bench::Body {
+                auto model = make_shared<Processes::StationModel>(*GeneratorFactory::create_exponential(c.lambda),
+                                                                  *GeneratorFactory::create_exponential(1.0),
+                                                                  c.cores, c.buffer);
+                return [model, c, pooled](uint64_t n) {
+                    Processes::FramePool& pool = Processes::FramePool::local();
+                    pool.set_enabled(pooled);
+                    model->seed(SEED);
+                    model->run(static_cast<double>(max<uint64_t>(1, n)) / c.lambda);
+                    pool.set_enabled(true);
+                    Bench::do_not_optimize(model->avg_wait_time());
+                    return static_cast<uint64_t>(model->jobs_completed());
+                };
+            });
+        }
+    }
+}
+
+// Цена оценки производных в цикле событий: тот же прогон без неё и с ней
+// (M/M/1 - IPA и LR, M/M/4/8 - только LR); элемент - обработанное событие
+void register_sensitivity(Bench::Registry& registry) {
+    struct Case {
+        string name;
+        double lambda;
+        int cores;
+        int buffer;
+    };
+    vector<Case> cases = {
+        {"M/M/1", 0.8, 1, -1},
+        {"M/M/4/8", 3.6, 4, 8},
+    };
+    for (const auto& c : cases) {
+        for (bool enabled : {false, true}) {
+            string mode = enabled ? "on/" : "off/";
+            registry.add("sensitivity/" + mode + c.name, "event", [c, enabled]() -> Bench::Body {
+                shared_ptr<Simulator> sim = make_shared<Simulator>(GeneratorFactory::create_exponential(c.lambda),
+                                                                   GeneratorFactory::create_exponential(1.0),
+                                                                   c.cores, c.buffer);
+                sim->enable_sensitivity(enabled);
+                return [sim](uint64_t n) {
+                    sim->seed(SEED);
+                    sim->run_until_jobs(static_cast<int>(max<uint64_t>(1, n / 2)));
+                    Bench::do_not_optimize(sim->avg_wait_time());
+                    return static_cast<uint64_t>(sim->events_processed());
+                };
+            });
+        }
+    }
+}
+
+// Цена телеметрии в цикле событий M/M/1: без неё, с шагом 10 и с шагом 0.1
+// (точка почти на каждое событие); элемент - обработанное событие
+void register_telemetry(Bench::Registry& registry) {
+    const pair<const char*, double> cases[] = {{"off", 0.0}, {"step10", 10.0}, {"step0.1", 0.1}};
+    for (const auto& [name, interval] : cases) {
+        registry.add(string("telemetry/") + name + "/M/M/1", "event", [interval = interval]() -> Bench::Body {
+            shared_ptr<Simulator> sim = make_shared<Simulator>(GeneratorFactory::create_exponential(0.8),
+                                                               GeneratorFactory::create_exponential(1.0), 1);
+            sim->enable_telemetry(interval);
+            return [sim](uint64_t n) {
+                sim->seed(SEED);
+                sim->run_until_jobs(static_cast<int>(max<uint64_t>(1, n / 2)));
+                Bench::do_not_optimize(sim->avg_wait_time());
+                return static_cast<uint64_t>(sim->events_processed());
+            };
+        });
+    }
+}
+
+void usage() {
+    cerr << "Использование: micro_bench [--filter подстрока] [--min-time с] [--repetitions n] "
+            "[--out файл.json] [--compare база.json] [--tolerance доля]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Bench::Options options;
+    string out_path;
+    string baseline_path;
+    double tolerance = 0.10;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        string value = argv[++i];
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--min-time") {
+            options.min_time = stod(value);
+        } else if (arg == "--repetitions") {
+            options.repetitions = static_cast<size_t>(max(1, stoi(value)));
+        } else if (arg == "--out") {
+            out_path = value;
+        } else if (arg == "--compare") {
+            baseline_path = value;
+        } else if (arg == "--tolerance") {
+            tolerance = stod(value);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    Bench::Registry registry;
+    register_event_sets(registry);
+    register_event_cancel(registry);
+    register_disciplines(registry);
+    register_generators(registry);
+    register_systems(registry);
+    register_multiclass(registry);
+    register_lindley(registry);
+    register_process(registry);
+    register_sensitivity(registry);
+    register_telemetry(registry);
+
+    try {
+        vector<Bench::Result> results = registry.run_all(options, cout);
+        if (!out_path.empty()) {
+            Bench::write_json(out_path, results, options);
+            cout << "\nРезультаты записаны в " << out_path << "\n";
+        }
+        if (!baseline_path.empty()) {
+            int regressions = Bench::compare(results, baseline_path, tolerance, cout);
+            cout << "Регрессий: " << regressions << "\n";
+            return regressions > 0 ? 1 : 0;
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Стоимость генерации случайных величин: эталон std::*_distribution на mt19937_64,
+// поштучный виртуальный generate(), пакетный generate_batch() и буфер предвыборки
+// VariateBuffer, которым пользуется горячий цикл Simulator.
+
+#include "common/random_generator.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <string>
+#include <functional>
+
+using namespace std;
+
+// Время на одно значение, нс; checksum не даёт компилятору выбросить цикл
+static double measure(size_t n, double& checksum, const function<void()>& body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    auto end = chrono::steady_clock::now();
+    (void)checksum;
+    return chrono::duration<double, nano>(end - start).count() / n;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 10000000;
+    double checksum = 0.0;
+
+    struct Case {
+        string name;
+        function<unique_ptr<RandomGenerator>()> make;
+        function<double(mt19937_64&)> reference;
+    };
+
+    exponential_distribution<double> exp_dist(1.0);
+    uniform_real_distribution<double> uni_dist(0.5, 1.5);
+    vector<Case> cases = {
+        {"Exponential(1)", [] { return GeneratorFactory::create_exponential(1.0, 42); },
+         [&](mt19937_64& g) { return exp_dist(g); }},
+        {"Uniform[0.5,1.5]", [] { return GeneratorFactory::create_uniform(0.5, 1.5, 42); },
+         [&](mt19937_64& g) { return uni_dist(g); }},
+        {"Erlang(3,3)", [] { return GeneratorFactory::create_erlang(3, 3.0, 42); },
+         [&](mt19937_64& g) { exponential_distribution<double> d(3.0); return d(g) + d(g) + d(g); }},
+    };
+
+    cout << "ГЕНЕРАЦИЯ СЛУЧАЙНЫХ ВЕЛИЧИН (" << n << " значений, нс на значение)\n";
+    cout << "--------------------------------------------------------------------\n";
+    cout << "Распределение     std+mt19937  generate()  batch(4096)  VariateBuffer\n";
+    cout << "--------------------------------------------------------------------\n";
+
+    for (const auto& c : cases) {
+        mt19937_64 engine(42);
+        double t_ref = measure(n, checksum, [&] {
+            double sum = 0.0;
+            for (size_t i = 0; i < n; ++i) sum += c.reference(engine);
+            checksum += sum;
+        });
+
+        auto scalar = c.make();
+        RandomGenerator* gen = scalar.get();
+        double t_scalar = measure(n, checksum, [&] {
+            double sum = 0.0;
+            for (size_t i = 0; i < n; ++i) sum += gen->generate();
+            checksum += sum;
+        });
+
+        auto batched = c.make();
+        vector<double> block(4096);
+        double t_batch = measure(n, checksum, [&] {
+            double sum = 0.0;
+            for (size_t done = 0; done < n; done += block.size()) {
+                batched->generate_batch(block.data(), block.size());
+                for (double v : block) sum += v;
+            }
+            checksum += sum;
+        });
+
+        auto prefetched = c.make();
+        VariateBuffer buffer;
+        double t_buffer = measure(n, checksum, [&] {
+            double sum = 0.0;
+            for (size_t i = 0; i < n; ++i) sum += buffer.next(*prefetched);
+            checksum += sum;
+        });
+
+        cout << fixed << setprecision(2);
+        cout << left << setw(18) << c.name << right
+             << setw(11) << t_ref
+             << setw(12) << t_scalar
+             << setw(13) << t_batch
+             << setw(15) << t_buffer << "\n";
+    }
+
+    cout << "\nКонтрольная сумма: " << checksum << "\n";
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Трассы вместо синтетических распределений: скорость преобразования CSV
+// (отображение в память и from_chars против ifstream/getline/stod) и прогон
+// Simulator по трассе. Трасса записывается из тех же потоков, что дал бы
+// Simulator::seed(), поэтому прогон по ней обязан совпасть с синтетическим.
+
+#include "simulator.h"
+#include "common/trace.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+static const uint64_t SEED = 2024;
+
+// CSV со столбцами timestamp, interarrival, service (M/M/1, ρ=0.8)
+static void write_csv(const string& path, size_t rows) {
+    ExponentialGenerator arrivals(0.8), service(1.0);
+    arrivals.seed(GeneratorFactory::derive_seed(SEED, 0, 0));
+    service.seed(GeneratorFactory::derive_seed(SEED, 0, 1));
+
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) throw runtime_error("Не удалось создать " + path);
+    fprintf(out, "timestamp,interarrival,service\n");
+    vector<double> a(VariateBuffer::CAPACITY), s(VariateBuffer::CAPACITY);
+    double t = 0.0;
+    for (size_t done = 0; done < rows; done += a.size()) {
+        arrivals.generate_batch(a.data(), a.size());
+        service.generate_batch(s.data(), s.size());
+        for (size_t i = 0; i < a.size() && done + i < rows; ++i) {
+            t += a[i];
+            fprintf(out, "%.17g,%.17g,%.17g\n", t, a[i], s[i]);
+        }
+    }
+    fclose(out);
+}
+
+// Эталон: построчный разбор стандартными потоками
+static double naive_parse_ms(const string& path, double& checksum) {
+    auto start = chrono::steady_clock::now();
+    ifstream in(path);
+    string line, field;
+    getline(in, line);
+    checksum = 0.0;
+    while (getline(in, line)) {
+        stringstream row(line);
+        while (getline(row, field, ',')) checksum += stod(field);
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static double run_ms(Simulator& sim, int jobs) {
+    sim.seed(SEED);
+    auto start = chrono::steady_clock::now();
+    sim.run_until_jobs(jobs);
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t rows = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 1000000;
+    string csv = "/tmp/trace_bench.csv";
+    string trc = "/tmp/trace_bench.trc";
+
+    write_csv(csv, rows);
+
+    cout << "ПРЕОБРАЗОВАНИЕ CSV → СТОЛБЦОВАЯ ТРАССА (" << rows << " строк, 3 столбца)\n";
+    cout << "------------------------------------------------------------------\n";
+    double checksum = 0.0;
+    double naive_ms = naive_parse_ms(csv, checksum);
+    Traces::ConvertResult result = Traces::convert_csv(csv, trc);
+    double mb = result.input_bytes / 1e6;
+    cout << fixed << setprecision(1);
+    cout << "ifstream + getline + stod:   " << setw(8) << naive_ms << " мс  "
+         << setw(7) << mb / (naive_ms / 1000.0) << " МБ/с\n";
+    cout << "convert_csv (mmap+from_chars):" << setw(7) << result.seconds * 1000 << " мс  "
+         << setw(7) << result.megabytes_per_second() << " МБ/с  ("
+         << setprecision(2) << naive_ms / (result.seconds * 1000) << "x)\n";
+    cout << "Размер: CSV " << setprecision(1) << mb << " МБ, трасса " << result.output_bytes / 1e6 << " МБ\n";
+
+    auto trace = Traces::TraceFile::open(trc);
+    int jobs = static_cast<int>(rows / 2);
+
+    Simulator synthetic(GeneratorFactory::create_exponential(0.8), GeneratorFactory::create_exponential(1.0));
+    Simulator replay(Traces::create_trace(trace, "interarrival"), Traces::create_trace(trace, "service"));
+    double synthetic_ms = run_ms(synthetic, jobs);
+    double replay_ms = run_ms(replay, jobs);
+
+    cout << "\nПРОГОН M/M/1 (" << jobs << " заданий): СИНТЕТИЧЕСКИЕ ПОТОКИ И ТРАССА\n";
+    cout << "------------------------------------------------------------------\n";
+    cout << "Источник    Время(мс)      Соб/с             W           ρ\n";
+    cout << "------------------------------------------------------------------\n";
+    cout << fixed << setprecision(2) << "синтетика  "
+         << setw(11) << synthetic_ms
+         << setw(11) << setprecision(0) << synthetic.events_processed() / (synthetic_ms / 1000.0)
+         << setw(14) << setprecision(6) << synthetic.avg_wait_time()
+         << setw(12) << setprecision(4) << synthetic.rho() << "\n";
+    cout << setprecision(2) << "трасса     "
+         << setw(11) << replay_ms
+         << setw(11) << setprecision(0) << replay.events_processed() / (replay_ms / 1000.0)
+         << setw(14) << setprecision(6) << replay.avg_wait_time()
+         << setw(12) << setprecision(4) << replay.rho() << "\n";
+    cout << "W совпадает: " << (synthetic.avg_wait_time() == replay.avg_wait_time() ? "да" : "НЕТ") << "\n";
+
+    remove(csv.c_str());
+    remove(trc.c_str());
+    return 0;
+}
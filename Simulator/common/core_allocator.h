@@ -0,0 +1,281 @@
+#ifndef CORE_ALLOCATOR_H
+#define CORE_ALLOCATOR_H
+
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "serialization.h"
+
+namespace CoreAllocators {
+
+// Правило выбора свободного ядра
+enum class Policy {
+    LOWEST_INDEX,     // свободное ядро с наименьшим номером
+    ROUND_ROBIN,      // следующее свободное ядро после последнего выбранного
+    LEAST_UTILIZED    // свободное ядро с наименьшим накопленным временем занятости
+};
+
+inline std::string policy_name(Policy policy) {
+    switch (policy) {
+        case Policy::LOWEST_INDEX: return "LOWEST_INDEX";
+        case Policy::ROUND_ROBIN: return "ROUND_ROBIN";
+        case Policy::LEAST_UTILIZED: return "LEAST_UTILIZED";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * Распределитель ядер сервера в виде структуры массивов
+ *
+ * Свободные ядра отмечены в двухуровневой битовой маске (слово на 64 ядра
+ * и сводное слово на 64 слова), поэтому поиск свободного ядра - два
+ * __builtin_ctzll для c <= 4096, а число занятых ядер хранится счётчиком.
+ * Для LEAST_UTILIZED свободные ядра дополнительно лежат в двоичной куче
+ * по накопленному времени занятости: O(log c) на захват и освобождение.
+ * Данные ядер (время завершения, текущее задание, занятость) хранятся
+ * раздельными плотными массивами.
+ */
+class CoreAllocator {
+private:
+    static constexpr int WORD_BITS = 64;
+
+    int num_cores_;
+    int busy_count_;
+    Policy policy_;
+    int cursor_;                           // следующий кандидат ROUND_ROBIN
+
+    std::vector<uint64_t> free_mask_;      // бит ядра = 1, если ядро свободно
+    std::vector<uint64_t> summary_;        // бит слова = 1, если в нём есть свободные ядра
+    std::vector<double> finish_time_;      // время завершения текущего задания
+    std::vector<int> current_job_;         // текущее задание (-1 = свободно)
+    std::vector<double> busy_since_;       // начало текущего периода занятости
+    std::vector<double> busy_time_;        // завершённые периоды занятости
+    std::vector<int> free_heap_;           // свободные ядра (только LEAST_UTILIZED)
+
+    static int ctz(uint64_t word) { return __builtin_ctzll(word); }
+
+    void mark_free(int core) {
+        int word = core / WORD_BITS;
+        free_mask_[word] |= uint64_t(1) << (core % WORD_BITS);
+        summary_[word / WORD_BITS] |= uint64_t(1) << (word % WORD_BITS);
+    }
+
+    void mark_busy(int core) {
+        int word = core / WORD_BITS;
+        free_mask_[word] &= ~(uint64_t(1) << (core % WORD_BITS));
+        if (free_mask_[word] == 0) {
+            summary_[word / WORD_BITS] &= ~(uint64_t(1) << (word % WORD_BITS));
+        }
+    }
+
+    bool is_free(int core) const {
+        return (free_mask_[core / WORD_BITS] >> (core % WORD_BITS)) & 1;
+    }
+
+    int first_free() const {
+        for (size_t s = 0; s < summary_.size(); ++s) {
+            if (summary_[s] != 0) {
+                int word = static_cast<int>(s) * WORD_BITS + ctz(summary_[s]);
+                return word * WORD_BITS + ctz(free_mask_[word]);
+            }
+        }
+        return -1;
+    }
+
+    // Первое свободное ядро с номером >= from (с переходом через конец)
+    int next_free(int from) const {
+        if (busy_count_ == num_cores_) return -1;
+        int word = from / WORD_BITS;
+        uint64_t bits = free_mask_[word] & (~uint64_t(0) << (from % WORD_BITS));
+        if (bits != 0) return word * WORD_BITS + ctz(bits);
+        for (size_t w = word + 1; w < free_mask_.size(); ++w) {
+            if (free_mask_[w] != 0) return static_cast<int>(w) * WORD_BITS + ctz(free_mask_[w]);
+        }
+        return first_free();
+    }
+
+    // Куча по (накопленная занятость, номер ядра)
+    bool heap_less(int a, int b) const {
+        if (busy_time_[a] != busy_time_[b]) return busy_time_[a] < busy_time_[b];
+        return a < b;
+    }
+
+    void heap_push(int core) {
+        free_heap_.push_back(core);
+        size_t i = free_heap_.size() - 1;
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!heap_less(free_heap_[i], free_heap_[parent])) break;
+            std::swap(free_heap_[i], free_heap_[parent]);
+            i = parent;
+        }
+    }
+
+    int heap_pop() {
+        int top = free_heap_.front();
+        free_heap_.front() = free_heap_.back();
+        free_heap_.pop_back();
+        size_t i = 0, n = free_heap_.size();
+        while (true) {
+            size_t left = 2 * i + 1, right = left + 1, best = i;
+            if (left < n && heap_less(free_heap_[left], free_heap_[best])) best = left;
+            if (right < n && heap_less(free_heap_[right], free_heap_[best])) best = right;
+            if (best == i) break;
+            std::swap(free_heap_[i], free_heap_[best]);
+            i = best;
+        }
+        return top;
+    }
+
+    void rebuild_heap() {
+        free_heap_.clear();
+        if (policy_ != Policy::LEAST_UTILIZED) return;
+        for (int core = 0; core < num_cores_; ++core) {
+            if (is_free(core)) heap_push(core);
+        }
+    }
+
+    void check(int core) const {
+        if (core < 0 || core >= num_cores_) {
+            throw std::out_of_range("Неверный идентификатор ядра");
+        }
+    }
+
+public:
+    explicit CoreAllocator(int num_cores = 1, Policy policy = Policy::LOWEST_INDEX)
+        : num_cores_(num_cores), busy_count_(0), policy_(policy), cursor_(0) {
+        if (num_cores <= 0) {
+            throw std::invalid_argument("Количество ядер должно быть положительным");
+        }
+        size_t words = (static_cast<size_t>(num_cores) + WORD_BITS - 1) / WORD_BITS;
+        free_mask_.assign(words, 0);
+        summary_.assign((words + WORD_BITS - 1) / WORD_BITS, 0);
+        finish_time_.assign(num_cores, 0.0);
+        current_job_.assign(num_cores, -1);
+        busy_since_.assign(num_cores, 0.0);
+        busy_time_.assign(num_cores, 0.0);
+        free_heap_.reserve(num_cores);
+        reset();
+    }
+
+    // Все ядра свободны, накопленная занятость обнулена; правило выбора сохраняется
+    void reset() {
+        busy_count_ = 0;
+        cursor_ = 0;
+        std::fill(free_mask_.begin(), free_mask_.end(), 0);
+        std::fill(summary_.begin(), summary_.end(), 0);
+        for (int core = 0; core < num_cores_; ++core) mark_free(core);
+        std::fill(finish_time_.begin(), finish_time_.end(), 0.0);
+        std::fill(current_job_.begin(), current_job_.end(), -1);
+        std::fill(busy_since_.begin(), busy_since_.end(), 0.0);
+        std::fill(busy_time_.begin(), busy_time_.end(), 0.0);
+        rebuild_heap();
+    }
+
+    void set_policy(Policy policy) {
+        policy_ = policy;
+        rebuild_heap();
+    }
+
+    // Свободное ядро по правилу выбора без захвата (-1, если все заняты)
+    int select() const {
+        if (busy_count_ == num_cores_) return -1;
+        switch (policy_) {
+            case Policy::ROUND_ROBIN: return next_free(cursor_);
+            case Policy::LEAST_UTILIZED: return free_heap_.front();
+            case Policy::LOWEST_INDEX: break;
+        }
+        return first_free();
+    }
+
+    // Захватывает ядро по правилу выбора; -1, если все заняты
+    int acquire(int job_id, double now, double finish_time) {
+        int core = select();
+        if (core == -1) return -1;
+        if (policy_ == Policy::LEAST_UTILIZED) heap_pop();
+        if (policy_ == Policy::ROUND_ROBIN) cursor_ = core + 1 < num_cores_ ? core + 1 : 0;
+        mark_busy(core);
+        busy_count_++;
+        finish_time_[core] = finish_time;
+        current_job_[core] = job_id;
+        busy_since_[core] = now;
+        return core;
+    }
+
+    // Передаёт занятое ядро следующему заданию без перерыва в занятости
+    void reassign(int core, int job_id, double finish_time) {
+        check(core);
+        if (is_free(core)) {
+            throw std::logic_error("Передача свободного ядра");
+        }
+        finish_time_[core] = finish_time;
+        current_job_[core] = job_id;
+    }
+
+    void release(int core, double now) {
+        check(core);
+        if (is_free(core)) return;
+        busy_time_[core] += now - busy_since_[core];
+        mark_free(core);
+        busy_count_--;
+        finish_time_[core] = 0.0;
+        current_job_[core] = -1;
+        if (policy_ == Policy::LEAST_UTILIZED) heap_push(core);
+    }
+
+    // Начинает учёт занятости заново с момента now, не меняя текущих назначений
+    void restart_accounting(double now) {
+        std::fill(busy_time_.begin(), busy_time_.end(), 0.0);
+        for (int core = 0; core < num_cores_; ++core) {
+            if (!is_free(core)) busy_since_[core] = now;
+        }
+        rebuild_heap();
+    }
+
+    // Время занятости ядра с последнего сброса учёта по момент now
+    double busy_time(int core, double now) const {
+        check(core);
+        return busy_time_[core] + (is_free(core) ? 0.0 : now - busy_since_[core]);
+    }
+
+    void save(Serialization::Writer& out) const {
+        out.write(num_cores_);
+        out.write(busy_count_);
+        out.write(cursor_);
+        out.write_vector(free_mask_);
+        out.write_vector(summary_);
+        out.write_vector(finish_time_);
+        out.write_vector(current_job_);
+        out.write_vector(busy_since_);
+        out.write_vector(busy_time_);
+    }
+
+    // Правило выбора не восстанавливается: оно задаётся владельцем
+    void load(Serialization::Reader& in) {
+        if (in.read<int>() != num_cores_) {
+            throw std::invalid_argument("Контрольная точка несовместима: другое число ядер");
+        }
+        in.read(busy_count_);
+        in.read(cursor_);
+        in.read_vector(free_mask_);
+        in.read_vector(summary_);
+        in.read_vector(finish_time_);
+        in.read_vector(current_job_);
+        in.read_vector(busy_since_);
+        in.read_vector(busy_time_);
+        rebuild_heap();
+    }
+
+    int size() const { return num_cores_; }
+    int busy_count() const { return busy_count_; }
+    bool busy(int core) const { return !is_free(core); }
+    int current_job(int core) const { return current_job_[core]; }
+    double finish_time(int core) const { return finish_time_[core]; }
+    Policy policy() const { return policy_; }
+};
+
+} // namespace CoreAllocators
+
+#endif // CORE_ALLOCATOR_H
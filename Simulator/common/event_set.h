@@ -0,0 +1,706 @@
+#ifndef EVENT_SET_H
+#define EVENT_SET_H
+
+#include <stdexcept>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <string>
+#include "indexed_heap.h"
+
+namespace EventSets {
+
+/**
+ * Базовый класс множества ожидающих событий (pending event set)
+ *
+ * Требования к типу события E:
+ *   - поле double time (метка времени);
+ *   - operator> задаёт строгий полный порядок (раньше → меньше).
+ */
+template<typename E>
+class EventSet {
+public:
+    virtual ~EventSet() = default;
+    virtual void push(const E& event) = 0;
+    virtual E pop() = 0;
+    virtual const E& top() const = 0;
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+    virtual void clear() = 0;
+    virtual std::string name() const = 0;
+    
+    // Дописывает все события в out в произвольном порядке (для контрольных точек:
+    // порядок полный, поэтому повторная вставка даёт ту же последовательность pop())
+    virtual void collect(std::vector<E>& out) const = 0;
+};
+
+// 1. Бинарная куча - исходная реализация на std::priority_queue
+template<typename E>
+class BinaryHeapEventSet final : public EventSet<E> {
+private:
+    std::priority_queue<E, std::vector<E>, std::greater<E>> queue_;
+
+public:
+    void push(const E& event) override {
+        queue_.push(event);
+    }
+
+    E pop() override {
+        if (queue_.empty()) {
+            throw std::runtime_error("Event set is empty");
+        }
+        E event = queue_.top();
+        queue_.pop();
+        return event;
+    }
+
+    const E& top() const override {
+        if (queue_.empty()) {
+            throw std::runtime_error("Event set is empty");
+        }
+        return queue_.top();
+    }
+
+    bool empty() const override { return queue_.empty(); }
+    size_t size() const override { return queue_.size(); }
+
+    void clear() override {
+        queue_ = decltype(queue_)();
+    }
+
+    std::string name() const override { return "BINARY_HEAP"; }
+
+    void collect(std::vector<E>& out) const override {
+        auto copy = queue_;
+        while (!copy.empty()) {
+            out.push_back(copy.top());
+            copy.pop();
+        }
+    }
+};
+
+// 2. D-арная куча (по умолчанию 4-арная): меньше уровней и
+//    дети одного узла лежат в одной-двух кэш-линиях
+template<typename E, size_t D = 4>
+class DaryHeapEventSet final : public EventSet<E> {
+    static_assert(D >= 2, "Арность кучи должна быть не меньше 2");
+
+private:
+    std::vector<E> heap_;
+
+    void sift_up(size_t i) {
+        E item = std::move(heap_[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / D;
+            if (!(heap_[parent] > item)) break;
+            heap_[i] = std::move(heap_[parent]);
+            i = parent;
+        }
+        heap_[i] = std::move(item);
+    }
+
+    void sift_down(size_t i) {
+        const size_t n = heap_.size();
+        E item = std::move(heap_[i]);
+        while (true) {
+            size_t first = i * D + 1;
+            if (first >= n) break;
+
+            size_t last = std::min(first + D, n);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (heap_[best] > heap_[c]) best = c;
+            }
+
+            if (!(item > heap_[best])) break;
+            heap_[i] = std::move(heap_[best]);
+            i = best;
+        }
+        heap_[i] = std::move(item);
+    }
+
+public:
+    void push(const E& event) override {
+        heap_.push_back(event);
+        sift_up(heap_.size() - 1);
+    }
+
+    E pop() override {
+        if (heap_.empty()) {
+            throw std::runtime_error("Event set is empty");
+        }
+        E event = std::move(heap_.front());
+        if (heap_.size() > 1) {
+            heap_.front() = std::move(heap_.back());
+            heap_.pop_back();
+            sift_down(0);
+        } else {
+            heap_.pop_back();
+        }
+        return event;
+    }
+
+    const E& top() const override {
+        if (heap_.empty()) {
+            throw std::runtime_error("Event set is empty");
+        }
+        return heap_.front();
+    }
+
+    bool empty() const override { return heap_.empty(); }
+    size_t size() const override { return heap_.size(); }
+    void clear() override { heap_.clear(); }
+
+    std::string name() const override {
+        return std::to_string(D) + "-ARY_HEAP";
+    }
+
+    void collect(std::vector<E>& out) const override {
+        out.insert(out.end(), heap_.begin(), heap_.end());
+    }
+};
+
+/**
+ * 3. Календарная очередь (R. Brown, 1988)
+ *
+ * События раскладываются по "дням" ширины width_ в кольцо из n корзин.
+ * Виртуальный номер дня floor(t / width_) вычисляется одинаково при вставке
+ * и извлечении, поэтому порядок событий с равным временем сохраняется.
+ * При росте/уменьшении числа событий календарь перестраивается,
+ * а ширина дня оценивается по разбросу ближайших событий.
+ */
+template<typename E>
+class CalendarQueueEventSet final : public EventSet<E> {
+private:
+    static constexpr size_t MIN_BUCKETS = 2;
+    static constexpr size_t WIDTH_SAMPLE = 25;
+
+    // Каждая корзина отсортирована по убыванию: минимум в конце
+    std::vector<std::vector<E>> buckets_;
+    double width_;
+    size_t size_;
+    long long current_day_;     // виртуальный номер текущего дня
+    bool resize_enabled_;
+
+    // Кэш позиции минимума для top()/pop()
+    mutable size_t cached_bucket_;
+    mutable bool cache_valid_;
+
+    long long day_of(double t) const {
+        return static_cast<long long>(std::floor(t / width_));
+    }
+
+    size_t bucket_of(long long day) const {
+        long long n = static_cast<long long>(buckets_.size());
+        long long idx = day % n;
+        return static_cast<size_t>(idx < 0 ? idx + n : idx);
+    }
+
+    void insert_sorted(const E& event) {
+        auto& bucket = buckets_[bucket_of(day_of(event.time))];
+        // Убывающий порядок: новое событие встаёт после всех более поздних
+        auto pos = std::upper_bound(bucket.begin(), bucket.end(), event,
+                                    [](const E& a, const E& b) { return a > b; });
+        bucket.insert(pos, event);
+    }
+
+    // Поиск корзины с минимальным событием, начиная с текущего дня
+    size_t locate_min() const {
+        if (cache_valid_) return cached_bucket_;
+
+        const size_t n = buckets_.size();
+        long long day = current_day_;
+        size_t idx = bucket_of(day);
+
+        for (size_t step = 0; step < n; ++step) {
+            const auto& bucket = buckets_[idx];
+            if (!bucket.empty() && day_of(bucket.back().time) <= day) {
+                cached_bucket_ = idx;
+                cache_valid_ = true;
+                return idx;
+            }
+            ++day;
+            idx = (idx + 1 == n) ? 0 : idx + 1;
+        }
+
+        // Полный оборот без результата - прямой поиск минимума
+        size_t best = n;
+        for (size_t i = 0; i < n; ++i) {
+            if (buckets_[i].empty()) continue;
+            if (best == n || buckets_[best].back() > buckets_[i].back()) {
+                best = i;
+            }
+        }
+        cached_bucket_ = best;
+        cache_valid_ = true;
+        return best;
+    }
+
+    double estimate_width(std::vector<E>& events) const {
+        size_t sample = std::min(events.size(), WIDTH_SAMPLE);
+        if (sample < 2) return width_;
+
+        std::partial_sort(events.begin(), events.begin() + sample, events.end(),
+                          [](const E& a, const E& b) { return b > a; });
+
+        double avg_gap = (events[sample - 1].time - events[0].time) / (sample - 1);
+        if (avg_gap <= 0.0) return width_;
+
+        // Повторная оценка без выбросов (интервалы больше 2 средних)
+        double sum = 0.0;
+        size_t count = 0;
+        for (size_t i = 1; i < sample; ++i) {
+            double gap = events[i].time - events[i - 1].time;
+            if (gap <= 2.0 * avg_gap) {
+                sum += gap;
+                count++;
+            }
+        }
+        double width = (count > 0 && sum > 0.0) ? 3.0 * sum / count : 3.0 * avg_gap;
+        return (std::isfinite(width) && width > 0.0) ? width : width_;
+    }
+
+    void resize(size_t new_buckets) {
+        std::vector<E> events;
+        events.reserve(size_);
+        for (auto& bucket : buckets_) {
+            events.insert(events.end(), bucket.begin(), bucket.end());
+        }
+
+        width_ = estimate_width(events);
+        buckets_.assign(std::max(new_buckets, MIN_BUCKETS), std::vector<E>());
+        for (const auto& event : events) {
+            insert_sorted(event);
+        }
+
+        if (!events.empty()) {
+            const E* min_event = &events[0];
+            for (const auto& event : events) {
+                if (*min_event > event) min_event = &event;
+            }
+            current_day_ = day_of(min_event->time);
+        }
+        cache_valid_ = false;
+    }
+
+public:
+    explicit CalendarQueueEventSet(double initial_width = 1.0, size_t initial_buckets = MIN_BUCKETS)
+        : buckets_(std::max(initial_buckets, MIN_BUCKETS)),
+          width_(initial_width),
+          size_(0),
+          current_day_(0),
+          resize_enabled_(true),
+          cached_bucket_(0),
+          cache_valid_(false) {
+        if (initial_width <= 0.0) {
+            throw std::invalid_argument("Ширина дня календаря должна быть положительной");
+        }
+    }
+
+    void push(const E& event) override {
+        insert_sorted(event);
+        size_++;
+
+        // Событие в прошлом относительно текущего дня сдвигает календарь назад
+        long long day = day_of(event.time);
+        if (day < current_day_) current_day_ = day;
+        cache_valid_ = false;
+
+        if (resize_enabled_ && size_ > 2 * buckets_.size()) {
+            resize(2 * buckets_.size());
+        }
+    }
+
+    E pop() override {
+        if (size_ == 0) {
+            throw std::runtime_error("Event set is empty");
+        }
+        size_t idx = locate_min();
+        auto& bucket = buckets_[idx];
+        E event = std::move(bucket.back());
+        bucket.pop_back();
+        size_--;
+
+        current_day_ = day_of(event.time);
+        cache_valid_ = false;
+
+        if (resize_enabled_ && buckets_.size() > MIN_BUCKETS && size_ < buckets_.size() / 2) {
+            resize(buckets_.size() / 2);
+        }
+        return event;
+    }
+
+    const E& top() const override {
+        if (size_ == 0) {
+            throw std::runtime_error("Event set is empty");
+        }
+        return buckets_[locate_min()].back();
+    }
+
+    bool empty() const override { return size_ == 0; }
+    size_t size() const override { return size_; }
+
+    void clear() override {
+        buckets_.assign(MIN_BUCKETS, std::vector<E>());
+        size_ = 0;
+        current_day_ = 0;
+        cache_valid_ = false;
+    }
+
+    std::string name() const override { return "CALENDAR_QUEUE"; }
+
+    void collect(std::vector<E>& out) const override {
+        for (const auto& bucket : buckets_) out.insert(out.end(), bucket.begin(), bucket.end());
+    }
+
+    double bucket_width() const { return width_; }
+    size_t bucket_count() const { return buckets_.size(); }
+};
+
+/**
+ * 4. Лестничная очередь (Tang, Goh, Thng, 2005)
+ *
+ * Top    - неотсортированный приёмник далёких событий (t > top_start_);
+ * Ladder - ступени из корзин, каждая следующая ступень мельче предыдущей;
+ * Bottom - короткий отсортированный список ближайших событий.
+ * Сортируются только события, дошедшие до Bottom, поэтому амортизированная
+ * стоимость операций близка к O(1) и не зависит от распределения времени.
+ */
+template<typename E>
+class LadderQueueEventSet final : public EventSet<E> {
+private:
+    static constexpr size_t THRESHOLD = 50;   // порог порождения новой ступени
+    static constexpr size_t MAX_RUNGS = 8;
+
+    struct Rung {
+        double start;
+        double width;
+        size_t current;    // первая ещё не выданная корзина
+        size_t count;      // событий на ступени
+        std::vector<std::vector<E>> buckets;
+
+        double current_start() const { return start + width * current; }
+    };
+
+    std::vector<E> top_;
+    double top_start_;
+    double top_min_;
+    double top_max_;
+
+    std::vector<Rung> rungs_;
+    std::vector<E> bottom_;        // по убыванию: минимум в конце
+    size_t size_;
+
+    static bool greater(const E& a, const E& b) { return a > b; }
+
+    void insert_bottom(const E& event) {
+        auto pos = std::upper_bound(bottom_.begin(), bottom_.end(), event, greater);
+        bottom_.insert(pos, event);
+    }
+
+    static size_t bucket_index(const Rung& rung, double t) {
+        double offset = (t - rung.start) / rung.width;
+        size_t last = rung.buckets.size() - 1;
+        if (!(offset > 0.0)) return rung.current;
+        size_t idx = offset >= static_cast<double>(last) ? last : static_cast<size_t>(offset);
+        return std::max(idx, rung.current);
+    }
+
+    void fill_rung(Rung& rung, std::vector<E>& events) {
+        rung.count = events.size();
+        for (auto& event : events) {
+            rung.buckets[bucket_index(rung, event.time)].push_back(std::move(event));
+        }
+        events.clear();
+    }
+
+    bool spawn_from_top() {
+        if (top_.empty()) return false;
+
+        top_start_ = top_max_;
+        if (top_.size() <= THRESHOLD || top_max_ <= top_min_) {
+            for (auto& event : top_) bottom_.push_back(std::move(event));
+            std::sort(bottom_.begin(), bottom_.end(), greater);
+        } else {
+            Rung rung;
+            rung.start = top_min_;
+            rung.width = (top_max_ - top_min_) / top_.size();
+            rung.current = 0;
+            rung.buckets.resize(top_.size() + 1);
+            fill_rung(rung, top_);
+            rungs_.push_back(std::move(rung));
+        }
+
+        top_.clear();
+        top_min_ = std::numeric_limits<double>::infinity();
+        top_max_ = -std::numeric_limits<double>::infinity();
+        return true;
+    }
+
+    // Переносит ближайшую непустую корзину в Bottom (или дробит её на новую ступень)
+    void refill_bottom() {
+        while (bottom_.empty()) {
+            if (rungs_.empty()) {
+                if (!spawn_from_top()) return;
+                continue;
+            }
+
+            Rung& rung = rungs_.back();
+            while (rung.current < rung.buckets.size() && rung.buckets[rung.current].empty()) {
+                rung.current++;
+            }
+            if (rung.current == rung.buckets.size() || rung.count == 0) {
+                rungs_.pop_back();
+                continue;
+            }
+
+            std::vector<E> bucket = std::move(rung.buckets[rung.current]);
+            rung.buckets[rung.current].clear();
+            double bucket_start = rung.current_start();
+            double bucket_width = rung.width;
+            rung.current++;
+            rung.count -= bucket.size();
+
+            double lo = bucket.front().time, hi = lo;
+            for (const auto& event : bucket) {
+                lo = std::min(lo, event.time);
+                hi = std::max(hi, event.time);
+            }
+
+            if (bucket.size() > THRESHOLD && rungs_.size() < MAX_RUNGS && hi > lo) {
+                Rung child;
+                child.start = bucket_start;
+                child.width = bucket_width / bucket.size();
+                child.current = 0;
+                child.buckets.resize(bucket.size() + 1);
+                if (!(child.width > 0.0)) child.width = bucket_width;
+                fill_rung(child, bucket);
+                rungs_.push_back(std::move(child));
+            } else {
+                bottom_ = std::move(bucket);
+                std::sort(bottom_.begin(), bottom_.end(), greater);
+            }
+        }
+    }
+
+public:
+    LadderQueueEventSet()
+        : top_start_(-std::numeric_limits<double>::infinity()),
+          top_min_(std::numeric_limits<double>::infinity()),
+          top_max_(-std::numeric_limits<double>::infinity()),
+          size_(0) {}
+
+    void push(const E& event) override {
+        size_++;
+        const double t = event.time;
+
+        if (t > top_start_) {
+            top_.push_back(event);
+            top_min_ = std::min(top_min_, t);
+            top_max_ = std::max(top_max_, t);
+            return;
+        }
+
+        for (auto& rung : rungs_) {
+            if (t >= rung.current_start()) {
+                rung.buckets[bucket_index(rung, t)].push_back(event);
+                rung.count++;
+                return;
+            }
+        }
+
+        insert_bottom(event);
+    }
+
+    E pop() override {
+        if (size_ == 0) {
+            throw std::runtime_error("Event set is empty");
+        }
+        refill_bottom();
+        E event = std::move(bottom_.back());
+        bottom_.pop_back();
+        size_--;
+        return event;
+    }
+
+    const E& top() const override {
+        if (size_ == 0) {
+            throw std::runtime_error("Event set is empty");
+        }
+        // Заполнение Bottom не меняет логического содержимого множества
+        const_cast<LadderQueueEventSet*>(this)->refill_bottom();
+        return bottom_.back();
+    }
+
+    bool empty() const override { return size_ == 0; }
+    size_t size() const override { return size_; }
+
+    void clear() override {
+        top_.clear();
+        rungs_.clear();
+        bottom_.clear();
+        top_start_ = -std::numeric_limits<double>::infinity();
+        top_min_ = std::numeric_limits<double>::infinity();
+        top_max_ = -std::numeric_limits<double>::infinity();
+        size_ = 0;
+    }
+
+    std::string name() const override { return "LADDER_QUEUE"; }
+
+    void collect(std::vector<E>& out) const override {
+        out.insert(out.end(), top_.begin(), top_.end());
+        for (const auto& rung : rungs_) {
+            for (size_t i = rung.current; i < rung.buckets.size(); ++i) {
+                out.insert(out.end(), rung.buckets[i].begin(), rung.buckets[i].end());
+            }
+        }
+        out.insert(out.end(), bottom_.begin(), bottom_.end());
+    }
+};
+
+/**
+ * 5. Индексированная 4-арная куча с отменой событий
+ *
+ * push() через schedule() возвращает идентификатор события; cancel()
+ * удаляет ещё не извлечённое событие за O(log n), reschedule() переносит
+ * его на другое время тоже за O(log n). Нужна моделям с вытеснением, где
+ * запланированное завершение обслуживания отменяется (MultiClassSimulator).
+ * Идентификаторы переиспользуются после извлечения или отмены события.
+ */
+template<typename E>
+class IndexedHeapEventSet final : public EventSet<E> {
+private:
+    // Ключ кучи - само событие: раньше то, что меньше по operator> события
+    struct Earlier {
+        E event;
+        bool operator<(const Earlier& other) const { return other.event > event; }
+    };
+
+    IndexedHeaps::IndexedHeap<Earlier, 4> heap_;
+    std::vector<int> free_ids_;      // стек освободившихся идентификаторов
+    int next_id_;
+
+public:
+    IndexedHeapEventSet() : next_id_(0) {}
+
+    // Планирует событие и возвращает его идентификатор
+    int schedule(const E& event) {
+        int id;
+        if (!free_ids_.empty()) {
+            id = free_ids_.back();
+            free_ids_.pop_back();
+        } else {
+            id = next_id_++;
+        }
+        heap_.push(id, Earlier{event});
+        return id;
+    }
+
+    // Отменяет запланированное событие; false, если оно уже извлечено или отменено
+    bool cancel(int id) {
+        if (!heap_.contains(id)) return false;
+        heap_.erase(id);
+        free_ids_.push_back(id);
+        return true;
+    }
+
+    void reschedule(int id, const E& event) {
+        heap_.update(id, Earlier{event});
+    }
+
+    bool scheduled(int id) const { return heap_.contains(id); }
+
+    void push(const E& event) override {
+        schedule(event);
+    }
+
+    E pop() override {
+        if (heap_.empty()) {
+            throw std::runtime_error("Event set is empty");
+        }
+        E event = heap_.top_key().event;
+        free_ids_.push_back(heap_.pop());
+        return event;
+    }
+
+    const E& top() const override {
+        if (heap_.empty()) {
+            throw std::runtime_error("Event set is empty");
+        }
+        return heap_.top_key().event;
+    }
+
+    bool empty() const override { return heap_.empty(); }
+    size_t size() const override { return heap_.size(); }
+
+    void clear() override {
+        heap_.clear();
+        free_ids_.clear();
+        next_id_ = 0;
+    }
+
+    std::string name() const override { return "INDEXED_HEAP"; }
+
+    void collect(std::vector<E>& out) const override {
+        heap_.for_each([&out](int, const Earlier& key) { out.push_back(key.event); });
+    }
+};
+
+// Фабрика для создания множеств событий
+template<typename E>
+class EventSetFactory {
+public:
+    enum class Type {
+        BINARY_HEAP,
+        QUATERNARY_HEAP,
+        CALENDAR_QUEUE,
+        LADDER_QUEUE,
+        INDEXED_HEAP
+    };
+
+    static std::unique_ptr<EventSet<E>> create(Type type) {
+        switch (type) {
+            case Type::BINARY_HEAP:
+                return std::make_unique<BinaryHeapEventSet<E>>();
+            case Type::QUATERNARY_HEAP:
+                return std::make_unique<DaryHeapEventSet<E, 4>>();
+            case Type::CALENDAR_QUEUE:
+                return std::make_unique<CalendarQueueEventSet<E>>();
+            case Type::LADDER_QUEUE:
+                return std::make_unique<LadderQueueEventSet<E>>();
+            case Type::INDEXED_HEAP:
+                return std::make_unique<IndexedHeapEventSet<E>>();
+            default:
+                throw std::invalid_argument("Unknown event set type");
+        }
+    }
+
+    static std::string type_to_string(Type type) {
+        switch (type) {
+            case Type::BINARY_HEAP: return "BINARY_HEAP";
+            case Type::QUATERNARY_HEAP: return "4-ARY_HEAP";
+            case Type::CALENDAR_QUEUE: return "CALENDAR_QUEUE";
+            case Type::LADDER_QUEUE: return "LADDER_QUEUE";
+            case Type::INDEXED_HEAP: return "INDEXED_HEAP";
+            default: return "UNKNOWN";
+        }
+    }
+
+    static std::vector<Type> get_all_types() {
+        return {
+            Type::BINARY_HEAP,
+            Type::QUATERNARY_HEAP,
+            Type::CALENDAR_QUEUE,
+            Type::LADDER_QUEUE,
+            Type::INDEXED_HEAP
+        };
+    }
+};
+
+} // namespace EventSets
+
+#endif // EVENT_SET_H
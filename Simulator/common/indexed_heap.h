@@ -0,0 +1,167 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace IndexedHeaps {
+
+/**
+ * D-арная куча с индексом позиций (по умолчанию 4-арная)
+ *
+ * Элемент адресуется плотным неотрицательным идентификатором - обычно
+ * дескриптором записи во внешней таблице. Для каждого идентификатора
+ * хранится позиция в куче, поэтому кроме вставки и извлечения минимума
+ * за O(log n) доступны удаление произвольного элемента и изменение его
+ * ключа в обе стороны, тоже за O(log n). Раньше извлекается меньший по
+ * operator< ключ; порядок равных ключей не определён, поэтому ключ должен
+ * сам разрешать равенство (например, порядковым номером).
+ */
+template<typename Key, size_t D = 4>
+class IndexedHeap {
+    static_assert(D >= 2, "Арность кучи должна быть не меньше 2");
+
+private:
+    struct Entry {
+        Key key;
+        int id;
+    };
+
+    std::vector<Entry> heap_;
+    std::vector<int> position_;      // позиция идентификатора в heap_ (-1 - не в куче)
+
+    void place(size_t pos, Entry entry) {
+        position_[entry.id] = static_cast<int>(pos);
+        heap_[pos] = std::move(entry);
+    }
+
+    // Просеивание «дыркой»: соседи сдвигаются, элемент записывается один раз
+    void sift_up(size_t pos, Entry entry) {
+        while (pos > 0) {
+            size_t parent = (pos - 1) / D;
+            if (!(entry.key < heap_[parent].key)) break;
+            place(pos, std::move(heap_[parent]));
+            pos = parent;
+        }
+        place(pos, std::move(entry));
+    }
+
+    void sift_down(size_t pos, Entry entry) {
+        const size_t n = heap_.size();
+        while (true) {
+            size_t first = pos * D + 1;
+            if (first >= n) break;
+            size_t last = std::min(first + D, n);
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (heap_[child].key < heap_[best].key) best = child;
+            }
+            if (!(heap_[best].key < entry.key)) break;
+            place(pos, std::move(heap_[best]));
+            pos = best;
+        }
+        place(pos, std::move(entry));
+    }
+
+    // Последний элемент занимает место удалённого и просеивается в нужную сторону
+    void remove_at(size_t pos) {
+        position_[heap_[pos].id] = -1;
+        Entry last = std::move(heap_.back());
+        heap_.pop_back();
+        if (pos == heap_.size()) return;
+        if (pos > 0 && last.key < heap_[(pos - 1) / D].key) {
+            sift_up(pos, std::move(last));
+        } else {
+            sift_down(pos, std::move(last));
+        }
+    }
+
+    void check(int id) const {
+        if (!contains(id)) {
+            throw std::out_of_range("Элемент отсутствует в куче");
+        }
+    }
+
+public:
+    void push(int id, Key key) {
+        if (id < 0) {
+            throw std::invalid_argument("Идентификатор элемента кучи должен быть неотрицательным");
+        }
+        if (static_cast<size_t>(id) >= position_.size()) {
+            position_.resize(std::max(static_cast<size_t>(id) + 1, 2 * position_.size()), -1);
+        }
+        if (position_[id] != -1) {
+            throw std::logic_error("Элемент уже находится в куче");
+        }
+        heap_.emplace_back();
+        sift_up(heap_.size() - 1, Entry{std::move(key), id});
+    }
+
+    int top() const {
+        if (heap_.empty()) {
+            throw std::runtime_error("Heap is empty");
+        }
+        return heap_.front().id;
+    }
+
+    const Key& top_key() const {
+        if (heap_.empty()) {
+            throw std::runtime_error("Heap is empty");
+        }
+        return heap_.front().key;
+    }
+
+    int pop() {
+        int id = top();
+        remove_at(0);
+        return id;
+    }
+
+    void erase(int id) {
+        check(id);
+        remove_at(static_cast<size_t>(position_[id]));
+    }
+
+    // Новый ключ элемента: decrease-key поднимает его, increase-key опускает
+    void update(int id, Key key) {
+        check(id);
+        size_t pos = static_cast<size_t>(position_[id]);
+        bool earlier = key < heap_[pos].key;
+        Entry entry{std::move(key), id};
+        if (earlier) {
+            sift_up(pos, std::move(entry));
+        } else {
+            sift_down(pos, std::move(entry));
+        }
+    }
+
+    const Key& key(int id) const {
+        check(id);
+        return heap_[position_[id]].key;
+    }
+
+    bool contains(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < position_.size() && position_[id] != -1;
+    }
+
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+
+    // Опустошает кучу, сохраняя выделенную память
+    void clear() {
+        for (const Entry& entry : heap_) position_[entry.id] = -1;
+        heap_.clear();
+    }
+
+    // Обход в порядке хранения (не по возрастанию ключа)
+    template<typename F>
+    void for_each(F visit) const {
+        for (const Entry& entry : heap_) visit(entry.id, entry.key);
+    }
+};
+
+} // namespace IndexedHeaps
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,134 @@
+#ifndef JOB_TABLE_H
+#define JOB_TABLE_H
+
+#include <stdexcept>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include "serialization.h"
+
+namespace JobTables {
+
+/**
+ * Пул записей фиксированного типа со списком свободных ячеек (slab)
+ *
+ * Запись адресуется плотным дескриптором - индексом ячейки. Освобождённые
+ * ячейки переиспользуются в порядке LIFO, поэтому после прогрева (когда ёмкость
+ * достигла пикового числа одновременно живых записей) acquire()/release()
+ * не выделяют память. Каждое выделение памяти учитывается в allocations().
+ */
+template<typename T>
+class SlabTable {
+private:
+    struct Slot {
+        T value;
+        bool live;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<int> free_list_;     // стек свободных дескрипторов
+    size_t live_count_;
+    size_t allocations_;             // число выделений памяти под пул
+
+public:
+    explicit SlabTable(size_t initial_capacity = 0)
+        : live_count_(0), allocations_(0) {
+        reserve(initial_capacity);
+    }
+
+    // Захватывает ячейку и возвращает её дескриптор
+    int acquire(const T& value) {
+        return emplace(value);
+    }
+
+    // Захватывает ячейку, конструируя запись на месте из аргументов
+    template<typename... Args>
+    int emplace(Args&&... args) {
+        int handle;
+        if (!free_list_.empty()) {
+            handle = free_list_.back();
+            free_list_.pop_back();
+            slots_[handle].value = T(std::forward<Args>(args)...);
+            slots_[handle].live = true;
+        } else {
+            if (slots_.size() == slots_.capacity()) {
+                reserve(slots_.empty() ? 64 : 2 * slots_.capacity());
+            }
+            handle = static_cast<int>(slots_.size());
+            slots_.push_back(Slot{T(std::forward<Args>(args)...), true});
+        }
+        live_count_++;
+        return handle;
+    }
+
+    // Возвращает ячейку в список свободных
+    void release(int handle) {
+        if (!contains(handle)) {
+            throw std::out_of_range("Неверный дескриптор записи");
+        }
+        slots_[handle].live = false;
+        // Место под дескриптор зарезервировано вместе с ячейками в reserve()
+        free_list_.push_back(handle);
+        live_count_--;
+    }
+
+    bool contains(int handle) const {
+        return handle >= 0 && static_cast<size_t>(handle) < slots_.size() && slots_[handle].live;
+    }
+
+    T& operator[](int handle) { return slots_[handle].value; }
+    const T& operator[](int handle) const { return slots_[handle].value; }
+
+    // Сбрасывает содержимое, сохраняя выделенную память
+    void clear() {
+        slots_.clear();
+        free_list_.clear();
+        live_count_ = 0;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity > slots_.capacity()) {
+            allocations_++;
+            slots_.reserve(capacity);
+            free_list_.reserve(capacity);
+        }
+    }
+
+    // Дескрипторы и порядок списка свободных ячеек сохраняются точно:
+    // ссылки на записи из событий и очередей остаются верными
+    void save(Serialization::Writer& out) const {
+        out.write_vector(slots_);
+        out.write_vector(free_list_);
+    }
+
+    void load(Serialization::Reader& in) {
+        std::vector<Slot> slots;
+        std::vector<int> free_list;
+        in.read_vector(slots);
+        in.read_vector(free_list);
+        reserve(slots.size());
+        slots_.assign(slots.begin(), slots.end());
+        free_list_.assign(free_list.begin(), free_list.end());
+        live_count_ = 0;
+        for (const Slot& slot : slots_) {
+            if (slot.live) live_count_++;
+        }
+    }
+
+    size_t size() const { return live_count_; }
+    bool empty() const { return live_count_ == 0; }
+    size_t capacity() const { return slots_.capacity(); }
+    size_t allocations() const { return allocations_; }
+
+    // Обход живых записей в порядке дескрипторов: f(дескриптор, запись)
+    template<typename F>
+    void for_each(F f) {
+        for (size_t handle = 0; handle < slots_.size(); ++handle) {
+            if (slots_[handle].live) f(static_cast<int>(handle), slots_[handle].value);
+        }
+    }
+};
+
+} // namespace JobTables
+
+#endif // JOB_TABLE_H
@@ -0,0 +1,392 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+// Сборка без профилирования: -DSIMULATOR_PROFILING=0
+#ifndef SIMULATOR_PROFILING
+#define SIMULATOR_PROFILING 1
+#endif
+
+namespace Profiling {
+
+// Профилирующие экземпляры цикла событий существуют только при ENABLED
+constexpr bool ENABLED = SIMULATOR_PROFILING != 0;
+
+// Фазы обработки события
+enum Phase {
+    EVENT_SET,       // вставка и извлечение событий
+    RNG,             // выборка случайных величин
+    QUEUE,           // операции дисциплины очереди
+    STATISTICS,      // интегрирование и накопление статистики
+    PHASE_COUNT
+};
+
+inline const char* phase_name(int phase) {
+    switch (phase) {
+        case EVENT_SET: return "event_set";
+        case RNG: return "rng";
+        case QUEUE: return "queue";
+        case STATISTICS: return "statistics";
+    }
+    return "unknown";
+}
+
+// Счётчик тактов: rdtsc на x86 (единицы переводятся в нс по стене прогона),
+// иначе steady_clock в наносекундах
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * Аппаратные счётчики perf_event (такты, промахи кэша, ошибки предсказания
+ * переходов) одной группой для текущего потока, только пользовательский
+ * режим. Если ядро не разрешает perf_event_open, available() = false и
+ * счётчики не читаются.
+ */
+class HardwareCounters {
+public:
+    enum Counter { CYCLES, CACHE_MISSES, BRANCH_MISSES, COUNTER_COUNT };
+
+private:
+    int fds_[COUNTER_COUNT];
+    uint64_t start_[COUNTER_COUNT];
+    bool available_;
+
+#ifdef __linux__
+    static int open_counter(uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+
+    uint64_t read_counter(int counter) const {
+        uint64_t value = 0;
+        if (::read(fds_[counter], &value, sizeof(value)) != sizeof(value)) return 0;
+        return value;
+    }
+#endif
+
+public:
+    HardwareCounters() : fds_{-1, -1, -1}, start_{0, 0, 0}, available_(false) {
+#ifdef __linux__
+        const uint64_t configs[COUNTER_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            fds_[i] = open_counter(configs[i], i == 0 ? -1 : fds_[0]);
+            if (fds_[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        available_ = true;
+#endif
+    }
+
+    ~HardwareCounters() { close_all(); }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    bool available() const { return available_; }
+
+    void start() {
+#ifdef __linux__
+        if (!available_) return;
+        for (int i = 0; i < COUNTER_COUNT; ++i) start_[i] = read_counter(i);
+#endif
+    }
+
+    // Приращения с последнего start()
+    void stop(uint64_t (&delta)[COUNTER_COUNT]) {
+        for (int i = 0; i < COUNTER_COUNT; ++i) delta[i] = 0;
+#ifdef __linux__
+        if (!available_) return;
+        for (int i = 0; i < COUNTER_COUNT; ++i) delta[i] = read_counter(i) - start_[i];
+#endif
+    }
+
+private:
+    void close_all() {
+#ifdef __linux__
+        for (int i = COUNTER_COUNT - 1; i >= 0; --i) {
+            if (fds_[i] >= 0) ::close(fds_[i]);
+            fds_[i] = -1;
+        }
+#endif
+        available_ = false;
+    }
+};
+
+/**
+ * Профиль цикла событий: время по типам событий и фазам, пиковые размеры
+ * множества событий и очереди, выделения памяти и аппаратные счётчики
+ *
+ * Время копится в тактах ticks() и переводится в наносекунды по отношению
+ * длительности прогонов по стене к числу тактов за них. Замеры сами стоят
+ * времени (rdtsc под гипервизором - десятки нс), поэтому при создании
+ * профиля калибруется цена чтения счётчика и цена одного замера; доли фаз
+ * и нс на событие очищены от неё, а wall_time_ns() - фактическое время
+ * профилируемых прогонов. Профиль накапливается по всем интервалам advance
+ * (resume() продолжает его) до reset().
+ */
+class Profile {
+public:
+    static constexpr int EVENT_TYPES = 2;    // прибытие, уход
+
+private:
+    uint64_t type_events_[EVENT_TYPES];
+    uint64_t type_ticks_[EVENT_TYPES];
+    uint64_t phase_ticks_[PHASE_COUNT];
+    uint64_t phase_calls_[PHASE_COUNT];
+    size_t peak_event_set_;
+    size_t peak_queue_;
+    size_t allocations_;
+    uint64_t hardware_[HardwareCounters::COUNTER_COUNT];
+    HardwareCounters counters_;
+
+    // Текущий интервал
+    uint64_t interval_ticks_;
+    std::chrono::steady_clock::time_point interval_start_;
+    size_t interval_allocations_;
+
+    uint64_t total_ticks_;
+    double wall_ns_;
+    int intervals_;
+
+    // Калибровка: чтение счётчика (вычитается из каждого замера) и полный замер
+    uint64_t read_cost_;
+    double probe_cost_;
+
+    void calibrate() {
+        constexpr int SAMPLES = 4096;
+        read_cost_ = 0;
+        uint64_t best = ~uint64_t(0);
+        for (int i = 0; i < 256; ++i) {
+            uint64_t a = ticks();
+            uint64_t b = ticks();
+            best = std::min(best, b - a);
+        }
+        read_cost_ = best;
+        uint64_t start = ticks();
+        for (int i = 0; i < SAMPLES; ++i) {
+            uint64_t t = ticks();
+            add_phase(static_cast<Phase>(i % PHASE_COUNT), ticks() - t);
+        }
+        probe_cost_ = static_cast<double>(ticks() - start) / SAMPLES;
+    }
+
+    uint64_t probes() const {
+        uint64_t total = events();
+        for (int i = 0; i < PHASE_COUNT; ++i) total += phase_calls_[i];
+        return total;
+    }
+
+    // Такты прогонов за вычетом цены замеров
+    double corrected_ticks() const {
+        double phases = 0.0;
+        for (int i = 0; i < PHASE_COUNT; ++i) phases += static_cast<double>(phase_ticks_[i]);
+        return std::max(static_cast<double>(total_ticks_) - probes() * probe_cost_, phases);
+    }
+
+public:
+    Profile() : counters_() {
+        calibrate();
+        reset();
+    }
+
+    void reset() {
+        std::fill(type_events_, type_events_ + EVENT_TYPES, 0);
+        std::fill(type_ticks_, type_ticks_ + EVENT_TYPES, 0);
+        std::fill(phase_ticks_, phase_ticks_ + PHASE_COUNT, 0);
+        std::fill(phase_calls_, phase_calls_ + PHASE_COUNT, 0);
+        std::fill(hardware_, hardware_ + HardwareCounters::COUNTER_COUNT, 0);
+        peak_event_set_ = 0;
+        peak_queue_ = 0;
+        allocations_ = 0;
+        interval_ticks_ = 0;
+        interval_allocations_ = 0;
+        total_ticks_ = 0;
+        wall_ns_ = 0.0;
+        intervals_ = 0;
+    }
+
+    // Начало и конец интервала цикла событий; allocations - текущий счётчик
+    // выделений памяти наблюдаемых структур
+    void begin(size_t allocations) {
+        interval_allocations_ = allocations;
+        counters_.start();
+        interval_start_ = std::chrono::steady_clock::now();
+        interval_ticks_ = ticks();
+    }
+
+    void end(size_t allocations) {
+        uint64_t elapsed = ticks() - interval_ticks_;
+        auto wall = std::chrono::steady_clock::now() - interval_start_;
+        uint64_t delta[HardwareCounters::COUNTER_COUNT];
+        counters_.stop(delta);
+        for (int i = 0; i < HardwareCounters::COUNTER_COUNT; ++i) hardware_[i] += delta[i];
+        total_ticks_ += elapsed;
+        wall_ns_ += std::chrono::duration<double, std::nano>(wall).count();
+        allocations_ += allocations - interval_allocations_;
+        intervals_++;
+    }
+
+    void add_event(int type, uint64_t elapsed) {
+        type_events_[type]++;
+        type_ticks_[type] += elapsed;
+    }
+
+    void add_phase(Phase phase, uint64_t elapsed) {
+        phase_ticks_[phase] += elapsed > read_cost_ ? elapsed - read_cost_ : 0;
+        phase_calls_[phase]++;
+    }
+
+    void observe_event_set(size_t size) { peak_event_set_ = std::max(peak_event_set_, size); }
+    void observe_queue(size_t size) { peak_queue_ = std::max(peak_queue_, size); }
+
+    // ============= РЕЗУЛЬТАТЫ =============
+
+    uint64_t events() const {
+        uint64_t total = 0;
+        for (int i = 0; i < EVENT_TYPES; ++i) total += type_events_[i];
+        return total;
+    }
+    uint64_t events(int type) const { return type_events_[type]; }
+    double wall_time_ns() const { return wall_ns_; }
+    int intervals() const { return intervals_; }
+    double probe_cost_ns() const { return probe_cost_ * ns_per_tick(); }
+
+    double ns_per_tick() const { return total_ticks_ > 0 ? wall_ns_ / total_ticks_ : 0.0; }
+
+    // Оценки для цикла без замеров
+    double ns_per_event() const { return events() > 0 ? corrected_ticks() * ns_per_tick() / events() : 0.0; }
+    double events_per_second() const {
+        double ns = ns_per_event();
+        return ns > 0.0 ? 1e9 / ns : 0.0;
+    }
+    // Замеры внутри события снимаются пропорционально его доле тактов
+    double ns_per_event(int type) const {
+        if (type_events_[type] == 0 || total_ticks_ == 0) return 0.0;
+        double scale = corrected_ticks() / total_ticks_;
+        return type_ticks_[type] * scale * ns_per_tick() / type_events_[type];
+    }
+
+    double phase_ns(Phase phase) const { return phase_ticks_[phase] * ns_per_tick(); }
+    uint64_t phase_calls(Phase phase) const { return phase_calls_[phase]; }
+    // Доля времени цикла в фазе
+    double phase_share(Phase phase) const {
+        double total = corrected_ticks();
+        return total > 0.0 ? phase_ticks_[phase] / total : 0.0;
+    }
+    // Доля вне замеряемых фаз: таблица заданий, ядра, ветвления цикла
+    double other_share() const {
+        double accounted = 0.0;
+        for (int i = 0; i < PHASE_COUNT; ++i) accounted += phase_share(static_cast<Phase>(i));
+        return std::max(0.0, 1.0 - accounted);
+    }
+
+    size_t peak_event_set() const { return peak_event_set_; }
+    size_t peak_queue() const { return peak_queue_; }
+    size_t allocations() const { return allocations_; }
+
+    bool hardware_available() const { return counters_.available(); }
+    uint64_t hardware(HardwareCounters::Counter counter) const { return hardware_[counter]; }
+
+    void write_json(std::ostream& out, const char* type_names[EVENT_TYPES]) const {
+        auto flags = out.flags();
+        auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+        out << "{\n";
+        out << "  \"events\": " << events() << ",\n";
+        out << "  \"wall_time_ns\": " << wall_ns_ << ",\n";
+        out << "  \"probe_cost_ns\": " << probe_cost_ns() << ",\n";
+        out << "  \"events_per_second\": " << events_per_second() << ",\n";
+        out << "  \"ns_per_event\": " << ns_per_event() << ",\n";
+        out << "  \"event_types\": {";
+        for (int i = 0; i < EVENT_TYPES; ++i) {
+            out << (i ? ",\n" : "\n") << "    \"" << type_names[i] << "\": {\"events\": " << type_events_[i]
+                << ", \"ns_per_event\": " << ns_per_event(i) << "}";
+        }
+        out << "\n  },\n";
+        out << "  \"phases\": {";
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            Phase phase = static_cast<Phase>(i);
+            out << (i ? ",\n" : "\n") << "    \"" << phase_name(i) << "\": {\"calls\": " << phase_calls_[i]
+                << ", \"ns\": " << phase_ns(phase) << ", \"share\": " << phase_share(phase) << "}";
+        }
+        out << ",\n    \"other\": {\"share\": " << other_share() << "}";
+        out << "\n  },\n";
+        out << "  \"peak_event_set_size\": " << peak_event_set_ << ",\n";
+        out << "  \"peak_queue_size\": " << peak_queue_ << ",\n";
+        out << "  \"allocations\": " << allocations_ << ",\n";
+        out << "  \"hardware_counters\": ";
+        if (counters_.available()) {
+            out << "{\"cycles\": " << hardware_[HardwareCounters::CYCLES]
+                << ", \"cache_misses\": " << hardware_[HardwareCounters::CACHE_MISSES]
+                << ", \"branch_misses\": " << hardware_[HardwareCounters::BRANCH_MISSES] << "}\n";
+        } else {
+            out << "null\n";
+        }
+        out << "}\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+/**
+ * Замер фазы в области видимости. ScopedPhase<false> пуст: в
+ * непрофилирующих экземплярах цикла замеры исчезают при компиляции.
+ */
+template<bool Enabled>
+class ScopedPhase {
+public:
+    ScopedPhase(Profile*, Phase) {}
+};
+
+template<>
+class ScopedPhase<true> {
+private:
+    Profile* profile_;
+    Phase phase_;
+    uint64_t start_;
+
+public:
+    ScopedPhase(Profile* profile, Phase phase) : profile_(profile), phase_(phase), start_(ticks()) {}
+    ~ScopedPhase() { profile_->add_phase(phase_, ticks() - start_); }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+};
+
+} // namespace Profiling
+
+#endif // PROFILER_H
@@ -3,45 +3,141 @@
 
 #include <stdexcept>
 #include <vector>
-#include <queue>
 #include <memory>
 #include <random>
 #include <algorithm>
 #include <string>
+#include <sstream>
+#include <cstdint>
+#include <type_traits>
+#include "serialization.h"
 
 namespace QueueDisciplines {
 
-// Базовый класс для дисциплины очереди
+// Сериализация содержимого очередей: элементы пишутся побайтно
+template<typename T>
+void write_items(Serialization::Writer& out, const std::vector<T>& items) {
+    static_assert(std::is_trivially_copyable<T>::value, "Элементы очереди должны быть тривиально копируемыми");
+    out.write_vector(items);
+}
+
+/**
+ * Кольцевой буфер с ёмкостью - степенью двойки
+ *
+ * Основа FIFO и ROUND_ROBIN: вставка в конец и извлечение из начала за
+ * O(1) без выделений памяти после прогрева (ёмкость только растёт, clear()
+ * её сохраняет). Элементы перемещаются, а не копируются.
+ */
+template<typename T>
+class RingBuffer {
+private:
+    std::vector<T> slots_;
+    size_t head_;
+    size_t size_;
+    size_t mask_;
+
+    void grow() {
+        size_t capacity = slots_.empty() ? 16 : 2 * slots_.size();
+        std::vector<T> next(capacity);
+        for (size_t i = 0; i < size_; ++i) next[i] = std::move(slots_[(head_ + i) & mask_]);
+        slots_.swap(next);
+        head_ = 0;
+        mask_ = capacity - 1;
+    }
+
+public:
+    RingBuffer() : head_(0), size_(0), mask_(0) {}
+
+    void push_back(T item) {
+        if (size_ == slots_.size()) grow();
+        slots_[(head_ + size_) & mask_] = std::move(item);
+        size_++;
+    }
+
+    T pop_front() {
+        T item = std::move(slots_[head_]);
+        head_ = (head_ + 1) & mask_;
+        size_--;
+        return item;
+    }
+
+    const T& operator[](size_t i) const { return slots_[(head_ + i) & mask_]; }
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    void clear() { head_ = 0; size_ = 0; }
+
+    // Содержимое от начала к концу (контрольные точки)
+    std::vector<T> items() const {
+        std::vector<T> items;
+        items.reserve(size_);
+        for (size_t i = 0; i < size_; ++i) items.push_back((*this)[i]);
+        return items;
+    }
+
+    void assign(const std::vector<T>& items) {
+        clear();
+        for (const T& item : items) push_back(item);
+    }
+};
+
+/**
+ * Базовый класс для дисциплины очереди
+ *
+ * Симулятор хранит в очереди только дескрипторы заданий (T = int), сами
+ * записи остаются в таблице заданий. Элементы принимаются по значению
+ * и перемещаются внутрь, pop() перемещает элемент наружу.
+ */
 template<typename T>
 class QueueStrategy {
 public:
     virtual ~QueueStrategy() = default;
-    virtual void push(const T& item) = 0;
+    virtual void push(T item) = 0;
     virtual T pop() = 0;
+    
+    // Вставка с ключом упорядочения (меньше - раньше); дисциплины без ключа
+    // его не используют
+    virtual void push_keyed(T item, double key) {
+        (void)key;
+        push(std::move(item));
+    }
     virtual bool empty() const = 0;
     virtual size_t size() const = 0;
     virtual std::string name() const = 0;
+    
+    // Пустая очередь той же конфигурации (состояние генератора RANDOM копируется)
     virtual std::unique_ptr<QueueStrategy<T>> clone() const = 0;
+    
+    // Опустошает очередь за O(1), сохраняя выделенную память
+    virtual void clear() = 0;
+    
+    virtual void seed(uint64_t) {}   // для дисциплин со случайным выбором
+    
+    // Сохранение и восстановление содержимого (контрольные точки симулятора)
+    virtual void save(Serialization::Writer&) const {
+        throw std::logic_error("Дисциплина " + name() + " не поддерживает контрольные точки");
+    }
+    virtual void load(Serialization::Reader&) {
+        throw std::logic_error("Дисциплина " + name() + " не поддерживает контрольные точки");
+    }
 };
 
 // 1. FIFO (First-In-First-Out) - стандартная очередь
 template<typename T>
-class FIFOStrategy : public QueueStrategy<T> {
+class FIFOStrategy final : public QueueStrategy<T> {
 private:
-    std::queue<T> queue_;
+    RingBuffer<T> queue_;
     
 public:
-    void push(const T& item) override {
-        queue_.push(item);
+    void push(T item) override {
+        queue_.push_back(std::move(item));
     }
     
     T pop() override {
         if (queue_.empty()) {
             throw std::runtime_error("Queue is empty");
         }
-        T item = queue_.front();
-        queue_.pop();
-        return item;
+        return queue_.pop_front();
     }
     
     bool empty() const override {
@@ -57,29 +153,38 @@ public:
     }
     
     std::unique_ptr<QueueStrategy<T>> clone() const override {
-        auto clone = std::make_unique<FIFOStrategy<T>>();
-        // Клонирование очереди не тривиально, но для целей симуляции
-        // можно создать пустую копию
-        return clone;
+        return std::make_unique<FIFOStrategy<T>>();
+    }
+    
+    void clear() override { queue_.clear(); }
+    
+    void save(Serialization::Writer& out) const override {
+        write_items(out, queue_.items());
+    }
+    
+    void load(Serialization::Reader& in) override {
+        std::vector<T> items;
+        in.read_vector(items);
+        queue_.assign(items);
     }
 };
 
 // 2. LIFO (Last-In-First-Out) - стек
 template<typename T>
-class LIFOStrategy : public QueueStrategy<T> {
+class LIFOStrategy final : public QueueStrategy<T> {
 private:
     std::vector<T> stack_;
     
 public:
-    void push(const T& item) override {
-        stack_.push_back(item);
+    void push(T item) override {
+        stack_.push_back(std::move(item));
     }
     
     T pop() override {
         if (stack_.empty()) {
             throw std::runtime_error("Stack is empty");
         }
-        T item = stack_.back();
+        T item = std::move(stack_.back());
         stack_.pop_back();
         return item;
     }
@@ -99,20 +204,35 @@ public:
     std::unique_ptr<QueueStrategy<T>> clone() const override {
         return std::make_unique<LIFOStrategy<T>>();
     }
+    
+    void clear() override { stack_.clear(); }
+    
+    void save(Serialization::Writer& out) const override {
+        write_items(out, stack_);
+    }
+    
+    void load(Serialization::Reader& in) override {
+        in.read_vector(stack_);
+    }
 };
 
-// 3. Random - случайный выбор
+// 3. Random - случайный выбор: извлечение за O(1) заменой на последний
 template<typename T>
-class RandomStrategy : public QueueStrategy<T> {
+class RandomStrategy final : public QueueStrategy<T> {
 private:
     std::vector<T> items_;
     mutable std::mt19937 rng_;
     
 public:
     RandomStrategy() : rng_(std::random_device{}()) {}
+    explicit RandomStrategy(uint64_t seed) : rng_(static_cast<std::mt19937::result_type>(seed)) {}
+    
+    void seed(uint64_t seed) override {
+        rng_.seed(static_cast<std::mt19937::result_type>(seed));
+    }
     
-    void push(const T& item) override {
-        items_.push_back(item);
+    void push(T item) override {
+        items_.push_back(std::move(item));
     }
     
     T pop() override {
@@ -122,10 +242,10 @@ public:
         
         std::uniform_int_distribution<size_t> dist(0, items_.size() - 1);
         size_t idx = dist(rng_);
-        T item = items_[idx];
+        T item = std::move(items_[idx]);
         
         // Удаляем выбранный элемент
-        items_[idx] = std::move(items_.back());
+        if (idx + 1 != items_.size()) items_[idx] = std::move(items_.back());
         items_.pop_back();
         
         return item;
@@ -144,50 +264,115 @@ public:
     }
     
     std::unique_ptr<QueueStrategy<T>> clone() const override {
-        return std::make_unique<RandomStrategy<T>>();
+        auto clone = std::make_unique<RandomStrategy<T>>();
+        clone->rng_ = rng_;
+        return clone;
+    }
+    
+    void clear() override { items_.clear(); }
+    
+    void save(Serialization::Writer& out) const override {
+        write_items(out, items_);
+        std::ostringstream engine;
+        engine << rng_;
+        out.write_string(engine.str());
+    }
+    
+    void load(Serialization::Reader& in) override {
+        in.read_vector(items_);
+        std::istringstream engine(in.read_string());
+        engine >> rng_;
+        if (!engine) {
+            throw std::runtime_error("Контрольная точка повреждена: состояние RANDOM");
+        }
     }
 };
 
-// 4. Priority - по приоритету (меньший приоритет = выше в очереди)
+/**
+ * 4. Priority - по приоритету (меньший приоритет = выше в очереди)
+ *
+ * Приоритет задаёт вызывающий через push_keyed(); push() без ключа ставит
+ * элемент с нулевым приоритетом. 4-арная куча узлов (приоритет, номер
+ * вставки, элемент): просеивание перемещает эти узлы, а не задания. Равные
+ * приоритеты выдаются в порядке вставки, поэтому порядок не зависит от
+ * арности и расположения кучи.
+ */
 template<typename T>
-class PriorityStrategy : public QueueStrategy<T> {
+class PriorityStrategy final : public QueueStrategy<T> {
 private:
-    struct PriorityItem {
+    static constexpr size_t ARITY = 4;
+    
+    struct Node {
+        double priority;
+        uint64_t seq;
         T item;
-        int priority;
-        
-        bool operator>(const PriorityItem& other) const {
-            return priority > other.priority; // Меньший приоритет выше
-        }
     };
     
-    std::priority_queue<PriorityItem, 
-                       std::vector<PriorityItem>,
-                       std::greater<PriorityItem>> queue_;
+    std::vector<Node> heap_;
+    uint64_t next_seq_;
+    
+    static bool before(const Node& a, const Node& b) {
+        return a.priority < b.priority || (a.priority == b.priority && a.seq < b.seq);
+    }
+    
+    // Просеивание «дыркой»: узел записывается один раз на своё место
+    void sift_up(size_t pos, Node node) {
+        while (pos > 0) {
+            size_t parent = (pos - 1) / ARITY;
+            if (!before(node, heap_[parent])) break;
+            heap_[pos] = std::move(heap_[parent]);
+            pos = parent;
+        }
+        heap_[pos] = std::move(node);
+    }
+    
+    void sift_down(size_t pos, Node node) {
+        const size_t n = heap_.size();
+        while (true) {
+            size_t first = pos * ARITY + 1;
+            if (first >= n) break;
+            size_t last = std::min(first + ARITY, n);
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (before(heap_[child], heap_[best])) best = child;
+            }
+            if (!before(heap_[best], node)) break;
+            heap_[pos] = std::move(heap_[best]);
+            pos = best;
+        }
+        heap_[pos] = std::move(node);
+    }
     
 public:
-    void push(const T& item) override {
-        // Для упрощения: приоритет = время прибытия или случайное число
-        // В реальности нужен способ определить приоритет
-        PriorityItem pitem{item, static_cast<int>(queue_.size())};
-        queue_.push(pitem);
+    PriorityStrategy() : next_seq_(0) {}
+    
+    void push(T item) override {
+        push_keyed(std::move(item), 0.0);
+    }
+    
+    void push_keyed(T item, double priority) override {
+        Node node{priority, next_seq_++, std::move(item)};
+        heap_.emplace_back();
+        sift_up(heap_.size() - 1, std::move(node));
     }
     
     T pop() override {
-        if (queue_.empty()) {
+        if (heap_.empty()) {
             throw std::runtime_error("Priority queue is empty");
         }
-        T item = queue_.top().item;
-        queue_.pop();
+        T item = std::move(heap_.front().item);
+        Node last = std::move(heap_.back());
+        heap_.pop_back();
+        if (!heap_.empty()) sift_down(0, std::move(last));
         return item;
     }
     
     bool empty() const override {
-        return queue_.empty();
+        return heap_.empty();
     }
     
     size_t size() const override {
-        return queue_.size();
+        return heap_.size();
     }
     
     std::string name() const override {
@@ -197,28 +382,45 @@ public:
     std::unique_ptr<QueueStrategy<T>> clone() const override {
         return std::make_unique<PriorityStrategy<T>>();
     }
+    
+    void clear() override {
+        heap_.clear();
+        next_seq_ = 0;
+    }
+    
+    void save(Serialization::Writer& out) const override {
+        write_items(out, heap_);
+        out.write(next_seq_);
+    }
+    
+    void load(Serialization::Reader& in) override {
+        in.read_vector(heap_);
+        in.read(next_seq_);
+    }
 };
 
 // 5. Round Robin - циклическое обслуживание
 // Для нескольких ядер - более сложная реализация
 template<typename T>
-class RoundRobinStrategy : public QueueStrategy<T> {
+class RoundRobinStrategy final : public QueueStrategy<T> {
 private:
-    std::vector<std::queue<T>> queues_;
+    std::vector<RingBuffer<T>> queues_;
     size_t current_queue_;
+    size_t total_;                 // общая длина: size() и empty() за O(1)
     
 public:
     RoundRobinStrategy(size_t num_queues = 1) 
-        : queues_(num_queues), current_queue_(0) {
+        : queues_(num_queues), current_queue_(0), total_(0) {
         if (num_queues == 0) {
             throw std::invalid_argument("Number of queues must be positive");
         }
     }
     
-    void push(const T& item) override {
+    void push(T item) override {
         // Распределяем по очередям циклически
-        queues_[current_queue_].push(item);
+        queues_[current_queue_].push_back(std::move(item));
         current_queue_ = (current_queue_ + 1) % queues_.size();
+        total_++;
     }
     
     T pop() override {
@@ -226,28 +428,20 @@ public:
         for (size_t i = 0; i < queues_.size(); ++i) {
             size_t idx = (current_queue_ + i) % queues_.size();
             if (!queues_[idx].empty()) {
-                T item = queues_[idx].front();
-                queues_[idx].pop();
                 current_queue_ = (idx + 1) % queues_.size();
-                return item;
+                total_--;
+                return queues_[idx].pop_front();
             }
         }
         throw std::runtime_error("All queues are empty");
     }
     
     bool empty() const override {
-        for (const auto& q : queues_) {
-            if (!q.empty()) return false;
-        }
-        return true;
+        return total_ == 0;
     }
     
     size_t size() const override {
-        size_t total = 0;
-        for (const auto& q : queues_) {
-            total += q.size();
-        }
-        return total;
+        return total_;
     }
     
     std::string name() const override {
@@ -257,19 +451,48 @@ public:
     std::unique_ptr<QueueStrategy<T>> clone() const override {
         return std::make_unique<RoundRobinStrategy<T>>(queues_.size());
     }
+    
+    void clear() override {
+        for (auto& q : queues_) q.clear();
+        current_queue_ = 0;
+        total_ = 0;
+    }
+    
+    void save(Serialization::Writer& out) const override {
+        out.write<uint64_t>(queues_.size());
+        out.write<uint64_t>(current_queue_);
+        for (const auto& q : queues_) write_items(out, q.items());
+    }
+    
+    void load(Serialization::Reader& in) override {
+        if (in.read<uint64_t>() != queues_.size()) {
+            throw std::invalid_argument("Контрольная точка несовместима: другое число очередей ROUND_ROBIN");
+        }
+        current_queue_ = static_cast<size_t>(in.read<uint64_t>());
+        total_ = 0;
+        for (auto& q : queues_) {
+            std::vector<T> items;
+            in.read_vector(items);
+            q.assign(items);
+            total_ += q.size();
+        }
+    }
+};
+
+// Дисциплины очереди (общий тип для всех элементов)
+enum class QueueType {
+    FIFO,
+    LIFO,
+    RANDOM,
+    PRIORITY,
+    ROUND_ROBIN
 };
 
 // Фабрика для создания стратегий
 template<typename T>
 class QueueStrategyFactory {
 public:
-    enum class Type {
-        FIFO,
-        LIFO,
-        RANDOM,
-        PRIORITY,
-        ROUND_ROBIN
-    };
+    using Type = QueueType;
     
     static std::unique_ptr<QueueStrategy<T>> create(Type type, 
                                                    size_t round_robin_queues = 1) {
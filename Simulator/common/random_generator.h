@@ -6,6 +6,11 @@
 #include <cmath>
 #include <string>
 #include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include "simd_random.h"
+#include "serialization.h"
 
 /**
  * Абстрактный базовый класс генератора случайных чисел
@@ -20,6 +25,43 @@ public:
     virtual double variance() const = 0;     // дисперсия
     virtual std::string name() const = 0;    // название распределения
     virtual std::unique_ptr<RandomGenerator> clone() const = 0;
+    virtual void seed(uint64_t seed) = 0;    // детерминированная инициализация потока
+    
+    // Антитетический поток: значения из отражённых равномерных 1 - U при том же
+    // зерне (см. Xoshiro256x4::set_antithetic); сбрасывает блок предвыборки
+    virtual void set_antithetic(bool) {
+        throw std::logic_error("Генератор " + name() + " не поддерживает антитетические потоки");
+    }
+    
+    /**
+     * Вклад значения x в функцию вклада (score) по интенсивности r = 1 / mean()
+     * при масштабировании распределения: d/dr ln f_r(x), где X = Y / r.
+     * Нужен для оценок отношения правдоподобия (Sensitivity); распределения,
+     * носитель которых зависит от r (равномерное, детерминированное), его не имеют.
+     */
+    virtual bool supports_rate_score() const { return false; }
+    virtual double rate_score(double) const {
+        throw std::logic_error("Генератор " + name() + " не поддерживает отношение правдоподобия");
+    }
+    
+    // Точная нижняя граница значений (lookahead для консервативного PDES)
+    virtual double min_value() const { return 0.0; }
+    
+    // Следующие n значений потока; эквивалентно n вызовам generate()
+    virtual void generate_batch(double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = generate();
+        }
+    }
+    
+    // Сохранение и восстановление позиции в потоке (контрольные точки симулятора);
+    // параметры распределения не сохраняются - они задаются конструктором
+    virtual void save_state(Serialization::Writer&) const {
+        throw std::logic_error("Генератор " + name() + " не поддерживает контрольные точки");
+    }
+    virtual void load_state(Serialization::Reader&) {
+        throw std::logic_error("Генератор " + name() + " не поддерживает контрольные точки");
+    }
 };
 
 // ==================== КОНКРЕТНЫЕ РАСПРЕДЕЛЕНИЯ ====================
@@ -28,24 +70,57 @@ public:
  * Экспоненциальное распределение (поток Пуассона)
  * A(x) = 1 - exp(-λx)
  */
-class ExponentialGenerator : public RandomGenerator {
+class ExponentialGenerator final : public RandomGenerator {
 private:
     double lambda_;
-    std::mt19937_64 generator_;
-    std::exponential_distribution<double> distribution_;
+    SimdRandom::Xoshiro256x4 engine_;
+    SimdRandom::BlockStream stream_;
+    
+    auto filler() {
+        return [this](double* out, size_t n) { SimdRandom::fill_exponential(engine_, out, n, lambda_); };
+    }
     
 public:
     ExponentialGenerator(double lambda) 
-        : lambda_(lambda), distribution_(lambda) {
+        : lambda_(lambda) {
         if (lambda <= 0) {
             throw std::invalid_argument("Параметр λ должен быть положительным");
         }
         std::random_device rd;
-        generator_.seed(rd());
+        engine_.seed((static_cast<uint64_t>(rd()) << 32) | rd());
+    }
+    
+    ExponentialGenerator(double lambda, uint64_t seed)
+        : ExponentialGenerator(lambda) {
+        engine_.seed(seed);
     }
     
     double generate() override {
-        return distribution_(generator_);
+        return stream_.next(filler());
+    }
+    
+    void generate_batch(double* out, size_t n) override {
+        stream_.take(out, n, filler());
+    }
+    
+    void seed(uint64_t seed) override {
+        engine_.seed(seed);
+        stream_.reset();
+    }
+    
+    void set_antithetic(bool enabled) override {
+        engine_.set_antithetic(enabled);
+        stream_.reset();
+    }
+    
+    void save_state(Serialization::Writer& out) const override {
+        out.write(engine_);
+        out.write(stream_);
+    }
+    
+    void load_state(Serialization::Reader& in) override {
+        in.read(engine_);
+        in.read(stream_);
     }
     
     double mean() const override {
@@ -56,38 +131,73 @@ public:
         return 1.0 / (lambda_ * lambda_);
     }
     
+    // d/dλ ln(λ e^{-λx})
+    bool supports_rate_score() const override { return true; }
+    double rate_score(double x) const override { return 1.0 / lambda_ - x; }
+    
     std::string name() const override {
         return "Exponential(λ=" + std::to_string(lambda_) + ")";
     }
     
     std::unique_ptr<RandomGenerator> clone() const override {
-        auto clone = std::make_unique<ExponentialGenerator>(lambda_);
-        clone->generator_ = generator_;
-        return clone;
+        return std::make_unique<ExponentialGenerator>(*this);
     }
 };
 
 /**
  * Равномерное распределение на отрезке [a, b]
  */
-class UniformGenerator : public RandomGenerator {
+class UniformGenerator final : public RandomGenerator {
 private:
     double a_, b_;
-    std::mt19937_64 generator_;
-    std::uniform_real_distribution<double> distribution_;
+    SimdRandom::Xoshiro256x4 engine_;
+    SimdRandom::BlockStream stream_;
+    
+    auto filler() {
+        return [this](double* out, size_t n) { SimdRandom::fill_uniform(engine_, out, n, a_, b_); };
+    }
     
 public:
     UniformGenerator(double a, double b) 
-        : a_(a), b_(b), distribution_(a, b) {
+        : a_(a), b_(b) {
         if (a >= b) {
             throw std::invalid_argument("a должен быть меньше b");
         }
         std::random_device rd;
-        generator_.seed(rd());
+        engine_.seed((static_cast<uint64_t>(rd()) << 32) | rd());
+    }
+    
+    UniformGenerator(double a, double b, uint64_t seed)
+        : UniformGenerator(a, b) {
+        engine_.seed(seed);
     }
     
     double generate() override {
-        return distribution_(generator_);
+        return stream_.next(filler());
+    }
+    
+    void generate_batch(double* out, size_t n) override {
+        stream_.take(out, n, filler());
+    }
+    
+    void seed(uint64_t seed) override {
+        engine_.seed(seed);
+        stream_.reset();
+    }
+    
+    void set_antithetic(bool enabled) override {
+        engine_.set_antithetic(enabled);
+        stream_.reset();
+    }
+    
+    void save_state(Serialization::Writer& out) const override {
+        out.write(engine_);
+        out.write(stream_);
+    }
+    
+    void load_state(Serialization::Reader& in) override {
+        in.read(engine_);
+        in.read(stream_);
     }
     
     double mean() const override {
@@ -98,21 +208,23 @@ public:
         return ((b_ - a_) * (b_ - a_)) / 12.0;
     }
     
+    double min_value() const override {
+        return std::max(a_, 0.0);
+    }
+    
     std::string name() const override {
         return "Uniform[" + std::to_string(a_) + "," + std::to_string(b_) + "]";
     }
     
     std::unique_ptr<RandomGenerator> clone() const override {
-        auto clone = std::make_unique<UniformGenerator>(a_, b_);
-        clone->generator_ = generator_;
-        return clone;
+        return std::make_unique<UniformGenerator>(*this);
     }
 };
 
 /**
  * Детерминированное (постоянное) распределение
  */
-class DeterministicGenerator : public RandomGenerator {
+class DeterministicGenerator final : public RandomGenerator {
 private:
     double value_;
     
@@ -123,6 +235,16 @@ public:
         return value_; 
     }
     
+    void generate_batch(double* out, size_t n) override {
+        std::fill(out, out + n, value_);
+    }
+    
+    void seed(uint64_t) override {}
+    void set_antithetic(bool) override {}
+    
+    void save_state(Serialization::Writer&) const override {}
+    void load_state(Serialization::Reader&) override {}
+    
     double mean() const override { 
         return value_; 
     }
@@ -131,6 +253,10 @@ public:
         return 0.0; 
     }
     
+    double min_value() const override {
+        return std::max(value_, 0.0);
+    }
+    
     std::string name() const override {
         return "Deterministic(" + std::to_string(value_) + ")";
     }
@@ -144,29 +270,59 @@ public:
  * Распределение Эрланга порядка k
  * Сумма k независимых экспоненциальных величин
  */
-class ErlangGenerator : public RandomGenerator {
+class ErlangGenerator final : public RandomGenerator {
 private:
     int k_;
     double lambda_;
-    std::mt19937_64 generator_;
-    std::exponential_distribution<double> exp_dist_;
+    SimdRandom::Xoshiro256x4 engine_;
+    SimdRandom::BlockStream stream_;
+    
+    auto filler() {
+        return [this](double* out, size_t n) { SimdRandom::fill_erlang(engine_, out, n, k_, lambda_); };
+    }
     
 public:
     ErlangGenerator(int k, double lambda) 
-        : k_(k), lambda_(lambda), exp_dist_(lambda) {
+        : k_(k), lambda_(lambda) {
         if (k <= 0) throw std::invalid_argument("k должен быть положительным");
         if (lambda <= 0) throw std::invalid_argument("λ должен быть положительным");
         
         std::random_device rd;
-        generator_.seed(rd());
+        engine_.seed((static_cast<uint64_t>(rd()) << 32) | rd());
+    }
+    
+    ErlangGenerator(int k, double lambda, uint64_t seed)
+        : ErlangGenerator(k, lambda) {
+        engine_.seed(seed);
+    }
+    
+    void seed(uint64_t seed) override {
+        engine_.seed(seed);
+        stream_.reset();
+    }
+    
+    void set_antithetic(bool enabled) override {
+        engine_.set_antithetic(enabled);
+        stream_.reset();
+    }
+    
+    void save_state(Serialization::Writer& out) const override {
+        out.write(engine_);
+        out.write(stream_);
     }
     
+    void load_state(Serialization::Reader& in) override {
+        in.read(engine_);
+        in.read(stream_);
+    }
+    
+    // Один логарифм произведения k равномерных величин вместо k логарифмов
     double generate() override {
-        double sum = 0.0;
-        for (int i = 0; i < k_; i++) {
-            sum += exp_dist_(generator_);
-        }
-        return sum;
+        return stream_.next(filler());
+    }
+    
+    void generate_batch(double* out, size_t n) override {
+        stream_.take(out, n, filler());
     }
     
     double mean() const override {
@@ -177,22 +333,327 @@ public:
         return k_ / (lambda_ * lambda_);
     }
     
+    // r = λ/k: d/dr ln f = k/r - kx
+    bool supports_rate_score() const override { return true; }
+    double rate_score(double x) const override { return k_ * k_ / lambda_ - k_ * x; }
+    
     std::string name() const override {
         return "Erlang(k=" + std::to_string(k_) + ", λ=" + std::to_string(lambda_) + ")";
     }
     
     std::unique_ptr<RandomGenerator> clone() const override {
-        auto clone = std::make_unique<ErlangGenerator>(k_, lambda_);
-        clone->generator_ = generator_;
-        return clone;
+        return std::make_unique<ErlangGenerator>(*this);
     }
 };
 
+// ==================== НЕСТАЦИОНАРНЫЙ ПУАССОНОВСКИЙ ПОТОК ====================
+
+/**
+ * Периодическая таблица интенсивности λ(t) на узлах 0 = t0 < t1 < ... < tn = T
+ *
+ * Кусочно-постоянная: на [ti, ti+1) интенсивность rates[i] (n значений);
+ * кусочно-линейная: rates[i] - значение в узле ti, между узлами линейно
+ * (n + 1 значений). За T таблица повторяется - суточный или недельный цикл.
+ * Накопленная интенсивность Λ(ti) хранится по узлам, поэтому масса участка
+ * и обращение Λ внутри участка считаются за O(1).
+ */
+class RateTable {
+public:
+    enum class Shape { PIECEWISE_CONSTANT, PIECEWISE_LINEAR };
+
+private:
+    Shape shape_;
+    std::vector<double> times_;
+    std::vector<double> rates_;
+    std::vector<double> cumulative_;    // Λ(ti), Λ(t0) = 0
+
+    RateTable(Shape shape, std::vector<double> times, std::vector<double> rates)
+        : shape_(shape), times_(std::move(times)), rates_(std::move(rates)) {
+        size_t expected = shape == Shape::PIECEWISE_CONSTANT ? times_.size() - 1 : times_.size();
+        if (times_.size() < 2 || rates_.size() != expected) {
+            throw std::invalid_argument("Таблица интенсивности: несогласованные узлы и значения");
+        }
+        if (times_.front() != 0.0) {
+            throw std::invalid_argument("Таблица интенсивности должна начинаться с t = 0");
+        }
+        for (size_t i = 1; i < times_.size(); ++i) {
+            if (!(times_[i] > times_[i - 1])) {
+                throw std::invalid_argument("Узлы таблицы интенсивности должны строго возрастать");
+            }
+        }
+        for (double rate : rates_) {
+            if (!(rate >= 0.0) || !std::isfinite(rate)) {
+                throw std::invalid_argument("Интенсивность должна быть конечной и неотрицательной");
+            }
+        }
+        cumulative_.assign(times_.size(), 0.0);
+        for (size_t i = 0; i + 1 < times_.size(); ++i) {
+            cumulative_[i + 1] = cumulative_[i] + mass_to_end(i, times_[i]);
+        }
+        if (!(cumulative_.back() > 0.0)) {
+            throw std::invalid_argument("Интенсивность за период должна быть положительной");
+        }
+    }
+
+public:
+    static RateTable piecewise_constant(std::vector<double> times, std::vector<double> rates) {
+        return RateTable(Shape::PIECEWISE_CONSTANT, std::move(times), std::move(rates));
+    }
+
+    static RateTable piecewise_linear(std::vector<double> times, std::vector<double> rates) {
+        return RateTable(Shape::PIECEWISE_LINEAR, std::move(times), std::move(rates));
+    }
+
+    Shape shape() const { return shape_; }
+    size_t segments() const { return times_.size() - 1; }
+    double period() const { return times_.back(); }
+    double segment_start(size_t i) const { return times_[i]; }
+    double segment_end(size_t i) const { return times_[i + 1]; }
+    double period_mass() const { return cumulative_.back(); }
+    double mean_rate() const { return period_mass() / period(); }
+
+    double max_rate() const { return *std::max_element(rates_.begin(), rates_.end()); }
+
+    // Интенсивность на участке i в момент x периода
+    double rate_in(size_t i, double x) const {
+        if (shape_ == Shape::PIECEWISE_CONSTANT) return rates_[i];
+        return rates_[i] + slope(i) * (x - times_[i]);
+    }
+
+    double slope(size_t i) const {
+        if (shape_ == Shape::PIECEWISE_CONSTANT) return 0.0;
+        return (rates_[i + 1] - rates_[i]) / (times_[i + 1] - times_[i]);
+    }
+
+    // Участок, содержащий момент периода x ∈ [0, T)
+    size_t segment_of(double x) const {
+        size_t i = std::upper_bound(times_.begin(), times_.end(), x) - times_.begin();
+        return std::min(i == 0 ? 0 : i - 1, segments() - 1);
+    }
+
+    // λ(t) и Λ(t) для любого t >= 0 (с повторением периода)
+    double rate(double t) const {
+        double x = std::fmod(t, period());
+        return rate_in(segment_of(x), x);
+    }
+
+    double cumulative(double t) const {
+        double cycles = std::floor(t / period());
+        double x = t - cycles * period();
+        size_t i = segment_of(x);
+        return cycles * period_mass() + cumulative_[i] + (mass_to_end(i, times_[i]) - mass_to_end(i, x));
+    }
+
+    // ∫ λ от момента x участка i до его конца
+    double mass_to_end(size_t i, double x) const {
+        double length = times_[i + 1] - x;
+        if (shape_ == Shape::PIECEWISE_CONSTANT) return rates_[i] * length;
+        return 0.5 * (rate_in(i, x) + rates_[i + 1]) * length;
+    }
+
+    // Δ с ∫_x^{x+Δ} λ = mass на участке i (mass меньше массы до конца участка);
+    // корень квадратного уравнения в устойчивой форме 2m / (r + √(r² + 2sm))
+    double solve(size_t i, double x, double mass) const {
+        double r = rate_in(i, x);
+        if (shape_ == Shape::PIECEWISE_CONSTANT) return mass / r;
+        double discriminant = std::max(0.0, r * r + 2.0 * slope(i) * mass);
+        return 2.0 * mass / (r + std::sqrt(discriminant));
+    }
+};
+
+/**
+ * Нестационарный пуассоновский поток с периодической интенсивностью RateTable
+ *
+ * Интервалы - обращение накопленной интенсивности: следующее прибытие -
+ * момент, в который Λ вырастет на Exp(1). Участки проходятся вперёд от
+ * текущего, целые периоды пропускаются делением, поэтому стоимость
+ * прибытия - O(1) в среднем при любом числе участков: одна экспоненциальная
+ * величина и никаких отброшенных кандидатов, в отличие от прореживания с
+ * мажорантой λmax. Поток монотонен по
+ * равномерным, поэтому работают общие случайные числа и антитетические пары.
+ *
+ * Генератор помнит фазу - сумму выданных интервалов с последнего seed():
+ * интервалы нужно запрашивать по порядку с нулевого момента, как это делает
+ * Simulator после seed(). Повторный прогон начинается с нового seed().
+ */
+class NhppGenerator final : public RandomGenerator {
+private:
+    RateTable table_;
+    SimdRandom::Xoshiro256x4 engine_;
+    SimdRandom::BlockStream stream_;    // Exp(1) - приращения Λ
+    size_t segment_ = 0;
+    double phase_ = 0.0;                // момент внутри периода
+
+    auto filler() {
+        return [this](double* out, size_t n) { SimdRandom::fill_exponential(engine_, out, n, 1.0); };
+    }
+
+    double advance(double mass) {
+        double start = phase_;
+        double cycles = 0.0;
+        if (mass >= table_.period_mass()) {
+            double skip = std::floor(mass / table_.period_mass());
+            mass -= skip * table_.period_mass();
+            cycles += skip;
+        }
+        while (true) {
+            double rest = table_.mass_to_end(segment_, phase_);
+            if (mass < rest) {
+                phase_ = std::min(phase_ + table_.solve(segment_, phase_, mass), table_.segment_end(segment_));
+                break;
+            }
+            mass -= rest;
+            phase_ = table_.segment_end(segment_);
+            if (++segment_ == table_.segments()) {
+                segment_ = 0;
+                phase_ = 0.0;
+                cycles += 1.0;
+            }
+        }
+        return cycles * table_.period() + (phase_ - start);
+    }
+
+public:
+    explicit NhppGenerator(RateTable table) : table_(std::move(table)) {
+        std::random_device rd;
+        engine_.seed((static_cast<uint64_t>(rd()) << 32) | rd());
+    }
+
+    NhppGenerator(RateTable table, uint64_t seed) : NhppGenerator(std::move(table)) {
+        engine_.seed(seed);
+    }
+
+    double generate() override {
+        return advance(stream_.next(filler()));
+    }
+
+    void generate_batch(double* out, size_t n) override {
+        stream_.take(out, n, filler());
+        for (size_t i = 0; i < n; ++i) out[i] = advance(out[i]);
+    }
+
+    // Засев возвращает фазу к началу периода
+    void seed(uint64_t seed) override {
+        engine_.seed(seed);
+        stream_.reset();
+        segment_ = 0;
+        phase_ = 0.0;
+    }
+
+    void set_antithetic(bool enabled) override {
+        engine_.set_antithetic(enabled);
+        stream_.reset();
+    }
+
+    void save_state(Serialization::Writer& out) const override {
+        out.write(engine_);
+        out.write(stream_);
+        out.write(segment_);
+        out.write(phase_);
+    }
+
+    void load_state(Serialization::Reader& in) override {
+        in.read(engine_);
+        in.read(stream_);
+        in.read(segment_);
+        in.read(phase_);
+    }
+
+    // Долгосрочные моменты - как у пуассоновского потока со средней интенсивностью
+    double mean() const override {
+        return 1.0 / table_.mean_rate();
+    }
+
+    double variance() const override {
+        return mean() * mean();
+    }
+
+    std::string name() const override {
+        std::string shape = table_.shape() == RateTable::Shape::PIECEWISE_CONSTANT ? "const" : "linear";
+        return "NHPP(" + shape + ", участков=" + std::to_string(table_.segments()) +
+               ", T=" + std::to_string(table_.period()) + ", λ̄=" + std::to_string(table_.mean_rate()) +
+               ", λmax=" + std::to_string(table_.max_rate()) + ")";
+    }
+
+    std::unique_ptr<RandomGenerator> clone() const override {
+        return std::make_unique<NhppGenerator>(*this);
+    }
+
+    const RateTable& table() const { return table_; }
+
+    // Фаза потока: момент периода, до которого выданы интервалы
+    double phase() const { return phase_; }
+};
+
+/**
+ * Буфер предвыборки значений генератора
+ *
+ * Значения забираются пакетами через generate_batch(), поэтому горячий цикл
+ * не платит за виртуальный вызов и скалярный генератор на каждое событие.
+ * Генератор передаётся в next() с его точным типом: для final-классов вызов
+ * generate_batch() разрешается статически и встраивается.
+ * Последовательность значений та же, что и при вызовах generate(); после
+ * повторного засева генератора буфер нужно сбросить.
+ */
+class VariateBuffer {
+public:
+    static constexpr size_t CAPACITY = 64;
+
+private:
+    double values_[CAPACITY];
+    size_t pos_;
+
+public:
+    VariateBuffer() : pos_(CAPACITY) {}
+
+    template<typename Generator>
+    double next(Generator& generator) {
+        if (pos_ == CAPACITY) {
+            generator.generate_batch(values_, CAPACITY);
+            pos_ = 0;
+        }
+        return values_[pos_++];
+    }
+
+    void reset() { pos_ = CAPACITY; }
+    
+    void save_state(Serialization::Writer& out) const { out.write(*this); }
+    void load_state(Serialization::Reader& in) { in.read(*this); }
+};
+
 /**
  * Фабрика для создания генераторов
+ *
+ * Перегрузки с параметром seed дают воспроизводимые потоки; зерна для
+ * репликаций и отдельных потоков внутри репликации выводятся из
+ * (главное зерно, номер репликации, номер потока) функцией derive_seed().
  */
 class GeneratorFactory {
 public:
+    // Перемешивание SplitMix64 (Steele, Lea, Flood, 2014)
+    static uint64_t splitmix64(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+    
+    // Номера потоков внутри репликации: прибытия и обслуживание читают
+    // отдельные потоки, поэтому при общих случайных числах j-е задание во
+    // всех конфигурациях получает один и тот же интервал и одну и ту же
+    // работу, сколько бы значений ни потребляли другие источники
+    static constexpr uint64_t ARRIVAL_STREAM = 0;
+    static constexpr uint64_t SERVICE_STREAM = 1;
+    static constexpr uint64_t DISCIPLINE_STREAM = 2;
+    
+    // Зерно потока stream репликации index; разные тройки дают независимые зерна
+    static uint64_t derive_seed(uint64_t master_seed, uint64_t index, uint64_t stream = 0) {
+        uint64_t h = splitmix64(master_seed);
+        h = splitmix64(h ^ index);
+        return splitmix64(h ^ (stream * 0xD1B54A32D192ED03ULL));
+    }
+    
+
     static std::unique_ptr<RandomGenerator> create_exponential(double lambda) {
         return std::make_unique<ExponentialGenerator>(lambda);
     }
@@ -208,6 +669,26 @@ public:
     static std::unique_ptr<RandomGenerator> create_erlang(int k, double lambda) {
         return std::make_unique<ErlangGenerator>(k, lambda);
     }
+    
+    static std::unique_ptr<RandomGenerator> create_nhpp(RateTable table) {
+        return std::make_unique<NhppGenerator>(std::move(table));
+    }
+    
+    static std::unique_ptr<RandomGenerator> create_exponential(double lambda, uint64_t seed) {
+        return std::make_unique<ExponentialGenerator>(lambda, seed);
+    }
+    
+    static std::unique_ptr<RandomGenerator> create_uniform(double a, double b, uint64_t seed) {
+        return std::make_unique<UniformGenerator>(a, b, seed);
+    }
+    
+    static std::unique_ptr<RandomGenerator> create_erlang(int k, double lambda, uint64_t seed) {
+        return std::make_unique<ErlangGenerator>(k, lambda, seed);
+    }
+    
+    static std::unique_ptr<RandomGenerator> create_nhpp(RateTable table, uint64_t seed) {
+        return std::make_unique<NhppGenerator>(std::move(table), seed);
+    }
 };
 
 #endif // RANDOM_GENERATOR_H
\ No newline at end of file
@@ -0,0 +1,549 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include "serialization.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Results {
+
+/**
+ * Столбцовый файл результатов: одна строка на репликацию
+ *
+ * [FileHeader][схема: тип и имя каждого столбца] [пакет] [пакет] ...
+ * Пакет - [BatchHeader] и столбцы подряд: числа - массив из rows 8-байтных
+ * значений, строки - rows + 1 смещений uint32 и байты UTF-8 (как буферы
+ * записи Arrow). Каждый столбец выровнен на 8 байт. Файл только
+ * дописывается: оборванный при аварии последний пакет читатель пропускает,
+ * а Sink в режиме дозаписи отрезает его. Порядок байтов и представление
+ * чисел - платформенные, как у трасс и контрольных точек.
+ */
+constexpr uint32_t RESULTS_MAGIC = 0x544C5352;  // "RSLT"
+constexpr uint32_t BATCH_MAGIC = 0x48435442;    // "BTCH"
+constexpr uint32_t RESULTS_VERSION = 1;
+
+enum class Type : uint8_t {
+    FLOAT64 = 1,
+    INT64 = 2,
+    UINT64 = 3,
+    UTF8 = 4
+};
+
+inline const char* type_name(Type type) {
+    switch (type) {
+        case Type::FLOAT64: return "float64";
+        case Type::INT64: return "int64";
+        case Type::UINT64: return "uint64";
+        case Type::UTF8: return "utf8";
+    }
+    return "?";
+}
+
+struct Field {
+    std::string name;
+    Type type;
+
+    bool operator==(const Field& other) const { return name == other.name && type == other.type; }
+};
+
+using Schema = std::vector<Field>;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t columns;
+    uint32_t reserved;
+};
+
+struct BatchHeader {
+    uint32_t magic;
+    uint32_t columns;
+    uint64_t rows;
+    uint64_t bytes;        // длина столбцов после заголовка
+};
+
+namespace detail {
+
+inline void pad(Serialization::Writer& out, size_t size) {
+    static const uint8_t zeros[8] = {};
+    if (size % 8 != 0) out.write_bytes(zeros, 8 - size % 8);
+}
+
+inline size_t padded(size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+} // namespace detail
+
+// ==================== ПАКЕТ СТРОК ====================
+
+/**
+ * Строки в столбцовом виде. Значения строки добавляются put() по порядку
+ * столбцов схемы и закрываются end_row(); тип значения проверяется.
+ */
+class Batch {
+private:
+    struct Column {
+        std::vector<uint64_t> words;          // числовые столбцы
+        std::vector<uint32_t> offsets{0};     // UTF8: границы строк в bytes
+        std::string bytes;
+    };
+
+    const Schema* schema_;
+    std::vector<Column> columns_;
+    size_t rows_ = 0;
+    size_t cursor_ = 0;                       // следующий столбец текущей строки
+
+    Column& next(Type type) {
+        if (cursor_ >= columns_.size()) throw std::invalid_argument("Лишнее значение в строке результатов");
+        const Field& field = (*schema_)[cursor_];
+        if (field.type != type) {
+            throw std::invalid_argument("Столбец " + field.name + ": ожидался тип " + type_name(field.type) +
+                                        ", передан " + type_name(type));
+        }
+        return columns_[cursor_++];
+    }
+
+    template<typename T>
+    void put_word(Type type, T value) {
+        uint64_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        next(type).words.push_back(word);
+    }
+
+    template<typename T>
+    T word(size_t column, size_t row) const {
+        T value;
+        std::memcpy(&value, &columns_.at(column).words.at(row), sizeof(value));
+        return value;
+    }
+
+public:
+    explicit Batch(const Schema& schema) : schema_(&schema), columns_(schema.size()) {}
+
+    const Schema& schema() const { return *schema_; }
+    size_t rows() const { return rows_; }
+    bool empty() const { return rows_ == 0; }
+
+    void put(double value) { put_word(Type::FLOAT64, value); }
+    void put(std::string_view value) {
+        Column& c = next(Type::UTF8);
+        c.bytes.append(value.data(), value.size());
+        c.offsets.push_back(static_cast<uint32_t>(c.bytes.size()));
+    }
+    void put(const char* value) { put(std::string_view(value)); }
+    void put(const std::string& value) { put(std::string_view(value)); }
+
+    template<typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    void put(T value) {
+        if (std::is_signed<T>::value) {
+            put_word(Type::INT64, static_cast<int64_t>(value));
+        } else {
+            put_word(Type::UINT64, static_cast<uint64_t>(value));
+        }
+    }
+
+    void end_row() {
+        if (cursor_ != columns_.size()) {
+            throw std::invalid_argument("Строка результатов заполнена не полностью: " + std::to_string(cursor_) +
+                                        " из " + std::to_string(columns_.size()) + " столбцов");
+        }
+        cursor_ = 0;
+        rows_++;
+    }
+
+    double f64(size_t column, size_t row) const { return word<double>(column, row); }
+    int64_t i64(size_t column, size_t row) const { return word<int64_t>(column, row); }
+    uint64_t u64(size_t column, size_t row) const { return word<uint64_t>(column, row); }
+    std::string_view str(size_t column, size_t row) const {
+        const Column& c = columns_.at(column);
+        return std::string_view(c.bytes).substr(c.offsets.at(row), c.offsets.at(row + 1) - c.offsets.at(row));
+    }
+
+    // Значение ячейки текстом для CSV: double с 17 знаками, NaN - пустое поле
+    std::string text(size_t column, size_t row) const {
+        switch ((*schema_)[column].type) {
+            case Type::FLOAT64: {
+                double v = f64(column, row);
+                if (std::isnan(v)) return std::string();
+                char buffer[32];
+                std::snprintf(buffer, sizeof(buffer), "%.17g", v);
+                return buffer;
+            }
+            case Type::INT64: return std::to_string(i64(column, row));
+            case Type::UINT64: return std::to_string(u64(column, row));
+            case Type::UTF8: return std::string(str(column, row));
+        }
+        return std::string();
+    }
+
+    void write(Serialization::Writer& out) const {
+        if (cursor_ != 0) throw std::logic_error("Пакет результатов с незакрытой строкой");
+        uint64_t bytes = 0;
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            if ((*schema_)[c].type == Type::UTF8) {
+                bytes += detail::padded((rows_ + 1) * sizeof(uint32_t)) + detail::padded(columns_[c].bytes.size());
+            } else {
+                bytes += rows_ * sizeof(uint64_t);
+            }
+        }
+        out.write(BatchHeader{BATCH_MAGIC, static_cast<uint32_t>(columns_.size()), rows_, bytes});
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            const Column& column = columns_[c];
+            if ((*schema_)[c].type == Type::UTF8) {
+                out.write_bytes(column.offsets.data(), column.offsets.size() * sizeof(uint32_t));
+                detail::pad(out, column.offsets.size() * sizeof(uint32_t));
+                out.write_bytes(column.bytes.data(), column.bytes.size());
+                detail::pad(out, column.bytes.size());
+            } else {
+                out.write_bytes(column.words.data(), column.words.size() * sizeof(uint64_t));
+            }
+        }
+    }
+
+    // Столбцы пакета с заголовком header из payload (header.bytes байт)
+    void read(const BatchHeader& header, const std::vector<uint8_t>& payload) {
+        if (header.columns != columns_.size()) throw std::runtime_error("Пакет не соответствует схеме");
+        rows_ = header.rows;
+        cursor_ = 0;
+        Serialization::Reader in(payload);
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            Column& column = columns_[c];
+            if ((*schema_)[c].type == Type::UTF8) {
+                column.offsets.resize(rows_ + 1);
+                in.read_bytes(column.offsets.data(), column.offsets.size() * sizeof(uint32_t));
+                size_t skip = detail::padded(column.offsets.size() * sizeof(uint32_t)) -
+                              column.offsets.size() * sizeof(uint32_t);
+                uint8_t filler[8];
+                in.read_bytes(filler, skip);
+                if (column.offsets.front() != 0) throw std::runtime_error("Повреждён строковый столбец");
+                for (size_t r = 0; r < rows_; ++r) {
+                    if (column.offsets[r + 1] < column.offsets[r]) throw std::runtime_error("Повреждён строковый столбец");
+                }
+                column.bytes.resize(column.offsets.back());
+                in.read_bytes(column.bytes.data(), column.bytes.size());
+                in.read_bytes(filler, detail::padded(column.bytes.size()) - column.bytes.size());
+            } else {
+                column.words.resize(rows_);
+                in.read_bytes(column.words.data(), rows_ * sizeof(uint64_t));
+            }
+        }
+        if (!in.at_end()) throw std::runtime_error("Длина пакета не соответствует столбцам");
+    }
+
+    void clear() {
+        for (Column& c : columns_) {
+            c.words.clear();
+            c.offsets.assign(1, 0);
+            c.bytes.clear();
+        }
+        rows_ = 0;
+        cursor_ = 0;
+    }
+};
+
+// ==================== ЧТЕНИЕ ====================
+
+inline void write_header(std::ostream& out, const Schema& schema) {
+    Serialization::Writer header;
+    header.write(FileHeader{RESULTS_MAGIC, RESULTS_VERSION, static_cast<uint32_t>(schema.size()), 0});
+    for (const Field& field : schema) {
+        header.write(field.type);
+        header.write_string(field.name);
+    }
+    out.write(reinterpret_cast<const char*>(header.data().data()), static_cast<std::streamsize>(header.data().size()));
+}
+
+/**
+ * Последовательное чтение файла по пакетам; оборванный последний пакет
+ * (незавершённая запись) считается концом файла
+ */
+class Reader {
+private:
+    std::string path_;
+    std::ifstream in_;
+    Schema schema_;
+    std::streamoff valid_end_ = 0;     // конец последнего целого пакета
+
+    void fail(const std::string& what) const {
+        throw std::runtime_error("Файл результатов " + path_ + ": " + what);
+    }
+
+    template<typename T>
+    bool read_raw(T& value) {
+        return static_cast<bool>(in_.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+public:
+    explicit Reader(const std::string& path) : path_(path), in_(path, std::ios::binary) {
+        if (!in_) fail("не удалось открыть");
+        FileHeader header;
+        if (!read_raw(header)) fail("файл короче заголовка");
+        if (header.magic != RESULTS_MAGIC) fail("неверная сигнатура");
+        if (header.version != RESULTS_VERSION) fail("неподдерживаемая версия формата");
+        for (uint32_t c = 0; c < header.columns; ++c) {
+            Field field;
+            uint64_t length;
+            if (!read_raw(field.type) || !read_raw(length) || length > 4096) fail("повреждена схема");
+            field.name.resize(length);
+            if (!in_.read(field.name.data(), static_cast<std::streamsize>(length))) fail("повреждена схема");
+            schema_.push_back(std::move(field));
+        }
+        valid_end_ = in_.tellg();
+    }
+
+    const Schema& schema() const { return schema_; }
+    std::streamoff valid_end() const { return valid_end_; }
+
+    // Следующий пакет в batch (со схемой этого файла); false - конец файла
+    bool next(Batch& batch) {
+        BatchHeader header;
+        if (!read_raw(header)) return false;
+        if (header.magic != BATCH_MAGIC) fail("неверная сигнатура пакета");
+        std::vector<uint8_t> payload(header.bytes);
+        if (!in_.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()))) {
+            return false;
+        }
+        batch.read(header, payload);
+        valid_end_ = in_.tellg();
+        return true;
+    }
+};
+
+/**
+ * CSV для просмотра: заголовок из имён столбцов и строки всех пакетов
+ * @return число строк
+ */
+inline size_t export_csv(const std::string& input, const std::string& output) {
+    Reader reader(input);
+    std::ofstream out(output);
+    if (!out) throw std::runtime_error("Не удалось создать " + output);
+    const Schema& schema = reader.schema();
+    for (size_t c = 0; c < schema.size(); ++c) out << (c ? "," : "") << schema[c].name;
+    out << "\n";
+    Batch batch(schema);
+    size_t rows = 0;
+    while (reader.next(batch)) {
+        for (size_t r = 0; r < batch.rows(); ++r) {
+            for (size_t c = 0; c < schema.size(); ++c) out << (c ? "," : "") << batch.text(c, r);
+            out << "\n";
+        }
+        rows += batch.rows();
+    }
+    if (!out) throw std::runtime_error("Ошибка записи " + output);
+    return rows;
+}
+
+// ==================== ЗАПИСЬ ====================
+
+/**
+ * Приёмник результатов с фоновым потоком записи
+ *
+ * Потоки-производители копят строки в собственных пакетах (Producer) без
+ * блокировок; заполненный пакет передаётся в стек Трайбера (одна операция
+ * CAS), а поток записи забирает весь стек разом, восстанавливает порядок
+ * передачи и дописывает пакеты в файл. Строки разных производителей
+ * перемежаются в порядке готовности пакетов: ключ строки (например, точка
+ * и репликация) должен быть её столбцом.
+ *
+ * Все Producer должны быть уничтожены до close(). Ошибка записи
+ * сохраняется и выбрасывается из close(); деструктор её не сообщает.
+ */
+class Sink {
+public:
+    enum class Mode { CREATE, APPEND };
+
+private:
+    struct Node {
+        Batch batch;
+        Node* next;
+    };
+
+    Schema schema_;
+    size_t batch_rows_;
+    std::ofstream out_;
+    std::atomic<Node*> head_{nullptr};
+    std::atomic<bool> stopping_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::thread writer_;
+    std::exception_ptr failure_;       // только поток записи, читается после join
+    std::atomic<size_t> rows_{0};
+    std::atomic<size_t> batches_{0};
+    bool closed_ = false;
+
+    void write_all(Node* list) {
+        // Стек хранит пакеты от последнего к первому
+        Node* ordered = nullptr;
+        while (list) {
+            Node* next = list->next;
+            list->next = ordered;
+            ordered = list;
+            list = next;
+        }
+        while (ordered) {
+            Node* node = ordered;
+            ordered = ordered->next;
+            if (!failure_) {
+                try {
+                    Serialization::Writer bytes;
+                    node->batch.write(bytes);
+                    out_.write(reinterpret_cast<const char*>(bytes.data().data()),
+                               static_cast<std::streamsize>(bytes.data().size()));
+                    if (!out_) throw std::runtime_error("Ошибка записи файла результатов");
+                    rows_ += node->batch.rows();
+                    batches_++;
+                } catch (...) {
+                    failure_ = std::current_exception();
+                }
+            }
+            delete node;
+        }
+        if (!failure_) out_.flush();
+    }
+
+    void run() {
+        while (true) {
+            Node* list = head_.exchange(nullptr, std::memory_order_acquire);
+            if (list) {
+                write_all(list);
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire)) {
+                list = head_.exchange(nullptr, std::memory_order_acquire);
+                if (!list) break;
+                write_all(list);
+                continue;
+            }
+            // Пробуждение без замка у производителя может разминуться с ожиданием:
+            // тайм-аут ограничивает задержку записи
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(20));
+        }
+    }
+
+    void open(const std::string& path, Mode mode) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        if (mode == Mode::APPEND && fs::exists(path, ec) && fs::file_size(path, ec) > 0) {
+            std::streamoff end;
+            {
+                Reader existing(path);
+                if (existing.schema() != schema_) {
+                    throw std::invalid_argument("Файл результатов " + path + " записан с другой схемой");
+                }
+                Batch batch(existing.schema());
+                while (existing.next(batch)) {}
+                end = existing.valid_end();
+            }
+            fs::resize_file(path, static_cast<uintmax_t>(end));
+            out_.open(path, std::ios::binary | std::ios::app);
+        } else {
+            out_.open(path, std::ios::binary | std::ios::trunc);
+            if (out_) write_header(out_, schema_);
+        }
+        if (!out_) throw std::runtime_error("Не удалось открыть файл результатов " + path);
+        out_.flush();
+    }
+
+public:
+    /**
+     * @param batch_rows строк в пакете производителя до передачи потоку записи
+     * @param mode CREATE - новый файл, APPEND - дописать файл той же схемы
+     */
+    Sink(const std::string& path, Schema schema, size_t batch_rows = 1024, Mode mode = Mode::CREATE)
+        : schema_(std::move(schema)), batch_rows_(batch_rows) {
+        if (schema_.empty()) throw std::invalid_argument("Схема результатов пуста");
+        if (batch_rows_ == 0) throw std::invalid_argument("Размер пакета должен быть положительным");
+        open(path, mode);
+        writer_ = std::thread([this]() { run(); });
+    }
+
+    ~Sink() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+
+    const Schema& schema() const { return schema_; }
+    size_t batch_rows() const { return batch_rows_; }
+
+    // Передача пакета потоку записи без блокировок
+    void submit(Batch&& batch) {
+        Node* node = new Node{std::move(batch), head_.load(std::memory_order_relaxed)};
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+        wake_.notify_one();
+    }
+
+    // Дописывает всё переданное и останавливает поток записи
+    void close() {
+        if (closed_) return;
+        closed_ = true;
+        stopping_.store(true, std::memory_order_release);
+        wake_.notify_one();
+        writer_.join();
+        out_.close();
+        if (failure_) std::rethrow_exception(failure_);
+    }
+
+    size_t rows_written() const { return rows_; }
+    size_t batches_written() const { return batches_; }
+};
+
+/**
+ * Пакет строк одного потока-производителя; полный пакет уходит в Sink,
+ * остаток - при flush() и в деструкторе
+ */
+class Producer {
+private:
+    Sink* sink_;
+    Batch batch_;
+
+public:
+    explicit Producer(Sink& sink) : sink_(&sink), batch_(sink.schema()) {}
+    ~Producer() { flush(); }
+    Producer(const Producer&) = delete;
+    Producer& operator=(const Producer&) = delete;
+
+    template<typename T>
+    Producer& put(const T& value) {
+        batch_.put(value);
+        return *this;
+    }
+
+    void end_row() {
+        batch_.end_row();
+        if (batch_.rows() >= sink_->batch_rows()) flush();
+    }
+
+    void flush() {
+        if (batch_.empty()) return;
+        sink_->submit(std::move(batch_));
+        batch_ = Batch(sink_->schema());
+    }
+};
+
+} // namespace Results
+
+#endif // RESULTS_H
@@ -0,0 +1,299 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "common/random_generator.h"
+#include "common/serialization.h"
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Производные показателей по параметрам системы за один прогон
+ *
+ * Параметры - интенсивности λ = 1 / E[A] и μ = 1 / E[S]; их изменение
+ * понимается как масштаб: A = Y / λ, S = Y / μ при тех же Y, поэтому
+ * dA/dλ = -A/λ и dS/dμ = -S/μ для любого распределения.
+ *
+ * IPA (анализ бесконечно малых возмущений): производные моментов прихода,
+ * начала и конца обслуживания переносятся по траектории вместе с заданиями.
+ * Для FIFO G/G/c без потерь возмущение не меняет порядка событий почти
+ * наверное, и средние производных W и T состоятельны. При конечном буфере
+ * (потери разрывны по параметру) и других дисциплинах IPA смещена и не
+ * выдаётся.
+ *
+ * Отношение правдоподобия (LR) - запасной путь для любой дисциплины и
+ * буфера: регенерационная оценка по циклам, начинающимся приходом в пустую
+ * систему. W = E[R]/E[N] (R - сумма ожиданий цикла, N - число ушедших
+ * заданий), и производная равна (E[R·Σ] E[N] - E[R] E[N·Σ]) / E[N]², где
+ * Σ - сумма вкладов (RandomGenerator::rate_score) значений цикла. Нужны
+ * распределения с плотностью, гладкой по интенсивности: экспоненциальное,
+ * Эрланга; для остальных производная по их параметру LR не оценивается.
+ * Незавершённый последний цикл отбрасывается.
+ */
+namespace Sensitivity {
+
+enum Parameter { LAMBDA = 0, MU = 1 };
+constexpr size_t PARAMETERS = 2;
+
+// Производная по λ и по μ; NaN - оценки нет
+struct Derivative {
+    double d_lambda = std::numeric_limits<double>::quiet_NaN();
+    double d_mu = std::numeric_limits<double>::quiet_NaN();
+
+    double operator[](size_t parameter) const { return parameter == LAMBDA ? d_lambda : d_mu; }
+    double& operator[](size_t parameter) { return parameter == LAMBDA ? d_lambda : d_mu; }
+};
+
+struct Estimates {
+    Derivative wait_ipa;                // dW
+    Derivative system_ipa;              // dT
+    Derivative utilization_ipa;         // dU
+    Derivative wait_lr;
+    Derivative system_lr;
+    Derivative utilization_lr;
+    // U(c + 1) - U(c): при бесконечном буфере работа сохраняется, и загрузка
+    // обратно пропорциональна числу ядер; NaN при конечном буфере
+    double utilization_core_step = std::numeric_limits<double>::quiet_NaN();
+    bool ipa = false;                   // IPA применима к конфигурации
+    uint64_t jobs = 0;                  // ушедших заданий в оценке IPA
+    uint64_t cycles = 0;                // завершённых циклов регенерации в оценке LR
+};
+
+/**
+ * Накопитель производных; Simulator вызывает его из обработчиков событий
+ * (enable_sensitivity). Данные заданий - по дескрипторам таблицы заданий.
+ */
+class Tracker {
+private:
+    // Производные моментов задания по (λ, μ)
+    struct JobState {
+        double arrival[PARAMETERS];
+        double departure[PARAMETERS];
+        double wait[PARAMETERS];
+        double service;                 // dS/dμ
+    };
+
+    struct Cycle {
+        double start = 0.0;
+        double wait = 0.0;
+        double system = 0.0;
+        double busy = 0.0;             // работа заданий цикла
+        double jobs = 0.0;
+        double score[PARAMETERS] = {};
+    };
+
+    // Суммы по циклам: x и x·Σ для x ∈ {R_W, R_T, N, B, L}
+    struct CycleSums {
+        double wait = 0.0, system = 0.0, jobs = 0.0, busy = 0.0, length = 0.0;
+        double wait_score[PARAMETERS] = {};
+        double system_score[PARAMETERS] = {};
+        double jobs_score[PARAMETERS] = {};
+        double busy_score[PARAMETERS] = {};
+        double length_score[PARAMETERS] = {};
+        uint64_t cycles = 0;
+    };
+
+    // Суммы IPA по заданиям окна статистики
+    struct PathSums {
+        double wait[PARAMETERS] = {};
+        double system[PARAMETERS] = {};
+        uint64_t jobs = 0;
+        // Загрузка до последнего прихода: ΣS / (c (A_n - t0))
+        double work = 0.0;
+        double d_work[PARAMETERS] = {};
+        double window_start = 0.0;
+        double last_arrival = 0.0;
+        double d_last_arrival[PARAMETERS] = {};
+    };
+
+    const RandomGenerator* arrival_;
+    const RandomGenerator* service_;
+    double lambda_;
+    double mu_;
+    bool ipa_;
+    bool lr_[PARAMETERS];
+
+    std::vector<JobState> jobs_;
+    double clock_[PARAMETERS] = {};     // производные момента запланированного прихода
+    double departed_[PARAMETERS] = {};  // производные момента последнего ухода
+    Cycle cycle_;
+    bool cycle_open_ = false;
+    CycleSums cycle_sums_;
+    PathSums path_;
+
+    void close_cycle(double time) {
+        double length = time - cycle_.start;
+        cycle_sums_.wait += cycle_.wait;
+        cycle_sums_.system += cycle_.system;
+        cycle_sums_.jobs += cycle_.jobs;
+        cycle_sums_.busy += cycle_.busy;
+        cycle_sums_.length += length;
+        for (size_t p = 0; p < PARAMETERS; ++p) {
+            double score = cycle_.score[p];
+            cycle_sums_.wait_score[p] += cycle_.wait * score;
+            cycle_sums_.system_score[p] += cycle_.system * score;
+            cycle_sums_.jobs_score[p] += cycle_.jobs * score;
+            cycle_sums_.busy_score[p] += cycle_.busy * score;
+            cycle_sums_.length_score[p] += length * score;
+        }
+        cycle_sums_.cycles++;
+    }
+
+    // Регенерационная оценка производной отношения E[X] / E[Y]
+    static double ratio_derivative(double x, double x_score, double y, double y_score) {
+        return (x_score - x / y * y_score) / y;
+    }
+
+public:
+    Tracker(const RandomGenerator& arrival, const RandomGenerator& service)
+        : arrival_(&arrival), service_(&service),
+          lambda_(1.0 / arrival.mean()), mu_(1.0 / service.mean()), ipa_(false),
+          lr_{arrival.supports_rate_score(), service.supports_rate_score()} {}
+
+    // Начало прогона (Simulator::initialize); ipa - конфигурация допускает
+    // IPA (FIFO, бесконечный буфер)
+    void reset(bool ipa) {
+        ipa_ = ipa;
+        jobs_.clear();
+        for (size_t p = 0; p < PARAMETERS; ++p) clock_[p] = departed_[p] = 0.0;
+        cycle_ = Cycle();
+        cycle_open_ = false;
+        reset_statistics(0.0);
+    }
+
+    // Отброс накопленного (Simulator::reset_statistics): производные заданий
+    // в системе сохраняются, незавершённый цикл в оценку LR не входит
+    void reset_statistics(double time) {
+        cycle_sums_ = CycleSums();
+        cycle_open_ = false;
+        path_ = PathSums();
+        path_.window_start = time;
+        path_.last_arrival = time;
+    }
+
+    // Разыгран интервал до следующего прихода
+    void on_interarrival(double interval) {
+        clock_[LAMBDA] -= interval / lambda_;
+        if (cycle_open_ && lr_[LAMBDA]) cycle_.score[LAMBDA] += arrival_->rate_score(interval);
+    }
+
+    /**
+     * Приход задания handle с работой service; empty - система была пуста
+     * (начало цикла регенерации). Производные задания считаются как при
+     * немедленном начале обслуживания; для поставленного в очередь их
+     * уточняет on_start()
+     */
+    void on_arrival(int handle, double time, double service, bool empty, bool lost) {
+        if (empty) {
+            if (cycle_open_) close_cycle(time);
+            cycle_ = Cycle();
+            cycle_.start = time;
+            cycle_open_ = true;
+        }
+        path_.last_arrival = time;
+        for (size_t p = 0; p < PARAMETERS; ++p) path_.d_last_arrival[p] = clock_[p];
+        if (lost) return;
+
+        if (cycle_open_) {
+            cycle_.busy += service;
+            if (lr_[MU]) cycle_.score[MU] += service_->rate_score(service);
+        }
+        path_.work += service;
+        path_.d_work[MU] -= service / mu_;
+
+        if (static_cast<size_t>(handle) >= jobs_.size()) jobs_.resize(handle + 1);
+        JobState& job = jobs_[handle];
+        job.service = -service / mu_;
+        for (size_t p = 0; p < PARAMETERS; ++p) {
+            job.arrival[p] = clock_[p];
+            job.wait[p] = 0.0;
+            job.departure[p] = clock_[p] + (p == MU ? job.service : 0.0);
+        }
+    }
+
+    // Задание handle из очереди начало обслуживание при уходе предыдущего
+    void on_start(int handle) {
+        JobState& job = jobs_[handle];
+        for (size_t p = 0; p < PARAMETERS; ++p) {
+            job.wait[p] = departed_[p] - job.arrival[p];
+            job.departure[p] = departed_[p] + (p == MU ? job.service : 0.0);
+        }
+    }
+
+    void on_departure(int handle, double wait, double system) {
+        const JobState& job = jobs_[handle];
+        for (size_t p = 0; p < PARAMETERS; ++p) {
+            departed_[p] = job.departure[p];
+            path_.wait[p] += job.wait[p];
+            path_.system[p] += job.departure[p] - job.arrival[p];
+        }
+        path_.jobs++;
+        if (cycle_open_) {
+            cycle_.wait += wait;
+            cycle_.system += system;
+            cycle_.jobs += 1.0;
+        }
+    }
+
+    bool ipa() const { return ipa_; }
+    bool likelihood_ratio(Parameter parameter) const { return lr_[parameter]; }
+    uint64_t cycles() const { return cycle_sums_.cycles; }
+
+    Estimates estimates(int cores) const {
+        Estimates result;
+        result.ipa = ipa_;
+        result.jobs = path_.jobs;
+        result.cycles = cycle_sums_.cycles;
+
+        double horizon = path_.last_arrival - path_.window_start;
+        if (ipa_ && path_.jobs > 0 && horizon > 0.0) {
+            double n = static_cast<double>(path_.jobs);
+            double utilization = path_.work / (cores * horizon);
+            for (size_t p = 0; p < PARAMETERS; ++p) {
+                result.wait_ipa[p] = path_.wait[p] / n;
+                result.system_ipa[p] = path_.system[p] / n;
+                result.utilization_ipa[p] =
+                    (path_.d_work[p] / cores - utilization * path_.d_last_arrival[p]) / horizon;
+            }
+        }
+
+        const CycleSums& s = cycle_sums_;
+        if (s.cycles >= 2 && s.jobs > 0.0 && s.length > 0.0) {
+            for (size_t p = 0; p < PARAMETERS; ++p) {
+                if (!lr_[p]) continue;
+                result.wait_lr[p] = ratio_derivative(s.wait, s.wait_score[p], s.jobs, s.jobs_score[p]);
+                result.system_lr[p] = ratio_derivative(s.system, s.system_score[p], s.jobs, s.jobs_score[p]);
+                result.utilization_lr[p] =
+                    ratio_derivative(s.busy, s.busy_score[p], s.length, s.length_score[p]) / cores;
+            }
+        }
+        return result;
+    }
+
+    void save(Serialization::Writer& out) const {
+        out.write(ipa_);
+        out.write_vector(jobs_);
+        out.write(clock_);
+        out.write(departed_);
+        out.write(cycle_);
+        out.write(cycle_open_);
+        out.write(cycle_sums_);
+        out.write(path_);
+    }
+
+    void load(Serialization::Reader& in) {
+        in.read(ipa_);
+        in.read_vector(jobs_);
+        in.read(clock_);
+        in.read(departed_);
+        in.read(cycle_);
+        in.read(cycle_open_);
+        in.read(cycle_sums_);
+        in.read(path_);
+    }
+};
+
+} // namespace Sensitivity
+
+#endif // SENSITIVITY_H
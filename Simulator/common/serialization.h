@@ -0,0 +1,116 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace Serialization {
+
+/**
+ * Запись состояния в компактный двоичный блок
+ *
+ * Тривиально копируемые значения пишутся побайтно, векторы и строки -
+ * с длиной впереди. Формат привязан к платформе (порядок байтов, размеры
+ * типов): блок предназначен для восстановления той же сборкой программы.
+ */
+class Writer {
+private:
+    std::vector<uint8_t> bytes_;
+
+public:
+    void write_bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes_.insert(bytes_.end(), p, p + size);
+    }
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Тип должен быть тривиально копируемым");
+        write_bytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Тип должен быть тривиально копируемым");
+        write<uint64_t>(values.size());
+        if (!values.empty()) write_bytes(values.data(), values.size() * sizeof(T));
+    }
+
+    void write_string(const std::string& value) {
+        write<uint64_t>(value.size());
+        write_bytes(value.data(), value.size());
+    }
+
+    const std::vector<uint8_t>& data() const { return bytes_; }
+    std::vector<uint8_t> release() { return std::move(bytes_); }
+};
+
+/**
+ * Чтение блока, записанного Writer; выход за конец блока - исключение
+ */
+class Reader {
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+
+    void require(size_t size) const {
+        if (size > size_ - pos_) {
+            throw std::runtime_error("Контрольная точка повреждена: неожиданный конец данных");
+        }
+    }
+
+public:
+    Reader(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+    explicit Reader(const std::vector<uint8_t>& bytes) : Reader(bytes.data(), bytes.size()) {}
+
+    void read_bytes(void* out, size_t size) {
+        require(size);
+        if (size > 0) std::memcpy(out, data_ + pos_, size);
+        pos_ += size;
+    }
+
+    template<typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Тип должен быть тривиально копируемым");
+        read_bytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    T read() {
+        T value;
+        read(value);
+        return value;
+    }
+
+    template<typename T>
+    void read_vector(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Тип должен быть тривиально копируемым");
+        uint64_t count = read<uint64_t>();
+        if (count > (size_ - pos_) / sizeof(T)) {
+            throw std::runtime_error("Контрольная точка повреждена: неверная длина массива");
+        }
+        values.resize(count);
+        if (count > 0) read_bytes(values.data(), count * sizeof(T));
+    }
+
+    std::string read_string() {
+        uint64_t size = read<uint64_t>();
+        require(size);
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), size);
+        pos_ += size;
+        return value;
+    }
+
+    bool at_end() const { return pos_ == size_; }
+    size_t position() const { return pos_; }
+};
+
+} // namespace Serialization
+
+#endif // SERIALIZATION_H
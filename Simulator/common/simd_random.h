@@ -0,0 +1,239 @@
+#ifndef SIMD_RANDOM_H
+#define SIMD_RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * Векторные ядра генерации случайных величин
+ *
+ * Базовый генератор - четыре независимые дорожки xoshiro256++ (Blackman, Vigna),
+ * упакованные в векторы расширения GCC/Clang: компилятор отображает их на SSE2,
+ * а при сборке с -mavx2 - на 256-битные регистры. Логарифм вычисляется без
+ * ветвлений по схеме fdlibm, поэтому экспоненциальные величины и величины
+ * Эрланга генерируются по четыре за раз.
+ *
+ * Векторы передаются по ссылке: передача 32-байтных векторов по значению
+ * без -mavx меняет ABI, и GCC предупреждает об этом.
+ *
+ * Все ядра работают блоками по LANES значений: n должно быть кратно LANES.
+ * Значение номер i зависит только от позиции в потоке, поэтому заполнение
+ * одним большим блоком и несколькими малыми даёт одинаковую последовательность.
+ */
+namespace SimdRandom {
+
+constexpr size_t LANES = 4;
+
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+typedef int64_t i64x4 __attribute__((vector_size(32)));
+typedef double f64x4 __attribute__((vector_size(32)));
+
+inline void store(double* p, const f64x4& v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+/**
+ * Натуральный логарифм на месте для x ∈ (0, +inf) без денормалов, нулей и NaN
+ * (алгоритм __ieee754_log из fdlibm без ветвлений, ошибка не более 1 ulp)
+ */
+inline void log_inplace(f64x4& x) {
+    const double SQRT2 = 1.41421356237309504880;
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double LG1 = 6.666666666666735130e-01;
+    const double LG2 = 3.999999999940941908e-01;
+    const double LG3 = 2.857142874366239149e-01;
+    const double LG4 = 2.222219843214978396e-01;
+    const double LG5 = 1.818357216161805012e-01;
+    const double LG6 = 1.531383769920937332e-01;
+    const double LG7 = 1.479819860511658591e-01;
+
+    // x = 2^k * m, m ∈ [1, 2)
+    // (показатель переводится в double через мантиссу 2^52 - без скалярных преобразований)
+    const double TWO52 = 4503599627370496.0;
+    u64x4 bits = (u64x4)x;
+    f64x4 k = (f64x4)((bits >> 52) | 0x4330000000000000ULL) - (TWO52 + 1023.0);
+    f64x4 m = (f64x4)((bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+
+    // Приведение m к [sqrt(2)/2, sqrt(2))
+    i64x4 big = m > SQRT2;
+    m = big ? m * 0.5 : m;
+    k = big ? k + 1.0 : k;
+
+    f64x4 f = m - 1.0;
+    f64x4 s = f / (2.0 + f);
+    f64x4 z = s * s;
+    f64x4 w = z * z;
+    f64x4 t1 = w * (LG2 + w * (LG4 + w * LG6));
+    f64x4 t2 = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+    f64x4 r = t2 + t1;
+    f64x4 hfsq = 0.5 * f * f;
+    x = k * LN2_HI - ((hfsq - (s * (hfsq + r) + k * LN2_LO)) - f);
+}
+
+inline double log(double x) {
+    f64x4 v = {x, x, x, x};
+    log_inplace(v);
+    return v[0];
+}
+
+/**
+ * Четыре дорожки xoshiro256++ в структуре массивов
+ */
+class Xoshiro256x4 {
+private:
+    u64x4 s0_, s1_, s2_, s3_;
+    uint64_t mirror_ = 0;        // маска отражения мантиссы (антитетический поток)
+
+    static uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    explicit Xoshiro256x4(uint64_t seed = 1) { this->seed(seed); }
+
+    // Состояние всех дорожек разворачивается из одного зерна цепочкой SplitMix64
+    void seed(uint64_t seed) {
+        uint64_t state = seed;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            s0_[lane] = splitmix64(state);
+            s1_[lane] = splitmix64(state);
+            s2_[lane] = splitmix64(state);
+            s3_[lane] = splitmix64(state);
+        }
+    }
+
+    void next(u64x4& result) {
+        u64x4 sum = s0_ + s3_;
+        result = ((sum << 23) | (sum >> 41)) + s0_;
+        u64x4 t = s1_ << 17;
+        s2_ ^= s0_;
+        s3_ ^= s1_;
+        s1_ ^= s2_;
+        s0_ ^= s3_;
+        s2_ ^= t;
+        s3_ = (s3_ << 45) | (s3_ >> 19);
+    }
+
+    /**
+     * Антитетический поток: каждая равномерная величина u заменяется на
+     * зеркальную точку сетки 1 - 2^-52 - u (на (0, 1] - на 1 + 2^-52 - u), то
+     * есть тот же поток с тем же зерном, отражённый относительно 1/2. Режим не
+     * сбрасывается засевом, а отражение - одна операция XOR над мантиссой.
+     */
+    void set_antithetic(bool enabled) { mirror_ = enabled ? 0x000FFFFFFFFFFFFFULL : 0; }
+    bool antithetic() const { return mirror_ != 0; }
+
+    // Равномерные на [0, 1) с шагом 2^-52: старшие биты в мантиссу числа из [1, 2)
+    void next_uniform(f64x4& u) {
+        u64x4 bits;
+        next(bits);
+        u = (f64x4)(((bits >> 12) ^ mirror_) | 0x3FF0000000000000ULL) - 1.0;
+    }
+
+    // Равномерные на (0, 1] - безопасный аргумент логарифма
+    void next_open_uniform(f64x4& u) {
+        next_uniform(u);
+        u = 1.0 - u;
+    }
+};
+
+// ==================== ЯДРА РАСПРЕДЕЛЕНИЙ ====================
+
+inline void fill_uniform(Xoshiro256x4& rng, double* out, size_t n, double a, double b) {
+    const double width = b - a;
+    f64x4 u;
+    for (size_t i = 0; i < n; i += LANES) {
+        rng.next_uniform(u);
+        store(out + i, a + width * u);
+    }
+}
+
+inline void fill_exponential(Xoshiro256x4& rng, double* out, size_t n, double lambda) {
+    const double scale = -1.0 / lambda;
+    f64x4 u;
+    for (size_t i = 0; i < n; i += LANES) {
+        rng.next_open_uniform(u);
+        log_inplace(u);
+        store(out + i, scale * u);
+    }
+}
+
+/**
+ * Эрланг порядка k: -ln(u1 * ... * uk) / λ - один логарифм на значение.
+ * Произведение сворачивается в логарифм каждые 16 множителей, чтобы
+ * не уйти в денормалы (каждый множитель не меньше 2^-52).
+ */
+inline void fill_erlang(Xoshiro256x4& rng, double* out, size_t n, int k, double lambda) {
+    const int CHUNK = 16;
+    const double scale = -1.0 / lambda;
+    f64x4 u, product;
+    for (size_t i = 0; i < n; i += LANES) {
+        f64x4 sum = {0.0, 0.0, 0.0, 0.0};
+        for (int done = 0; done < k; done += CHUNK) {
+            int count = k - done < CHUNK ? k - done : CHUNK;
+            rng.next_open_uniform(product);
+            for (int j = 1; j < count; ++j) {
+                rng.next_open_uniform(u);
+                product *= u;
+            }
+            log_inplace(product);
+            sum += product;
+        }
+        store(out + i, scale * sum);
+    }
+}
+
+/**
+ * Блочный поток значений поверх векторного ядра
+ *
+ * Одиночные значения берутся из внутреннего блока, пакеты кратные BLOCK
+ * заполняются ядром прямо в выходной массив, поэтому generate() и
+ * generate_batch() читают один и тот же поток.
+ */
+class BlockStream {
+public:
+    static constexpr size_t BLOCK = 64;
+
+private:
+    double block_[BLOCK];
+    size_t pos_ = BLOCK;
+
+public:
+    template<typename Fill>
+    double next(Fill&& fill) {
+        if (pos_ == BLOCK) {
+            fill(block_, BLOCK);
+            pos_ = 0;
+        }
+        return block_[pos_++];
+    }
+
+    template<typename Fill>
+    void take(double* out, size_t n, Fill&& fill) {
+        while (n > 0 && pos_ < BLOCK) {
+            *out++ = block_[pos_++];
+            n--;
+        }
+        size_t bulk = n - n % BLOCK;
+        if (bulk > 0) {
+            fill(out, bulk);
+            out += bulk;
+            n -= bulk;
+        }
+        while (n > 0) {
+            *out++ = next(fill);
+            n--;
+        }
+    }
+
+    void reset() { pos_ = BLOCK; }
+};
+
+} // namespace SimdRandom
+
+#endif // SIMD_RANDOM_H
@@ -0,0 +1,846 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include "serialization.h"
+
+namespace Statistics {
+
+// Режим накопления выборочной статистики
+enum class SampleMode {
+    STREAMING,   // только потоковые накопители: O(1) памяти
+    EXACT        // дополнительно хранить все значения выборки
+};
+
+/**
+ * Потоковый накопитель: среднее и дисперсия по Уэлфорду, минимум, максимум
+ * Память O(1); два накопителя объединяются без потери точности (Chan et al.)
+ */
+class StreamingAccumulator {
+private:
+    uint64_t count_;
+    double mean_;
+    double m2_;          // сумма квадратов отклонений от среднего
+    double min_;
+    double max_;
+
+public:
+    StreamingAccumulator()
+        : count_(0), mean_(0.0), m2_(0.0),
+          min_(std::numeric_limits<double>::infinity()),
+          max_(-std::numeric_limits<double>::infinity()) {}
+
+    void add(double x) {
+        count_++;
+        double delta = x - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (x - mean_);
+        if (x < min_) min_ = x;
+        if (x > max_) max_ = x;
+    }
+
+    void merge(const StreamingAccumulator& other) {
+        if (other.count_ == 0) return;
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        uint64_t total = count_ + other.count_;
+        double delta = other.mean_ - mean_;
+        mean_ += delta * other.count_ / total;
+        m2_ += other.m2_ + delta * delta * (static_cast<double>(count_) * other.count_ / total);
+        count_ = total;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset() { *this = StreamingAccumulator(); }
+
+    uint64_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    double mean() const { return count_ > 0 ? mean_ : 0.0; }
+    double min() const { return count_ > 0 ? min_ : 0.0; }
+    double max() const { return count_ > 0 ? max_ : 0.0; }
+
+    // Несмещённая выборочная дисперсия
+    double variance() const {
+        return count_ > 1 ? m2_ / (count_ - 1) : 0.0;
+    }
+
+    double stddev() const { return std::sqrt(variance()); }
+};
+
+/**
+ * Логарифмическая гистограмма в духе HDR Histogram
+ *
+ * Диапазон [min_value, max_value] делится на октавы (степени двойки), каждая
+ * октава - на 2^precision_bits равных корзин, поэтому относительная ошибка
+ * квантиля не превышает 2^-precision_bits. Значения ниже min_value (в том
+ * числе нулевое ожидание) попадают в отдельную корзину и считаются нулём.
+ * Гистограммы с одинаковыми параметрами объединяются сложением счётчиков.
+ */
+class QuantileSketch {
+private:
+    double min_value_;
+    int octaves_;
+    int sub_buckets_;
+    std::vector<uint64_t> counts_;   // [0] - значения ниже min_value_
+    uint64_t total_;
+
+    size_t index_of(double x) const {
+        if (!(x >= min_value_)) return 0;
+        int exponent;
+        double fraction = std::frexp(x / min_value_, &exponent);  // [0.5, 1)
+        int octave = exponent - 1;
+        if (octave >= octaves_) return counts_.size() - 1;
+        int sub = static_cast<int>((fraction * 2.0 - 1.0) * sub_buckets_);
+        if (sub >= sub_buckets_) sub = sub_buckets_ - 1;
+        return 1 + static_cast<size_t>(octave) * sub_buckets_ + sub;
+    }
+
+    // Середина корзины - представитель её значений
+    double value_of(size_t index) const {
+        if (index == 0) return 0.0;
+        size_t octave = (index - 1) / sub_buckets_;
+        size_t sub = (index - 1) % sub_buckets_;
+        double lo = 1.0 + static_cast<double>(sub) / sub_buckets_;
+        double hi = 1.0 + static_cast<double>(sub + 1) / sub_buckets_;
+        return min_value_ * std::ldexp((lo + hi) / 2.0, static_cast<int>(octave));
+    }
+
+public:
+    explicit QuantileSketch(double min_value = 1e-6, double max_value = 1e9, int precision_bits = 7)
+        : min_value_(min_value), octaves_(0), sub_buckets_(1 << precision_bits), total_(0) {
+        if (min_value <= 0.0 || max_value <= min_value) {
+            throw std::invalid_argument("Неверный диапазон гистограммы");
+        }
+        if (precision_bits < 1 || precision_bits > 16) {
+            throw std::invalid_argument("Точность гистограммы должна быть от 1 до 16 бит");
+        }
+        octaves_ = static_cast<int>(std::ceil(std::log2(max_value / min_value)));
+        counts_.assign(1 + static_cast<size_t>(octaves_) * sub_buckets_, 0);
+    }
+
+    void add(double x) {
+        counts_[index_of(x)]++;
+        total_++;
+    }
+
+    void merge(const QuantileSketch& other) {
+        if (other.counts_.size() != counts_.size() || other.min_value_ != min_value_) {
+            throw std::invalid_argument("Объединяемые гистограммы имеют разные параметры");
+        }
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+    }
+
+    // Квантиль уровня p ∈ [0, 1]
+    double quantile(double p) const {
+        if (total_ == 0) return 0.0;
+        p = std::min(std::max(p, 0.0), 1.0);
+        uint64_t rank = static_cast<uint64_t>(std::ceil(p * total_));
+        if (rank == 0) rank = 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return value_of(i);
+        }
+        return value_of(counts_.size() - 1);
+    }
+
+    void save(Serialization::Writer& out) const {
+        out.write(min_value_);
+        out.write_vector(counts_);
+        out.write(total_);
+    }
+
+    void load(Serialization::Reader& in) {
+        std::vector<uint64_t> counts;
+        double min_value = in.read<double>();
+        in.read_vector(counts);
+        if (min_value != min_value_ || counts.size() != counts_.size()) {
+            throw std::invalid_argument("Контрольная точка несовместима: другие параметры гистограммы");
+        }
+        counts_ = std::move(counts);
+        in.read(total_);
+    }
+
+    uint64_t count() const { return total_; }
+    double relative_error() const { return 1.0 / sub_buckets_; }
+};
+
+/**
+ * Взвешенная по времени гистограмма целочисленного состояния
+ * (например, числа заданий в системе)
+ *
+ * add(n, dt) учитывает, что состояние n держалось в течение dt: O(1) на вызов.
+ * Состояния не меньше max_state собираются в последнюю корзину, поэтому память
+ * ограничена; среднее считается по точной площади и от усечения не зависит.
+ */
+class StateHistogram {
+private:
+    std::vector<double> time_in_state_;   // [max_state] - состояния >= max_state
+    double area_;                         // интеграл состояния по времени
+    double total_time_;
+
+public:
+    explicit StateHistogram(size_t max_state = 1024)
+        : time_in_state_(max_state + 1, 0.0), area_(0.0), total_time_(0.0) {
+        if (max_state == 0) {
+            throw std::invalid_argument("Гистограмма состояний должна иметь хотя бы одну корзину");
+        }
+    }
+
+    void add(size_t state, double duration) {
+        size_t index = state < time_in_state_.size() - 1 ? state : time_in_state_.size() - 1;
+        time_in_state_[index] += duration;
+        area_ += duration * static_cast<double>(state);
+        total_time_ += duration;
+    }
+
+    void merge(const StateHistogram& other) {
+        if (other.time_in_state_.size() != time_in_state_.size()) {
+            throw std::invalid_argument("Объединяемые гистограммы имеют разные параметры");
+        }
+        for (size_t i = 0; i < time_in_state_.size(); ++i) {
+            time_in_state_[i] += other.time_in_state_[i];
+        }
+        area_ += other.area_;
+        total_time_ += other.total_time_;
+    }
+
+    void reset() {
+        std::fill(time_in_state_.begin(), time_in_state_.end(), 0.0);
+        area_ = 0.0;
+        total_time_ = 0.0;
+    }
+
+    // Среднее по времени значение состояния
+    double mean() const { return total_time_ > 0.0 ? area_ / total_time_ : 0.0; }
+
+    // Доля времени в состоянии n (для n = max_state - в состояниях >= max_state)
+    double probability(size_t state) const {
+        if (total_time_ <= 0.0 || state >= time_in_state_.size()) return 0.0;
+        return time_in_state_[state] / total_time_;
+    }
+
+    std::vector<double> probabilities() const {
+        std::vector<double> result(time_in_state_.size(), 0.0);
+        for (size_t i = 0; i < result.size(); ++i) result[i] = probability(i);
+        return result;
+    }
+
+    // Наибольшее состояние с ненулевым временем (max_state, если было усечение)
+    size_t max_observed() const {
+        for (size_t i = time_in_state_.size(); i > 0; --i) {
+            if (time_in_state_[i - 1] > 0.0) return i - 1;
+        }
+        return 0;
+    }
+
+    void save(Serialization::Writer& out) const {
+        out.write_vector(time_in_state_);
+        out.write(area_);
+        out.write(total_time_);
+    }
+
+    void load(Serialization::Reader& in) {
+        std::vector<double> time_in_state;
+        in.read_vector(time_in_state);
+        if (time_in_state.size() != time_in_state_.size()) {
+            throw std::invalid_argument("Контрольная точка несовместима: другой размер гистограммы состояний");
+        }
+        time_in_state_ = std::move(time_in_state);
+        in.read(area_);
+        in.read(total_time_);
+    }
+
+    size_t max_state() const { return time_in_state_.size() - 1; }
+    double area() const { return area_; }
+    double total_time() const { return total_time_; }
+};
+
+/**
+ * Показатели по интервалам модельного времени ширины width
+ *
+ * Прибытия и потери относятся к интервалу момента прибытия, ожидание и
+ * пребывание - к интервалу прибытия ушедшего задания (W(t) заданий,
+ * пришедших в момент t), интегралы числа заданий и занятых ядер делятся по
+ * границам интервалов. При period > 0 время берётся по модулю периода, и
+ * один длинный прогон копит суточный (недельный) профиль по всем циклам
+ * в ceil(period / width) корзинах; иначе корзины добавляются по мере хода
+ * времени. Память - O(число корзин), выборки не хранятся.
+ */
+class IntervalStatistics {
+public:
+    struct Bin {
+        double exposure = 0.0;          // наблюдавшееся время в интервале
+        double jobs_area = 0.0;         // ∫ числа заданий в системе
+        double busy_area = 0.0;         // ∫ числа занятых ядер
+        uint64_t arrivals = 0;
+        uint64_t losses = 0;
+        StreamingAccumulator wait;
+        StreamingAccumulator system;
+    };
+
+private:
+    double width_;
+    double period_;
+    std::vector<Bin> bins_;
+
+    // Номер корзины и её правая граница (в абсолютном времени) для момента t
+    size_t locate(double t, double* end) const {
+        double base = 0.0;
+        double local = t;
+        if (period_ > 0.0) {
+            base = std::floor(t / period_) * period_;
+            local = t - base;
+        }
+        size_t k = static_cast<size_t>(local / width_);
+        if (period_ > 0.0) k = std::min(k, bins_.size() - 1);
+        if (end) {
+            double right = base + (k + 1) * width_;
+            if (period_ > 0.0 && k + 1 == bins_.size()) right = base + period_;
+            // Округление не должно оставить отрезок без продвижения
+            *end = right > t ? right : std::nextafter(t, std::numeric_limits<double>::infinity());
+        }
+        return k;
+    }
+
+    Bin& bin_at(double t, double* end = nullptr) {
+        size_t k = locate(t, end);
+        if (k >= bins_.size()) bins_.resize(k + 1);
+        return bins_[k];
+    }
+
+public:
+    explicit IntervalStatistics(double width, double period = 0.0) : width_(width), period_(period) {
+        if (!(width > 0.0) || !std::isfinite(width)) {
+            throw std::invalid_argument("Ширина интервала статистики должна быть положительной");
+        }
+        if (!(period >= 0.0) || !std::isfinite(period)) {
+            throw std::invalid_argument("Период статистики должен быть неотрицательным");
+        }
+        if (period > 0.0) bins_.resize(static_cast<size_t>(std::ceil(period / width)));
+    }
+
+    // Состояние (in_system, busy) держалось на [from, to)
+    void add_time(double from, double to, int in_system, int busy) {
+        while (from < to) {
+            double end;
+            Bin& bin = bin_at(from, &end);
+            double piece = std::min(to, end) - from;
+            bin.exposure += piece;
+            bin.jobs_area += piece * in_system;
+            bin.busy_area += piece * busy;
+            from = std::min(to, end);
+        }
+    }
+
+    void add_arrival(double time, bool lost) {
+        Bin& bin = bin_at(time);
+        bin.arrivals++;
+        if (lost) bin.losses++;
+    }
+
+    void add_departure(double arrival_time, double wait, double system) {
+        Bin& bin = bin_at(arrival_time);
+        bin.wait.add(wait);
+        bin.system.add(system);
+    }
+
+    void reset() {
+        if (period_ > 0.0) {
+            std::fill(bins_.begin(), bins_.end(), Bin());
+        } else {
+            bins_.clear();
+        }
+    }
+
+    double width() const { return width_; }
+    double period() const { return period_; }
+    size_t bins() const { return bins_.size(); }
+    const Bin& bin(size_t k) const { return bins_.at(k); }
+    double start(size_t k) const { return k * width_; }
+    double end(size_t k) const {
+        return period_ > 0.0 ? std::min((k + 1) * width_, period_) : (k + 1) * width_;
+    }
+
+    double arrival_rate(size_t k) const {
+        return bins_[k].exposure > 0.0 ? bins_[k].arrivals / bins_[k].exposure : 0.0;
+    }
+    double loss_probability(size_t k) const {
+        return bins_[k].arrivals > 0 ? static_cast<double>(bins_[k].losses) / bins_[k].arrivals : 0.0;
+    }
+    double avg_jobs_in_system(size_t k) const {
+        return bins_[k].exposure > 0.0 ? bins_[k].jobs_area / bins_[k].exposure : 0.0;
+    }
+    double avg_busy_cores(size_t k) const {
+        return bins_[k].exposure > 0.0 ? bins_[k].busy_area / bins_[k].exposure : 0.0;
+    }
+
+    void save(Serialization::Writer& out) const {
+        out.write(width_);
+        out.write(period_);
+        out.write_vector(bins_);
+    }
+
+    void load(Serialization::Reader& in) {
+        double width, period;
+        in.read(width);
+        in.read(period);
+        if (width != width_ || period != period_) {
+            throw std::invalid_argument("Контрольная точка несовместима: другие интервалы статистики");
+        }
+        in.read_vector(bins_);
+    }
+};
+
+// Точный квантиль выборки (ранговый, тот же критерий, что и у QuantileSketch)
+inline double exact_quantile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0.0;
+    p = std::min(std::max(p, 0.0), 1.0);
+    size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+    size_t idx = rank == 0 ? 0 : rank - 1;
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx];
+}
+
+// Квантиль стандартного нормального распределения (алгоритм Acklam, ошибка ~1e-9)
+inline double normal_quantile(double p) {
+    if (p <= 0.0 || p >= 1.0) {
+        throw std::invalid_argument("Уровень квантиля должен лежать в (0, 1)");
+    }
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double p_low = 0.02425;
+
+    if (p < p_low) {
+        double q = std::sqrt(-2.0 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - p_low) {
+        return -normal_quantile(1.0 - p);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+// Квантиль распределения Стьюдента с df степенями свободы
+// (точные формулы для df = 1, 2; разложение Корниша-Фишера для остальных)
+inline double student_t_quantile(double p, uint64_t df) {
+    if (df == 0) {
+        throw std::invalid_argument("Число степеней свободы должно быть положительным");
+    }
+    if (df == 1) return std::tan(M_PI * (p - 0.5));
+    if (df == 2) return (2.0 * p - 1.0) / std::sqrt(2.0 * p * (1.0 - p));
+
+    double z = normal_quantile(p);
+    double v = static_cast<double>(df);
+    double z2 = z * z;
+    double z3 = z2 * z, z5 = z3 * z2, z7 = z5 * z2, z9 = z7 * z2;
+    return z
+        + (z3 + z) / (4.0 * v)
+        + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * v * v)
+        + (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) / (384.0 * v * v * v)
+        + (79.0 * z9 + 776.0 * z7 + 1482.0 * z5 - 1920.0 * z3 - 945.0 * z) / (92160.0 * v * v * v * v);
+}
+
+/**
+ * Доверительный интервал для среднего по независимым наблюдениям
+ */
+struct ConfidenceInterval {
+    double mean;
+    double half_width;
+    double confidence;     // доверительная вероятность (например, 0.95)
+    uint64_t samples;
+
+    double lower() const { return mean - half_width; }
+    double upper() const { return mean + half_width; }
+
+    // Относительная полуширина (точность оценки)
+    double relative_half_width() const {
+        return mean != 0.0 ? half_width / std::abs(mean) : std::numeric_limits<double>::infinity();
+    }
+};
+
+inline ConfidenceInterval confidence_interval(const StreamingAccumulator& acc, double confidence = 0.95) {
+    ConfidenceInterval ci{acc.mean(), 0.0, confidence, acc.count()};
+    if (acc.count() < 2) {
+        ci.half_width = std::numeric_limits<double>::infinity();
+        return ci;
+    }
+    double t = student_t_quantile(0.5 + confidence / 2.0, acc.count() - 1);
+    ci.half_width = t * acc.stddev() / std::sqrt(static_cast<double>(acc.count()));
+    return ci;
+}
+
+/**
+ * Оценка среднего с управляющей переменной (control variate)
+ *
+ * Пары (y, c) накапливаются по Уэлфорду вместе с совместным моментом. При
+ * известном E[c] оценка ȳ - β(c̄ - E[c]) с β = Cov(y, c) / Var(c) несмещена
+ * асимптотически, а её дисперсия в 1 / (1 - r²) раз меньше дисперсии ȳ,
+ * где r - корреляция y и c. Интервал строится по остаточной дисперсии
+ * регрессии y на c (n - 2 степени свободы).
+ */
+class ControlVariateAccumulator {
+private:
+    uint64_t count_;
+    double mean_y_;
+    double mean_c_;
+    double m2_y_;
+    double m2_c_;
+    double co_moment_;   // сумма произведений отклонений y и c
+
+public:
+    ControlVariateAccumulator()
+        : count_(0), mean_y_(0.0), mean_c_(0.0), m2_y_(0.0), m2_c_(0.0), co_moment_(0.0) {}
+
+    void add(double y, double c) {
+        count_++;
+        double dy = y - mean_y_;
+        double dc = c - mean_c_;
+        mean_y_ += dy / count_;
+        mean_c_ += dc / count_;
+        m2_y_ += dy * (y - mean_y_);
+        m2_c_ += dc * (c - mean_c_);
+        co_moment_ += dy * (c - mean_c_);
+    }
+
+    // Объединение совместных моментов двух выборок (Chan et al.)
+    void merge(const ControlVariateAccumulator& other) {
+        if (other.count_ == 0) return;
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        double n = static_cast<double>(count_ + other.count_);
+        double weight = static_cast<double>(count_) * other.count_ / n;
+        double dy = other.mean_y_ - mean_y_;
+        double dc = other.mean_c_ - mean_c_;
+        mean_y_ += dy * other.count_ / n;
+        mean_c_ += dc * other.count_ / n;
+        m2_y_ += other.m2_y_ + dy * dy * weight;
+        m2_c_ += other.m2_c_ + dc * dc * weight;
+        co_moment_ += other.co_moment_ + dy * dc * weight;
+        count_ += other.count_;
+    }
+
+    void reset() { *this = ControlVariateAccumulator(); }
+
+    uint64_t count() const { return count_; }
+    double mean() const { return count_ > 0 ? mean_y_ : 0.0; }
+    double control_mean() const { return count_ > 0 ? mean_c_ : 0.0; }
+
+    // Коэффициент регрессии y на c
+    double beta() const { return m2_c_ > 0.0 ? co_moment_ / m2_c_ : 0.0; }
+
+    double correlation() const {
+        return m2_y_ > 0.0 && m2_c_ > 0.0 ? co_moment_ / std::sqrt(m2_y_ * m2_c_) : 0.0;
+    }
+
+    // Во сколько раз управляющая переменная уменьшает дисперсию оценки (1 / (1 - r²))
+    double variance_reduction() const {
+        double r = correlation();
+        return r * r < 1.0 ? 1.0 / (1.0 - r * r) : std::numeric_limits<double>::infinity();
+    }
+
+    ConfidenceInterval interval(double expected_control, double confidence = 0.95) const {
+        ConfidenceInterval ci{mean_y_ - beta() * (mean_c_ - expected_control), 0.0, confidence, count_};
+        if (count_ < 3) {
+            ci.half_width = std::numeric_limits<double>::infinity();
+            return ci;
+        }
+        double n = static_cast<double>(count_);
+        double residual = std::max(m2_y_ - beta() * co_moment_, 0.0) / (n - 2.0);
+        double shift = mean_c_ - expected_control;
+        double variance = residual * (1.0 / n + (m2_c_ > 0.0 ? shift * shift / m2_c_ : 0.0));
+        ci.half_width = student_t_quantile(0.5 + confidence / 2.0, count_ - 2) * std::sqrt(variance);
+        return ci;
+    }
+};
+
+/**
+ * Результат оценки с несколькими управляющими переменными
+ * variance_reduction - отношение оценённой дисперсии ȳ к дисперсии
+ * скорректированной оценки (рост квантиля Стьюдента из-за потерянных
+ * степеней свободы в него не входит)
+ */
+struct ControlledEstimate {
+    ConfidenceInterval interval;
+    std::vector<double> beta;          // коэффициенты по управляющим (0 - исключённые)
+    double variance_reduction;
+};
+
+/**
+ * Оценка среднего y по выборке с q управляющими переменными c_j, средние
+ * которых известны: ȳ - β'(c̄ - E[c]), где β - решение нормальных уравнений
+ * S_cc β = S_cy по центрированным суммам. Управляющие без разброса (например,
+ * выборочное среднее детерминированного обслуживания) исключаются. Интервал
+ * строится по остаточной дисперсии регрессии с n - q - 1 степенями свободы.
+ */
+inline ControlledEstimate controlled_estimate(const std::vector<double>& y,
+                                              const std::vector<std::vector<double>>& controls,
+                                              const std::vector<double>& expected,
+                                              double confidence = 0.95) {
+    const size_t n = y.size();
+    if (controls.size() != expected.size()) {
+        throw std::invalid_argument("Число управляющих переменных и их средних не совпадает");
+    }
+    for (const auto& c : controls) {
+        if (c.size() != n) throw std::invalid_argument("Длины выборок управляющих переменных не совпадают");
+    }
+
+    auto average = [n](const std::vector<double>& v) {
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        return n > 0 ? sum / n : 0.0;
+    };
+    auto co_sum = [n](const std::vector<double>& a, double ma, const std::vector<double>& b, double mb) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) sum += (a[i] - ma) * (b[i] - mb);
+        return sum;
+    };
+
+    double mean_y = average(y);
+    double s_yy = co_sum(y, mean_y, y, mean_y);
+    ControlledEstimate result{ConfidenceInterval{mean_y, std::numeric_limits<double>::infinity(), confidence, n},
+                              std::vector<double>(controls.size(), 0.0), 1.0};
+
+    // Управляющие с ненулевым разбросом
+    std::vector<size_t> active;
+    std::vector<double> means(controls.size());
+    for (size_t j = 0; j < controls.size(); ++j) {
+        means[j] = average(controls[j]);
+        double s_jj = co_sum(controls[j], means[j], controls[j], means[j]);
+        if (s_jj > 1e-20 * n * std::max(means[j] * means[j], 1e-300)) active.push_back(j);
+    }
+    const size_t q = active.size();
+    if (n < q + 2) return result;
+
+    // Обращение S_cc методом Гаусса-Жордана с выбором ведущего элемента
+    std::vector<std::vector<double>> a(q, std::vector<double>(2 * q, 0.0));
+    std::vector<double> s_cy(q);
+    for (size_t r = 0; r < q; ++r) {
+        for (size_t c = 0; c < q; ++c) {
+            a[r][c] = co_sum(controls[active[r]], means[active[r]], controls[active[c]], means[active[c]]);
+        }
+        a[r][q + r] = 1.0;
+        s_cy[r] = co_sum(controls[active[r]], means[active[r]], y, mean_y);
+    }
+    double scale = 0.0;
+    for (size_t r = 0; r < q; ++r) scale = std::max(scale, a[r][r]);
+    for (size_t col = 0; col < q; ++col) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < q; ++r) {
+            if (std::abs(a[r][col]) > std::abs(a[pivot][col])) pivot = r;
+        }
+        if (std::abs(a[pivot][col]) <= 1e-12 * scale) {
+            throw std::invalid_argument("Управляющие переменные линейно зависимы");
+        }
+        std::swap(a[col], a[pivot]);
+        double inv = 1.0 / a[col][col];
+        for (double& v : a[col]) v *= inv;
+        for (size_t r = 0; r < q; ++r) {
+            if (r == col || a[r][col] == 0.0) continue;
+            double f = a[r][col];
+            for (size_t c = 0; c < 2 * q; ++c) a[r][c] -= f * a[col][c];
+        }
+    }
+
+    double fitted = 0.0;          // β' S_cy
+    double correction = 0.0;      // β' (c̄ - E[c])
+    double leverage = 0.0;        // d' S_cc⁻¹ d
+    for (size_t r = 0; r < q; ++r) {
+        double beta = 0.0;
+        for (size_t c = 0; c < q; ++c) beta += a[r][q + c] * s_cy[c];
+        result.beta[active[r]] = beta;
+        fitted += beta * s_cy[r];
+        double d_r = means[active[r]] - expected[active[r]];
+        correction += beta * d_r;
+        for (size_t c = 0; c < q; ++c) {
+            leverage += d_r * a[r][q + c] * (means[active[c]] - expected[active[c]]);
+        }
+    }
+
+    double df = static_cast<double>(n - q - 1);
+    double residual = std::max(s_yy - fitted, 0.0) / df;
+    double variance = residual * (1.0 / n + leverage);
+    result.interval.mean = mean_y - correction;
+    result.interval.half_width = student_t_quantile(0.5 + confidence / 2.0, n - q - 1) * std::sqrt(variance);
+    double plain = s_yy / (n - 1) / n;
+    result.variance_reduction = variance > 0.0 ? plain / variance : std::numeric_limits<double>::infinity();
+    return result;
+}
+
+/**
+ * Онлайн-определение периода разгона по правилу MSER-5 (White, 1997)
+ *
+ * Наблюдения усредняются группами по 5. Для точки отсечения d (в группах)
+ * MSER(d) = Σ_{i>d} (Z_i - Z̄_d)^2 / (n - d)^2; разгоном считается префикс
+ * с наименьшим MSER(d) среди d <= n/2. Минимум на самой границе n/2 означает,
+ * что данных пока мало и отсечение ненадёжно. Число хранимых групп ограничено:
+ * при переполнении соседние группы попарно сливаются и размер группы
+ * удваивается (5, 10, 20, ...), поэтому память O(max_batches).
+ */
+class MserTruncation {
+public:
+    struct Result {
+        size_t truncated_batches;         // отброшено групп
+        uint64_t truncated_observations;  // отброшено наблюдений
+        bool reliable;                    // минимум найден внутри допустимой области
+        double mean;                      // среднее после отсечения
+    };
+
+private:
+    size_t base_batch_;
+    size_t batch_size_;
+    size_t max_batches_;
+    std::vector<double> batch_means_;
+    double partial_sum_;
+    size_t partial_count_;
+    uint64_t count_;
+
+    void compact() {
+        size_t half = batch_means_.size() / 2;
+        for (size_t i = 0; i < half; ++i) {
+            batch_means_[i] = (batch_means_[2 * i] + batch_means_[2 * i + 1]) / 2.0;
+        }
+        batch_means_.resize(half);
+        batch_size_ *= 2;
+    }
+
+public:
+    explicit MserTruncation(size_t batch_size = 5, size_t max_batches = 4096)
+        : base_batch_(batch_size), batch_size_(batch_size), max_batches_(max_batches),
+          partial_sum_(0.0), partial_count_(0), count_(0) {
+        if (batch_size == 0 || max_batches < 4 || max_batches % 2 != 0) {
+            throw std::invalid_argument("Неверные параметры MSER: нужна группа > 0 и чётное число групп >= 4");
+        }
+        batch_means_.reserve(max_batches);
+    }
+
+    void add(double x) {
+        count_++;
+        partial_sum_ += x;
+        if (++partial_count_ < batch_size_) return;
+        batch_means_.push_back(partial_sum_ / partial_count_);
+        partial_sum_ = 0.0;
+        partial_count_ = 0;
+        if (batch_means_.size() == max_batches_) compact();
+    }
+
+    void reset() {
+        batch_size_ = base_batch_;
+        batch_means_.clear();
+        partial_sum_ = 0.0;
+        partial_count_ = 0;
+        count_ = 0;
+    }
+
+    // Точка отсечения за O(n) проходом суффиксных сумм от конца
+    Result evaluate() const {
+        const size_t n = batch_means_.size();
+        Result result{0, 0, false, 0.0};
+        if (n < 4) return result;
+
+        std::vector<double> suffix_sum(n + 1, 0.0), suffix_sq(n + 1, 0.0);
+        for (size_t i = n; i > 0; --i) {
+            suffix_sum[i - 1] = suffix_sum[i] + batch_means_[i - 1];
+            suffix_sq[i - 1] = suffix_sq[i] + batch_means_[i - 1] * batch_means_[i - 1];
+        }
+
+        const size_t limit = n / 2;
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t d = 0; d <= limit; ++d) {
+            double m = static_cast<double>(n - d);
+            double ss = suffix_sq[d] - suffix_sum[d] * suffix_sum[d] / m;
+            double mser = std::max(ss, 0.0) / (m * m);
+            if (mser < best) {
+                best = mser;
+                result.truncated_batches = d;
+            }
+        }
+        result.truncated_observations = static_cast<uint64_t>(result.truncated_batches) * batch_size_;
+        result.reliable = result.truncated_batches < limit;
+        result.mean = suffix_sum[result.truncated_batches] / static_cast<double>(n - result.truncated_batches);
+        return result;
+    }
+
+    /**
+     * Доверительный интервал методом групповых средних по данным после
+     * отсечения first_batch групп: оставшиеся группы объединяются в batches
+     * крупных групп равного размера (лишние отбрасываются с начала)
+     */
+    ConfidenceInterval batch_means_interval(size_t first_batch = 0, size_t batches = 20,
+                                            double confidence = 0.95) const;
+
+    void save(Serialization::Writer& out) const {
+        out.write(batch_size_);
+        out.write_vector(batch_means_);
+        out.write(partial_sum_);
+        out.write(partial_count_);
+        out.write(count_);
+    }
+
+    void load(Serialization::Reader& in) {
+        in.read(batch_size_);
+        in.read_vector(batch_means_);
+        if (batch_means_.size() >= max_batches_) {
+            throw std::invalid_argument("Контрольная точка несовместима: другие параметры MSER");
+        }
+        in.read(partial_sum_);
+        in.read(partial_count_);
+        in.read(count_);
+    }
+
+    uint64_t count() const { return count_; }
+    size_t batch_count() const { return batch_means_.size(); }
+    size_t batch_size() const { return batch_size_; }
+    const std::vector<double>& batch_means() const { return batch_means_; }
+};
+
+inline ConfidenceInterval MserTruncation::batch_means_interval(size_t first_batch, size_t batches,
+                                                               double confidence) const {
+    StreamingAccumulator groups;
+    size_t available = first_batch < batch_means_.size() ? batch_means_.size() - first_batch : 0;
+    size_t per_group = batches > 0 ? available / batches : 0;
+    if (per_group == 0) {
+        for (size_t i = first_batch; i < batch_means_.size(); ++i) groups.add(batch_means_[i]);
+    } else {
+        size_t begin = batch_means_.size() - per_group * batches;
+        for (size_t g = 0; g < batches; ++g) {
+            double sum = 0.0;
+            for (size_t i = 0; i < per_group; ++i) sum += batch_means_[begin + g * per_group + i];
+            groups.add(sum / per_group);
+        }
+    }
+    return confidence_interval(groups, confidence);
+}
+
+} // namespace Statistics
+
+#endif // STATISTICS_H
@@ -0,0 +1,408 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+/**
+ * Телеметрия длинного прогона: временной ряд с шагом модельного времени
+ *
+ * Цикл событий раз в Δt модельного времени записывает точку ряда (длина
+ * очереди, занятые ядра, среднее ожидание ушедших за окно, события в
+ * секунду) в буфер фиксированной ёмкости. Заполненный буфер прореживается
+ * вдвое: соседние точки сливаются, шаг удваивается. Память - O(ёмкость)
+ * при любой длине прогона, весь прогон от начала остаётся виден с
+ * разрешением не хуже ёмкость/2 точек.
+ *
+ * Другой поток читает ряд без замков (snapshot()): запись публикуется под
+ * счётчиком версий (seqlock), и цикл событий никогда не ждёт читателя.
+ * Exporter периодически выгружает новые точки строками JSON в файл или сокет.
+ */
+namespace Telemetry {
+
+/**
+ * Точка ряда: состояние в момент time и суммы за окно до него. При
+ * прореживании состояние усредняется по сливаемым точкам, суммы складываются.
+ */
+struct Sample {
+    double time = 0.0;              // конец окна (модельное время)
+    double queue_length = 0.0;      // заданий в очереди
+    double jobs_in_system = 0.0;
+    double busy_cores = 0.0;
+    double wait_sum = 0.0;          // сумма ожиданий ушедших за окно
+    double departures = 0.0;        // ушедших за окно
+    double events = 0.0;            // событий за окно
+    double wall_seconds = 0.0;      // реального времени за окно
+
+    double mean_wait() const {
+        return departures > 0.0 ? wait_sum / departures : std::numeric_limits<double>::quiet_NaN();
+    }
+    double events_per_second() const { return wall_seconds > 0.0 ? events / wall_seconds : 0.0; }
+
+    // Слияние точек окон a и b (b позже): окно b продолжает окно a
+    static Sample merge(const Sample& a, const Sample& b) {
+        Sample m;
+        m.time = b.time;
+        m.queue_length = (a.queue_length + b.queue_length) / 2;
+        m.jobs_in_system = (a.jobs_in_system + b.jobs_in_system) / 2;
+        m.busy_cores = (a.busy_cores + b.busy_cores) / 2;
+        m.wait_sum = a.wait_sum + b.wait_sum;
+        m.departures = a.departures + b.departures;
+        m.events = a.events + b.events;
+        m.wall_seconds = a.wall_seconds + b.wall_seconds;
+        return m;
+    }
+
+    static constexpr size_t FIELDS = 8;
+
+    // Поля по порядку объявления - для публикации по словам
+    void to_fields(double* fields) const {
+        const double values[FIELDS] = {time, queue_length, jobs_in_system, busy_cores,
+                                       wait_sum, departures, events, wall_seconds};
+        std::copy(values, values + FIELDS, fields);
+    }
+
+    static Sample from_fields(const double* fields) {
+        return Sample{fields[0], fields[1], fields[2], fields[3], fields[4], fields[5], fields[6], fields[7]};
+    }
+};
+
+// Согласованная копия ряда
+struct Snapshot {
+    uint64_t version = 0;           // растёт с каждой записью
+    double interval = 0.0;          // текущий шаг ряда
+    uint64_t recorded = 0;          // всего записано точек с начала прогона
+    std::vector<Sample> samples;
+};
+
+/**
+ * Буфер ряда: пишет один поток (цикл событий), читает любое число потоков
+ *
+ * Поля хранятся в std::atomic<double> с упорядочиванием relaxed и
+ * публикуются счётчиком seq_: нечётный - идёт запись. Читатель повторяет
+ * копирование, если счётчик изменился. Запись точки - Sample::FIELDS
+ * обычных сохранений; заполнившийся буфер прореживается сразу, поэтому
+ * в нём не больше capacity - 1 точек, а переписывается он раз в
+ * capacity/2 точек.
+ */
+class Recorder {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+private:
+    double base_interval_;
+    size_t capacity_;
+
+    // Только пишущий поток
+    std::vector<Sample> samples_;
+    double interval_;
+    double next_time_;
+    double wait_sum_ = 0.0;
+    uint64_t departures_ = 0;
+    long long last_events_ = 0;
+    std::chrono::steady_clock::time_point last_wall_;
+
+    // Опубликованная копия
+    std::atomic<uint64_t> seq_{0};
+    std::unique_ptr<std::atomic<double>[]> published_;
+    std::atomic<size_t> published_count_{0};
+    std::atomic<double> published_interval_;
+    std::atomic<uint64_t> recorded_{0};
+
+    mutable std::atomic<bool> stop_requested_{false};
+
+    void begin_write() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void end_write() { seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    void publish(size_t index) {
+        double fields[Sample::FIELDS];
+        samples_[index].to_fields(fields);
+        for (size_t f = 0; f < Sample::FIELDS; ++f) {
+            published_[index * Sample::FIELDS + f].store(fields[f], std::memory_order_relaxed);
+        }
+    }
+
+    void compact() {
+        size_t half = samples_.size() / 2;
+        for (size_t i = 0; i < half; ++i) samples_[i] = Sample::merge(samples_[2 * i], samples_[2 * i + 1]);
+        samples_.resize(half);
+        interval_ *= 2;
+        for (size_t i = 0; i < half; ++i) publish(i);
+    }
+
+public:
+    /**
+     * @param interval шаг ряда Δt модельного времени
+     * @param capacity точек в буфере (чётное, не меньше 2)
+     */
+    explicit Recorder(double interval, size_t capacity = DEFAULT_CAPACITY)
+        : base_interval_(interval), capacity_(capacity),
+          published_(std::make_unique<std::atomic<double>[]>(capacity * Sample::FIELDS)) {
+        if (!(interval > 0.0) || !std::isfinite(interval)) {
+            throw std::invalid_argument("Шаг телеметрии должен быть положительным");
+        }
+        if (capacity < 2 || capacity % 2 != 0) {
+            throw std::invalid_argument("Ёмкость буфера телеметрии должна быть чётной и не меньше 2");
+        }
+        samples_.reserve(capacity);
+        reset();
+    }
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // Начало прогона: пустой ряд с исходным шагом (запрос остановки сохраняется)
+    void reset() {
+        begin_write();
+        samples_.clear();
+        interval_ = base_interval_;
+        next_time_ = interval_;
+        wait_sum_ = 0.0;
+        departures_ = 0;
+        last_events_ = 0;
+        last_wall_ = std::chrono::steady_clock::now();
+        published_count_.store(0, std::memory_order_relaxed);
+        published_interval_.store(interval_, std::memory_order_relaxed);
+        recorded_.store(0, std::memory_order_relaxed);
+        end_write();
+    }
+
+    // Ближайший момент записи; цикл событий сравнивает с ним время события
+    double next_time() const { return next_time_; }
+
+    void add_wait(double wait) {
+        wait_sum_ += wait;
+        departures_++;
+    }
+
+    /**
+     * Точки для всех моментов сетки до until (включительно при inclusive):
+     * состояние (queue, in_system, busy) держалось с последнего события;
+     * events - события с начала прогона
+     */
+    void record(double until, bool inclusive, int queue, int in_system, int busy, long long events) {
+        auto now = std::chrono::steady_clock::now();
+        while (inclusive ? next_time_ <= until : next_time_ < until) {
+            Sample sample;
+            sample.time = next_time_;
+            sample.queue_length = queue;
+            sample.jobs_in_system = in_system;
+            sample.busy_cores = busy;
+            sample.wait_sum = wait_sum_;
+            sample.departures = static_cast<double>(departures_);
+            sample.events = static_cast<double>(events - last_events_);
+            sample.wall_seconds = std::chrono::duration<double>(now - last_wall_).count();
+            wait_sum_ = 0.0;
+            departures_ = 0;
+            last_events_ = events;
+            last_wall_ = now;
+
+            begin_write();
+            samples_.push_back(sample);
+            publish(samples_.size() - 1);
+            if (samples_.size() == capacity_) compact();
+            published_count_.store(samples_.size(), std::memory_order_relaxed);
+            published_interval_.store(interval_, std::memory_order_relaxed);
+            recorded_.store(recorded_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            end_write();
+            // Сетка нового шага продолжает старую: после слияния пар точки лежат на кратных 2Δt
+            next_time_ = (std::floor(next_time_ / interval_ + 0.5) + 1.0) * interval_;
+        }
+    }
+
+    // Ряд пишущего потока (без синхронизации)
+    const std::vector<Sample>& samples() const { return samples_; }
+    double interval() const { return interval_; }
+    size_t capacity() const { return capacity_; }
+
+    // ===== Чтение из других потоков =====
+
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+    // Одна попытка копирования; false - писатель обновлял ряд, повторите
+    bool try_snapshot(Snapshot& out) const {
+        uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before % 2 != 0) return false;
+        size_t count = published_count_.load(std::memory_order_relaxed);
+        out.samples.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            double fields[Sample::FIELDS];
+            for (size_t f = 0; f < Sample::FIELDS; ++f) {
+                fields[f] = published_[i * Sample::FIELDS + f].load(std::memory_order_relaxed);
+            }
+            out.samples[i] = Sample::from_fields(fields);
+        }
+        out.interval = published_interval_.load(std::memory_order_relaxed);
+        out.recorded = recorded_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) return false;
+        out.version = before / 2;
+        return true;
+    }
+
+    // Копирование с повторами; писатель не ждёт, ждёт только читатель
+    Snapshot snapshot() const {
+        Snapshot out;
+        for (int attempt = 0; !try_snapshot(out); ++attempt) {
+            if (attempt >= 16) std::this_thread::yield();
+        }
+        return out;
+    }
+
+    /**
+     * Запрос остановки прогона из другого потока: цикл событий проверяет его
+     * только в моменты записи ряда, поэтому проверка ничего не стоит между
+     * ними. Запрос гасится прогоном, который его выполнил.
+     */
+    void request_stop() const { stop_requested_.store(true, std::memory_order_relaxed); }
+    bool take_stop_request() { return stop_requested_.exchange(false, std::memory_order_relaxed); }
+};
+
+/**
+ * Периодическая выгрузка ряда в фоновом потоке: точки, появившиеся с
+ * прошлой выгрузки, - по строке JSON на точку. После прореживания уже
+ * выгруженные окна не повторяются: выгружаются точки позже последней.
+ *
+ * Ошибка вывода останавливает выгрузку и выбрасывается из stop();
+ * деструктор её не сообщает.
+ */
+class Exporter {
+public:
+    using LineWriter = std::function<void(const std::string& lines)>;
+
+private:
+    std::shared_ptr<const Recorder> recorder_;
+    LineWriter writer_;
+    std::chrono::milliseconds period_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+    std::exception_ptr failure_;
+    double last_time_ = -std::numeric_limits<double>::infinity();
+    uint64_t last_version_ = UINT64_MAX;
+    size_t lines_ = 0;
+    size_t exports_ = 0;
+
+    void export_new() {
+        if (recorder_->version() == last_version_) return;
+        Snapshot snapshot = recorder_->snapshot();
+        last_version_ = snapshot.version;
+        std::string text;
+        size_t lines = 0;
+        // Сброс в начале нового прогона: время ряда пошло заново
+        if (!snapshot.samples.empty() && snapshot.samples.back().time < last_time_) {
+            last_time_ = -std::numeric_limits<double>::infinity();
+        }
+        for (const Sample& sample : snapshot.samples) {
+            if (sample.time <= last_time_) continue;
+            text += to_json(sample, snapshot.interval);
+            text += '\n';
+            last_time_ = sample.time;
+            lines++;
+        }
+        if (lines == 0) return;
+        writer_(text);
+        lines_ += lines;
+        exports_++;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            bool stop = wake_.wait_for(lock, period_, [this]() { return stopping_; });
+            lock.unlock();
+            try {
+                export_new();
+            } catch (...) {
+                failure_ = std::current_exception();
+                return;
+            }
+            if (stop) return;
+            lock.lock();
+        }
+    }
+
+public:
+    Exporter(std::shared_ptr<const Recorder> recorder, LineWriter writer,
+             std::chrono::milliseconds period = std::chrono::milliseconds(1000))
+        : recorder_(std::move(recorder)), writer_(std::move(writer)), period_(period) {
+        if (!recorder_) throw std::invalid_argument("Телеметрия не включена");
+        if (period_.count() <= 0) throw std::invalid_argument("Период выгрузки должен быть положительным");
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~Exporter() {
+        try {
+            stop();
+        } catch (...) {
+        }
+    }
+
+    Exporter(const Exporter&) = delete;
+    Exporter& operator=(const Exporter&) = delete;
+
+    // Последняя выгрузка и остановка потока
+    void stop() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            thread_.join();
+        }
+        if (failure_) std::rethrow_exception(std::exchange(failure_, nullptr));
+    }
+
+    size_t lines_written() const { return lines_; }
+    size_t exports() const { return exports_; }
+
+    // Строки JSON с дозаписью в файл; файл сбрасывается после каждой выгрузки
+    static LineWriter file(const std::string& path) {
+        auto out = std::make_shared<std::ofstream>(path, std::ios::app);
+        if (!*out) throw std::runtime_error("Не удалось открыть файл телеметрии " + path);
+        return [out, path](const std::string& lines) {
+            *out << lines;
+            out->flush();
+            if (!*out) throw std::runtime_error("Ошибка записи файла телеметрии " + path);
+        };
+    }
+
+    static std::string to_json(const Sample& sample, double interval) {
+        std::ostringstream out;
+        out << std::setprecision(10) << "{\"time\":" << sample.time << ",\"interval\":" << interval
+            << ",\"queue_length\":" << sample.queue_length << ",\"jobs_in_system\":" << sample.jobs_in_system
+            << ",\"busy_cores\":" << sample.busy_cores << ",\"departures\":" << sample.departures
+            << ",\"mean_wait\":";
+        if (sample.departures > 0.0) out << sample.mean_wait(); else out << "null";
+        out << ",\"events_per_second\":" << std::setprecision(6) << sample.events_per_second() << "}";
+        return out.str();
+    }
+};
+
+} // namespace Telemetry
+
+#endif // TELEMETRY_H
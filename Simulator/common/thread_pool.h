@@ -0,0 +1,197 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include "topology.h"
+
+namespace Parallel {
+
+/**
+ * Пул рабочих потоков фиксированного размера с перехватом работы (work stealing)
+ *
+ * У каждого потока своя двусторонняя очередь задач. Поток берёт задачи
+ * со своего конца очереди (LIFO, тёплый кэш), а при её опустошении
+ * перехватывает самые старые задачи у соседей. Задачи, поставленные из
+ * рабочего потока, попадают в его собственную очередь; внешние задачи
+ * распределяются по очередям циклически.
+ *
+ * Поток i может быть закреплён за ЦП cpus[i] (Topology::placement): он
+ * закрепляется первым делом, до своих первых выделений памяти, поэтому его
+ * арена malloc и данные задач по правилу первого касания ложатся на его
+ * узел NUMA, а перехват работы остаётся внутри закреплённого набора.
+ */
+class ThreadPool {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_;         // задач в очередях
+    std::atomic<size_t> next_queue_;      // для циклической раздачи внешних задач
+    std::atomic<size_t> steals_;          // статистика перехватов
+    std::atomic<size_t> pinned_;          // потоков, закреплённых за ЦП
+    std::vector<int> cpus_;               // ЦП потока (-1 - без закрепления)
+    bool stopping_;
+
+    static inline thread_local ThreadPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+
+    bool try_pop_local(size_t index, std::function<void()>& task) {
+        WorkerQueue& q = *queues_[index];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool try_steal(size_t thief, std::function<void()>& task) {
+        const size_t n = queues_.size();
+        for (size_t offset = 1; offset < n; ++offset) {
+            WorkerQueue& q = *queues_[(thief + offset) % n];
+            std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            steals_++;
+            return true;
+        }
+        return false;
+    }
+
+    void worker_loop(size_t index) {
+        if (cpus_[index] >= 0 && pin_current_thread(cpus_[index])) pinned_++;
+        current_pool_ = this;
+        current_index_ = index;
+
+        while (true) {
+            std::function<void()> task;
+            if (try_pop_local(index, task) || try_steal(index, task)) {
+                pending_--;
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+            if (stopping_ && pending_.load() == 0) return;
+        }
+    }
+
+    void enqueue(std::function<void()> task) {
+        size_t index = (current_pool_ == this)
+            ? current_index_
+            : next_queue_.fetch_add(1) % queues_.size();
+        // Счётчик увеличивается до публикации задачи, чтобы не уйти в минус
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            pending_++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+public:
+    /**
+     * @param cpus ЦП рабочих потоков по номерам (по кругу, если их меньше);
+     *             пустой - без закрепления
+     */
+    explicit ThreadPool(size_t threads = 0, const std::vector<int>& cpus = {})
+        : pending_(0), next_queue_(0), steals_(0), pinned_(0), stopping_(false) {
+        if (threads == 0) threads = default_concurrency();
+        cpus_.assign(threads, -1);
+        for (size_t i = 0; i < threads && !cpus.empty(); ++i) cpus_[i] = cpus[i % cpus.size()];
+        for (size_t i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Ставит задачу в пул и возвращает future с её результатом
+    template<typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+    size_t size() const { return workers_.size(); }
+    size_t steals() const { return steals_.load(); }
+    // Закрепление выполняется при старте потока: сразу после конструктора
+    // счётчик может быть ещё неполным
+    size_t pinned() const { return pinned_.load(); }
+    const std::vector<int>& cpus() const { return cpus_; }
+
+    static size_t default_concurrency() {
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+};
+
+/**
+ * Многоразовый барьер для фиксированного числа потоков
+ */
+class Barrier {
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t threshold_;
+    size_t waiting_;
+    size_t generation_;
+
+public:
+    explicit Barrier(size_t threads)
+        : threshold_(threads), waiting_(0), generation_(0) {}
+
+    void arrive_and_wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        size_t generation = generation_;
+        if (++waiting_ == threshold_) {
+            waiting_ = 0;
+            generation_++;
+            cv_.notify_all();
+        } else {
+            cv_.wait(lock, [this, generation] { return generation != generation_; });
+        }
+    }
+};
+
+} // namespace Parallel
+
+#endif // THREAD_POOL_H
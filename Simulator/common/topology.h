@@ -0,0 +1,246 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <cstddef>
+#include <cctype>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Parallel {
+
+// Правило размещения рабочих потоков по процессорам
+enum class Affinity {
+    NONE,       // без закрепления: потоки там, где их поставит ОС
+    COMPACT,    // плотно: узел за узлом, ядро за ядром, сначала соседи SMT
+    SCATTER,    // вразброс: по очереди по узлам NUMA, соседи SMT - в последнюю очередь
+    NO_SMT      // одно логическое ЦП на физическое ядро, плотно по узлам
+};
+
+inline std::string affinity_name(Affinity affinity) {
+    switch (affinity) {
+        case Affinity::NONE: return "NONE";
+        case Affinity::COMPACT: return "COMPACT";
+        case Affinity::SCATTER: return "SCATTER";
+        case Affinity::NO_SMT: return "NO_SMT";
+    }
+    return "UNKNOWN";
+}
+
+// Разбор имени правила без учёта регистра: none, compact, scatter, no_smt
+inline Affinity parse_affinity(const std::string& name) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+    for (Affinity affinity : {Affinity::NONE, Affinity::COMPACT, Affinity::SCATTER, Affinity::NO_SMT}) {
+        if (affinity_name(affinity) == upper) return affinity;
+    }
+    throw std::invalid_argument("Неизвестное правило размещения потоков: " + name);
+}
+
+// Логическое ЦП: физическое ядро, корпус, узел NUMA и номер среди соседей SMT
+struct Cpu {
+    int id;
+    int core;
+    int package;
+    int node;
+    int smt;
+};
+
+/**
+ * Топология машины по sysfs (/sys/devices/system/cpu и .../node)
+ *
+ * Учитываются только ЦП, доступные процессу (sched_getaffinity), поэтому
+ * ограничения cpuset и taskset соблюдаются. Без sysfs (не Linux,
+ * контейнер без /sys) - плоская машина из hardware_concurrency() ЦП на
+ * одном узле, каждое ЦП - своё ядро.
+ */
+class Topology {
+private:
+    std::vector<Cpu> cpus_;
+
+    static bool read_int(const std::string& path, int& value) {
+        std::ifstream in(path);
+        return static_cast<bool>(in >> value);
+    }
+
+    // Список вида "0-3,8,10-11"
+    static std::vector<int> parse_list(const std::string& text) {
+        std::vector<int> ids;
+        std::stringstream in(text);
+        std::string part;
+        while (std::getline(in, part, ',')) {
+            if (part.empty() || part == "\n") continue;
+            size_t dash = part.find('-');
+            int first = std::stoi(part.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(part.substr(dash + 1));
+            for (int id = first; id <= last; ++id) ids.push_back(id);
+        }
+        return ids;
+    }
+
+    static std::vector<int> read_list(const std::string& path) {
+        std::ifstream in(path);
+        std::string text;
+        if (!std::getline(in, text)) return {};
+        return parse_list(text);
+    }
+
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> ids;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int id = 0; id < CPU_SETSIZE; ++id) {
+                if (CPU_ISSET(id, &set)) ids.push_back(id);
+            }
+        }
+#endif
+        return ids;
+    }
+
+    void number_siblings() {
+        std::sort(cpus_.begin(), cpus_.end(), [](const Cpu& a, const Cpu& b) {
+            if (a.package != b.package) return a.package < b.package;
+            if (a.core != b.core) return a.core < b.core;
+            return a.id < b.id;
+        });
+        for (size_t i = 0; i < cpus_.size(); ++i) {
+            bool sibling = i > 0 && cpus_[i].package == cpus_[i - 1].package && cpus_[i].core == cpus_[i - 1].core;
+            cpus_[i].smt = sibling ? cpus_[i - 1].smt + 1 : 0;
+        }
+    }
+
+public:
+    explicit Topology(std::vector<Cpu> cpus = {}) : cpus_(std::move(cpus)) {
+        if (!cpus_.empty()) number_siblings();
+    }
+
+    static Topology detect() {
+        const std::string root = "/sys/devices/system/";
+        std::vector<int> ids = allowed_cpus();
+        if (ids.empty()) ids = read_list(root + "cpu/online");
+
+        std::vector<Cpu> cpus;
+        for (int id : ids) {
+            std::string topology = root + "cpu/cpu" + std::to_string(id) + "/topology/";
+            Cpu cpu{id, id, 0, 0, 0};
+            read_int(topology + "core_id", cpu.core);
+            read_int(topology + "physical_package_id", cpu.package);
+            cpus.push_back(cpu);
+        }
+        // Узлы NUMA: node<n>/cpulist; машина без них - один узел 0
+        for (int node = 0; node < 1024; ++node) {
+            std::ifstream probe(root + "node/node" + std::to_string(node) + "/cpulist");
+            if (!probe) {
+                if (node > 0) break;
+                continue;
+            }
+            std::string text;
+            std::getline(probe, text);
+            for (int id : parse_list(text)) {
+                for (Cpu& cpu : cpus) {
+                    if (cpu.id == id) cpu.node = node;
+                }
+            }
+        }
+        if (cpus.empty()) {
+            unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned id = 0; id < hw; ++id) {
+                cpus.push_back(Cpu{static_cast<int>(id), static_cast<int>(id), 0, 0, 0});
+            }
+        }
+        return Topology(std::move(cpus));
+    }
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    size_t logical() const { return cpus_.size(); }
+
+    size_t physical() const {
+        return static_cast<size_t>(std::count_if(cpus_.begin(), cpus_.end(), [](const Cpu& c) { return c.smt == 0; }));
+    }
+
+    size_t nodes() const {
+        int last = 0;
+        for (const Cpu& cpu : cpus_) last = std::max(last, cpu.node);
+        return static_cast<size_t>(last) + 1;
+    }
+
+    /**
+     * ЦП для рабочих потоков 0..threads-1 по правилу affinity (-1 - не
+     * закреплять). Потоков больше, чем подходящих ЦП, - ЦП идут по кругу.
+     */
+    std::vector<int> placement(Affinity affinity, size_t threads) const {
+        if (affinity == Affinity::NONE || cpus_.empty()) return std::vector<int>(threads, -1);
+
+        std::vector<Cpu> order = cpus_;
+        if (affinity == Affinity::NO_SMT) {
+            order.erase(std::remove_if(order.begin(), order.end(), [](const Cpu& c) { return c.smt > 0; }),
+                        order.end());
+        }
+        auto dense = [](const Cpu& a, const Cpu& b) {
+            if (a.node != b.node) return a.node < b.node;
+            if (a.package != b.package) return a.package < b.package;
+            if (a.core != b.core) return a.core < b.core;
+            return a.smt < b.smt;
+        };
+        std::sort(order.begin(), order.end(), dense);
+        if (affinity == Affinity::SCATTER) {
+            // Ранг ядра внутри узла: сначала первые ядра всех узлов, затем вторые...
+            std::vector<int> rank(order.size());
+            for (size_t i = 0, r = 0; i < order.size(); ++i) {
+                if (i > 0 && order[i].node != order[i - 1].node) r = 0;
+                rank[i] = static_cast<int>(r++);
+            }
+            std::vector<size_t> index(order.size());
+            for (size_t i = 0; i < index.size(); ++i) index[i] = i;
+            std::stable_sort(index.begin(), index.end(), [&](size_t a, size_t b) {
+                if (order[a].smt != order[b].smt) return order[a].smt < order[b].smt;
+                if (rank[a] != rank[b]) return rank[a] < rank[b];
+                return order[a].node < order[b].node;
+            });
+            std::vector<Cpu> scattered;
+            for (size_t i : index) scattered.push_back(order[i]);
+            order = std::move(scattered);
+        }
+
+        std::vector<int> cpus(threads);
+        for (size_t i = 0; i < threads; ++i) cpus[i] = order[i % order.size()].id;
+        return cpus;
+    }
+
+    // Узел NUMA логического ЦП (0, если ЦП неизвестно)
+    int node_of(int cpu) const {
+        for (const Cpu& c : cpus_) {
+            if (c.id == cpu) return c.node;
+        }
+        return 0;
+    }
+};
+
+// Закрепление вызывающего потока за ЦП; false - ОС отказала или не Linux
+inline bool pin_current_thread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace Parallel
+
+#endif // TOPOLOGY_H
@@ -0,0 +1,582 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <charconv>
+#include <algorithm>
+#include <chrono>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "random_generator.h"
+#include "statistics.h"
+
+namespace Traces {
+
+/**
+ * Столбцовый двоичный формат трассы
+ *
+ * [FileHeader][ColumnHeader × columns] ... [столбец 0] [столбец 1] ...
+ * Каждый столбец - непрерывный массив double длины rows, выровненный на
+ * COLUMN_ALIGN байт, поэтому после mmap значения читаются без копирования
+ * и разбора. В заголовке столбца заранее посчитаны среднее, дисперсия,
+ * минимум и максимум: генератору не нужен проход по данным для mean().
+ * Порядок байтов и представление double - платформенные, как у
+ * контрольных точек симулятора.
+ */
+constexpr uint32_t TRACE_MAGIC = 0x45435254;    // "TRCE"
+constexpr uint32_t TRACE_VERSION = 1;
+constexpr size_t COLUMN_ALIGN = 4096;
+constexpr size_t COLUMN_NAME_SIZE = 48;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t rows;
+    uint32_t columns;
+    uint32_t reserved;
+};
+
+struct ColumnHeader {
+    char name[COLUMN_NAME_SIZE];   // с завершающим нулём
+    uint64_t offset;               // от начала файла
+    double mean;
+    double variance;
+    double min;
+    double max;
+};
+
+// Столбец трассы без копирования: указатель внутрь отображения файла
+struct ColumnView {
+    const double* data;
+    size_t size;
+
+    const double* begin() const { return data; }
+    const double* end() const { return data + size; }
+    double operator[](size_t i) const { return data[i]; }
+};
+
+inline size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Трасса, отображённая в память только для чтения
+ *
+ * Отображение закрывается вместе с последним владельцем shared_ptr, поэтому
+ * генераторы одной трассы (и их клоны в репликациях) делят одну копию
+ * страниц. Заголовок и границы столбцов проверяются при открытии.
+ */
+class TraceFile {
+private:
+    std::string path_;
+    const uint8_t* base_;
+    size_t size_;
+    const FileHeader* header_;
+    const ColumnHeader* columns_;
+
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    void fail(const std::string& what) const {
+        throw std::runtime_error("Трасса " + path_ + ": " + what);
+    }
+
+public:
+    explicit TraceFile(const std::string& path)
+        : path_(path), base_(nullptr), size_(0), header_(nullptr), columns_(nullptr) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail("не удалось открыть файл");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail("не удалось получить размер файла");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ < sizeof(FileHeader)) {
+            ::close(fd);
+            fail("файл короче заголовка");
+        }
+        void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) fail("mmap не удался");
+        base_ = static_cast<const uint8_t*>(map);
+        // Значения читаются последовательно: ядро может упреждающе читать крупнее
+        ::madvise(map, size_, MADV_SEQUENTIAL);
+
+        try {
+            header_ = reinterpret_cast<const FileHeader*>(base_);
+            if (header_->magic != TRACE_MAGIC) fail("неверная сигнатура");
+            if (header_->version != TRACE_VERSION) fail("неподдерживаемая версия формата");
+            size_t table_end = sizeof(FileHeader) + header_->columns * sizeof(ColumnHeader);
+            if (table_end > size_) fail("таблица столбцов за концом файла");
+            columns_ = reinterpret_cast<const ColumnHeader*>(base_ + sizeof(FileHeader));
+            for (uint32_t c = 0; c < header_->columns; ++c) {
+                const ColumnHeader& col = columns_[c];
+                if (col.name[COLUMN_NAME_SIZE - 1] != '\0') fail("повреждено имя столбца");
+                if (col.offset % alignof(double) != 0 || col.offset < table_end ||
+                    header_->rows > (size_ - col.offset) / sizeof(double)) {
+                    fail("столбец " + std::string(col.name) + " за концом файла");
+                }
+            }
+        } catch (...) {
+            ::munmap(const_cast<uint8_t*>(base_), size_);
+            throw;
+        }
+    }
+
+    ~TraceFile() {
+        if (base_) ::munmap(const_cast<uint8_t*>(base_), size_);
+    }
+
+    static std::shared_ptr<const TraceFile> open(const std::string& path) {
+        return std::make_shared<const TraceFile>(path);
+    }
+
+    size_t rows() const { return header_->rows; }
+    size_t column_count() const { return header_->columns; }
+    const std::string& path() const { return path_; }
+
+    const ColumnHeader& column_header(size_t index) const {
+        if (index >= column_count()) throw std::out_of_range("Неверный номер столбца трассы");
+        return columns_[index];
+    }
+
+    // Номер столбца по имени; -1, если столбца нет
+    int find_column(const std::string& name) const {
+        for (size_t c = 0; c < column_count(); ++c) {
+            if (name == columns_[c].name) return static_cast<int>(c);
+        }
+        return -1;
+    }
+
+    size_t column_index(const std::string& name) const {
+        int index = find_column(name);
+        if (index < 0) fail("нет столбца " + name);
+        return static_cast<size_t>(index);
+    }
+
+    ColumnView column(size_t index) const {
+        const ColumnHeader& col = column_header(index);
+        return ColumnView{reinterpret_cast<const double*>(base_ + col.offset), rows()};
+    }
+
+    ColumnView column(const std::string& name) const { return column(column_index(name)); }
+
+    // Подсказка ядру: страницы [first, first + count) столбца понадобятся скоро
+    void will_need(size_t index, size_t first, size_t count) const {
+        const ColumnHeader& col = column_header(index);
+        if (first >= rows()) return;
+        count = std::min(count, rows() - first);
+        size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t from = col.offset + first * sizeof(double);
+        size_t to = from + count * sizeof(double);
+        from = from / page * page;
+        ::madvise(const_cast<uint8_t*>(base_) + from, to - from, MADV_WILLNEED);
+    }
+};
+
+/**
+ * Генератор, воспроизводящий столбец трассы
+ *
+ * Значения выдаются в порядке записи; generate_batch() копирует их прямо из
+ * отображения одним memcpy, поэтому вместе с VariateBuffer стоимость значения
+ * в цикле событий ниже, чем у синтетических генераторов. Впереди позиции
+ * чтения поддерживается окно упреждающего чтения (MADV_WILLNEED).
+ *
+ * Трасса - фиксированная траектория: seed() только возвращает чтение
+ * к началу (зерно игнорируется), поэтому репликации с разными зёрнами
+ * воспроизводят одну и ту же трассу. По исчерпании трассы чтение
+ * начинается сначала (WrapMode::LOOP, число проходов - wraps())
+ * или выбрасывается исключение (WrapMode::STOP).
+ */
+class TraceGenerator final : public RandomGenerator {
+public:
+    enum class WrapMode { LOOP, STOP };
+
+    static constexpr size_t READAHEAD_VALUES = 1 << 20;   // 8 МБ окна упреждения
+
+private:
+    std::shared_ptr<const TraceFile> file_;
+    size_t column_;
+    const double* data_;
+    size_t size_;
+    size_t pos_;
+    size_t next_hint_;           // позиция, на которой запрашивается следующее окно
+    unsigned long long wraps_;
+    WrapMode mode_;
+
+    void wrap() {
+        if (mode_ == WrapMode::STOP) {
+            throw std::runtime_error("Трасса " + file_->path() + " исчерпана");
+        }
+        pos_ = 0;
+        wraps_++;
+        advise();
+    }
+
+    void advise() {
+        file_->will_need(column_, pos_, READAHEAD_VALUES);
+        next_hint_ = pos_ + READAHEAD_VALUES / 2;
+    }
+
+public:
+    TraceGenerator(std::shared_ptr<const TraceFile> file, const std::string& column,
+                   WrapMode mode = WrapMode::LOOP)
+        : file_(std::move(file)), pos_(0), next_hint_(0), wraps_(0), mode_(mode) {
+        if (!file_) throw std::invalid_argument("Трасса не задана");
+        column_ = file_->column_index(column);
+        ColumnView view = file_->column(column_);
+        data_ = view.data;
+        size_ = view.size;
+        if (size_ == 0) {
+            throw std::invalid_argument("Столбец " + column + " трассы пуст");
+        }
+        advise();
+    }
+
+    double generate() override {
+        if (pos_ == size_) wrap();
+        double value = data_[pos_++];
+        if (pos_ >= next_hint_) advise();
+        return value;
+    }
+
+    void generate_batch(double* out, size_t n) override {
+        while (n > 0) {
+            if (pos_ == size_) wrap();
+            size_t take = std::min(n, size_ - pos_);
+            std::memcpy(out, data_ + pos_, take * sizeof(double));
+            pos_ += take;
+            out += take;
+            n -= take;
+            if (pos_ >= next_hint_) advise();
+        }
+    }
+
+    double mean() const override { return file_->column_header(column_).mean; }
+    double variance() const override { return file_->column_header(column_).variance; }
+    double min_value() const override { return file_->column_header(column_).min; }
+
+    std::string name() const override {
+        return "Trace(" + file_->path() + ":" + file_->column_header(column_).name + ")";
+    }
+
+    std::unique_ptr<RandomGenerator> clone() const override {
+        return std::make_unique<TraceGenerator>(*this);
+    }
+
+    void seed(uint64_t) override {
+        pos_ = 0;
+        wraps_ = 0;
+        advise();
+    }
+
+    void save_state(Serialization::Writer& out) const override {
+        out.write<uint64_t>(size_);
+        out.write<uint64_t>(pos_);
+        out.write(wraps_);
+    }
+
+    void load_state(Serialization::Reader& in) override {
+        if (in.read<uint64_t>() != size_) {
+            throw std::invalid_argument("Контрольная точка несовместима: другая длина трассы");
+        }
+        pos_ = static_cast<size_t>(in.read<uint64_t>());
+        in.read(wraps_);
+        if (pos_ > size_) {
+            throw std::runtime_error("Контрольная точка повреждена: позиция трассы");
+        }
+        advise();
+    }
+
+    ColumnView values() const { return ColumnView{data_, size_}; }
+    size_t position() const { return pos_; }
+    unsigned long long wraps() const { return wraps_; }
+    const TraceFile& file() const { return *file_; }
+};
+
+inline std::unique_ptr<RandomGenerator> create_trace(std::shared_ptr<const TraceFile> file,
+                                                     const std::string& column,
+                                                     TraceGenerator::WrapMode mode = TraceGenerator::WrapMode::LOOP) {
+    return std::make_unique<TraceGenerator>(std::move(file), column, mode);
+}
+
+// ==================== ПРЕОБРАЗОВАНИЕ CSV ====================
+
+struct CsvOptions {
+    char delimiter = ',';
+    std::vector<std::string> columns;   // выбранные столбцы по именам (пусто - все)
+    // Столбец абсолютных меток времени прибытия: заменяется столбцом
+    // "interarrival" из разностей соседних меток (первое значение - 0)
+    std::string timestamp_column;
+};
+
+struct ConvertResult {
+    size_t rows;
+    size_t columns;
+    size_t input_bytes;
+    size_t output_bytes;
+    double seconds;
+
+    double megabytes_per_second() const {
+        return seconds > 0.0 ? input_bytes / seconds / 1e6 : 0.0;
+    }
+};
+
+namespace detail {
+
+// Файл, отображённый для чтения или записи (RAII для convert_csv)
+class MappedFile {
+private:
+    int fd_;
+    uint8_t* data_;
+    size_t size_;
+
+public:
+    MappedFile() : fd_(-1), data_(nullptr), size_(0) {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void open_read(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error("Не удалось открыть " + path);
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) throw std::runtime_error("Не удалось получить размер " + path);
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (map == MAP_FAILED) throw std::runtime_error("mmap не удался: " + path);
+            data_ = static_cast<uint8_t*>(map);
+            ::madvise(map, size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    void open_write(const std::string& path, size_t size) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) throw std::runtime_error("Не удалось создать " + path);
+        resize(size);
+        void* map = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) throw std::runtime_error("mmap не удался: " + path);
+        data_ = static_cast<uint8_t*>(map);
+    }
+
+    // Усечение после unmap: итоговый размер файла
+    void finish(size_t size) {
+        if (data_) ::munmap(data_, size_);
+        data_ = nullptr;
+        resize(size);
+    }
+
+    void close() {
+        if (data_) ::munmap(data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        data_ = nullptr;
+        fd_ = -1;
+    }
+
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void resize(size_t size) {
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            throw std::runtime_error("Не удалось изменить размер файла трассы");
+        }
+        size_ = size;
+    }
+};
+
+inline const char* trim_left(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    return begin;
+}
+
+inline const char* trim_right(const char* begin, const char* end) {
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+    return end;
+}
+
+} // namespace detail
+
+/**
+ * Преобразование CSV с заголовком в столбцовую трассу
+ *
+ * Оба файла отображаются в память. Первый проход (memchr по переводам строк)
+ * даёт верхнюю оценку числа строк, по ней выходной файл размечается сразу,
+ * и второй проход разбирает числа std::from_chars прямо в столбцы результата:
+ * без промежуточных буферов, локалей и istream. Пустые строки пропускаются;
+ * лишнее место в конце столбцов убирается сдвигом перед усечением файла.
+ * Статистика столбцов накапливается по ходу разбора. Отрицательные
+ * значения и убывающие метки времени - ошибка с номером строки.
+ */
+inline ConvertResult convert_csv(const std::string& input_path, const std::string& output_path,
+                                 const CsvOptions& options = CsvOptions()) {
+    auto started = std::chrono::steady_clock::now();
+
+    detail::MappedFile input;
+    input.open_read(input_path);
+    const char* text = reinterpret_cast<const char*>(input.data());
+    const char* text_end = text + input.size();
+    if (input.size() == 0) throw std::runtime_error("Файл " + input_path + " пуст");
+
+    // Заголовок
+    const char* line_end = static_cast<const char*>(std::memchr(text, '\n', input.size()));
+    if (!line_end) line_end = text_end;
+    std::vector<std::string> names;
+    for (const char* field = text; field <= line_end; ) {
+        const char* stop = std::find(field, line_end, options.delimiter);
+        const char* b = detail::trim_left(field, stop);
+        const char* e = detail::trim_right(b, stop);
+        names.emplace_back(b, e);
+        field = stop + 1;
+    }
+
+    // Соответствие столбцов CSV выходным столбцам (-1 - пропустить)
+    std::vector<std::string> selected = options.columns.empty() ? names : options.columns;
+    std::vector<int> target(names.size(), -1);
+    std::vector<std::string> output_names;
+    int timestamp_target = -1;
+    for (const std::string& name : selected) {
+        auto it = std::find(names.begin(), names.end(), name);
+        if (it == names.end()) throw std::invalid_argument("В " + input_path + " нет столбца " + name);
+        size_t source = static_cast<size_t>(it - names.begin());
+        if (target[source] != -1) continue;
+        target[source] = static_cast<int>(output_names.size());
+        bool is_timestamp = !options.timestamp_column.empty() && name == options.timestamp_column;
+        if (is_timestamp) timestamp_target = target[source];
+        output_names.push_back(is_timestamp ? "interarrival" : name);
+    }
+    if (!options.timestamp_column.empty() && timestamp_target == -1) {
+        throw std::invalid_argument("Столбец меток " + options.timestamp_column + " не выбран");
+    }
+    for (const std::string& name : output_names) {
+        if (name.size() >= COLUMN_NAME_SIZE) throw std::invalid_argument("Слишком длинное имя столбца " + name);
+    }
+    if (output_names.empty()) throw std::invalid_argument("Не выбрано ни одного столбца");
+
+    // Верхняя оценка числа строк данных
+    const char* body = line_end < text_end ? line_end + 1 : text_end;
+    size_t capacity = 0;
+    for (const char* p = body; p < text_end; ) {
+        const void* nl = std::memchr(p, '\n', static_cast<size_t>(text_end - p));
+        capacity++;
+        if (!nl) break;
+        p = static_cast<const char*>(nl) + 1;
+    }
+
+    size_t columns = output_names.size();
+    size_t data_start = align_up(sizeof(FileHeader) + columns * sizeof(ColumnHeader), COLUMN_ALIGN);
+    size_t column_bytes = align_up(std::max<size_t>(capacity, 1) * sizeof(double), COLUMN_ALIGN);
+
+    detail::MappedFile output;
+    output.open_write(output_path, data_start + columns * column_bytes);
+    size_t rows = 0;
+    size_t output_bytes = 0;
+    try {
+        std::vector<double*> out(columns);
+        for (size_t c = 0; c < columns; ++c) {
+            out[c] = reinterpret_cast<double*>(output.data() + data_start + c * column_bytes);
+        }
+        std::vector<Statistics::StreamingAccumulator> stats(columns);
+
+        // Разбор строк
+        size_t line_number = 1;
+        double previous_timestamp = 0.0;
+        for (const char* line = body; line < text_end; ) {
+            const char* nl = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(text_end - line)));
+            const char* end = nl ? nl : text_end;
+            line_number++;
+            if (detail::trim_left(line, detail::trim_right(line, end)) == detail::trim_right(line, end)) {
+                line = end + 1;
+                continue;
+            }
+
+            size_t source = 0, filled = 0;
+            for (const char* field = line; field <= end && source < names.size(); ++source) {
+                const char* stop = static_cast<const char*>(std::memchr(field, options.delimiter,
+                                                                         static_cast<size_t>(end - field)));
+                if (!stop) stop = end;
+                int column = target[source];
+                if (column != -1) {
+                    const char* b = detail::trim_left(field, stop);
+                    const char* e = detail::trim_right(b, stop);
+                    double value;
+                    auto parsed = std::from_chars(b, e, value);
+                    if (parsed.ec != std::errc() || parsed.ptr != e) {
+                        throw std::runtime_error(input_path + ":" + std::to_string(line_number) +
+                                                 ": не число в столбце " + names[source]);
+                    }
+                    if (column == timestamp_target) {
+                        double interval = rows == 0 ? 0.0 : value - previous_timestamp;
+                        previous_timestamp = value;
+                        value = interval;
+                    }
+                    if (value < 0.0) {
+                        throw std::runtime_error(input_path + ":" + std::to_string(line_number) +
+                                                 (column == timestamp_target ? ": метки времени убывают"
+                                                                             : ": отрицательное значение в столбце " + names[source]));
+                    }
+                    out[column][rows] = value;
+                    stats[column].add(value);
+                    filled++;
+                }
+                field = stop + 1;
+            }
+            if (filled != columns) {
+                throw std::runtime_error(input_path + ":" + std::to_string(line_number) + ": не хватает столбцов");
+            }
+            rows++;
+            line = end + 1;
+        }
+
+        // Сжатие столбцов до фактического числа строк: сдвиг по возрастанию
+        // номера столбца не затирает ещё не перенесённые данные
+        size_t final_bytes = align_up(std::max<size_t>(rows, 1) * sizeof(double), COLUMN_ALIGN);
+        FileHeader* header = reinterpret_cast<FileHeader*>(output.data());
+        ColumnHeader* column_headers = reinterpret_cast<ColumnHeader*>(output.data() + sizeof(FileHeader));
+        for (size_t c = 0; c < columns; ++c) {
+            uint8_t* destination = output.data() + data_start + c * final_bytes;
+            if (final_bytes != column_bytes) {
+                std::memmove(destination, out[c], rows * sizeof(double));
+            }
+            ColumnHeader& col = column_headers[c];
+            std::memset(&col, 0, sizeof(col));
+            std::memcpy(col.name, output_names[c].data(), output_names[c].size());
+            col.offset = data_start + c * final_bytes;
+            col.mean = stats[c].mean();
+            col.variance = stats[c].variance();
+            col.min = stats[c].min();
+            col.max = stats[c].max();
+        }
+        header->magic = TRACE_MAGIC;
+        header->version = TRACE_VERSION;
+        header->rows = rows;
+        header->columns = static_cast<uint32_t>(columns);
+        header->reserved = 0;
+
+        output_bytes = data_start + columns * final_bytes;
+        output.finish(output_bytes);
+    } catch (...) {
+        // Недописанная трасса не должна остаться на диске
+        output.close();
+        ::unlink(output_path.c_str());
+        throw;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return ConvertResult{rows, columns, input.size(), output_bytes, seconds};
+}
+
+} // namespace Traces
+
+#endif // TRACE_H
@@ -0,0 +1,554 @@
+#include "distributed/cluster.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace Distributed {
+
+namespace {
+
+// Типы сообщений протокола
+enum Message : uint32_t {
+    HELLO = 1,       // узел → координатор: порт для сводок дочерних узлов
+    PLAN,            // координатор → узел: план перебора
+    REQUEST,         // узел → координатор: нужна следующая порция
+    TASKS,           // координатор → узел: порция заданий
+    REDUCE,          // координатор → узел: заданий больше нет, куда слать сводку
+    SUMMARY,         // сводка поддерева
+    DONE,            // узел → координатор: сводка передана родителю
+    FAILURE          // узел → координатор: текст исключения
+};
+
+struct WireTask {
+    uint32_t point;
+    uint32_t replication;
+};
+
+const size_t HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+const uint64_t MAX_MESSAGE = uint64_t(1) << 32;
+
+runtime_error socket_error(const string& what) {
+    return runtime_error(what + ": " + strerror(errno));
+}
+
+void set_no_delay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void send_all(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw socket_error("Ошибка отправки");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+void receive_all(int fd, uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::recv(fd, data, size, 0);
+        if (n == 0) throw runtime_error("Соединение закрыто удалённой стороной");
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw socket_error("Ошибка приёма");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+vector<uint8_t> pack_totals(const Totals& totals) {
+    Serialization::Writer out;
+    write_totals(out, totals);
+    return out.release();
+}
+
+} // namespace
+
+// ==================== СОЕДИНЕНИЯ ====================
+
+Connection::~Connection() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+Connection& Connection::operator=(Connection&& other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = other.fd_;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+Connection Connection::connect(const string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    int status = getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &found);
+    if (status != 0) {
+        throw runtime_error("Не удалось разрешить адрес " + host + ": " + gai_strerror(status));
+    }
+    int fd = -1;
+    for (addrinfo* a = found; a != nullptr; a = a->ai_next) {
+        fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(found);
+    if (fd < 0) throw socket_error("Не удалось подключиться к " + host + ":" + to_string(port));
+    set_no_delay(fd);
+    return Connection(fd);
+}
+
+void Connection::send(uint32_t type, const vector<uint8_t>& payload) {
+    uint8_t header[HEADER_SIZE];
+    uint64_t size = payload.size();
+    memcpy(header, &type, sizeof(type));
+    memcpy(header + sizeof(type), &size, sizeof(size));
+    send_all(fd_, header, HEADER_SIZE);
+    if (!payload.empty()) send_all(fd_, payload.data(), payload.size());
+}
+
+void Connection::send_raw(const string& text) {
+    send_all(fd_, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+uint32_t Connection::receive(vector<uint8_t>& payload) {
+    uint8_t header[HEADER_SIZE];
+    receive_all(fd_, header, HEADER_SIZE);
+    uint32_t type;
+    uint64_t size;
+    memcpy(&type, header, sizeof(type));
+    memcpy(&size, header + sizeof(type), sizeof(size));
+    if (size > MAX_MESSAGE) throw runtime_error("Повреждённое сообщение: длина " + to_string(size));
+    payload.resize(size);
+    if (size > 0) receive_all(fd_, payload.data(), size);
+    return type;
+}
+
+string Connection::peer_host() const {
+    sockaddr_storage addr{};
+    socklen_t length = sizeof(addr);
+    if (getpeername(fd_, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        throw socket_error("Не удалось определить адрес узла");
+    }
+    char text[INET6_ADDRSTRLEN] = {};
+    const void* raw = addr.ss_family == AF_INET6
+        ? static_cast<const void*>(&reinterpret_cast<sockaddr_in6*>(&addr)->sin6_addr)
+        : static_cast<const void*>(&reinterpret_cast<sockaddr_in*>(&addr)->sin_addr);
+    inet_ntop(addr.ss_family, raw, text, sizeof(text));
+    return text;
+}
+
+Listener::Listener(uint16_t port) : fd_(-1), port_(0) {
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) throw socket_error("Не удалось создать сокет");
+    int one = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd_, 128) != 0) {
+        runtime_error error = socket_error("Не удалось открыть порт " + to_string(port));
+        ::close(fd_);
+        throw error;
+    }
+    socklen_t length = sizeof(addr);
+    getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+}
+
+Listener::~Listener() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+Connection Listener::accept(int timeout_ms, const Connection* abort) {
+    pollfd fds[2] = {{fd_, POLLIN, 0}, {abort ? abort->fd() : -1, POLLIN, 0}};
+    while (true) {
+        int ready = ::poll(fds, abort ? 2 : 1, timeout_ms);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw socket_error("Ошибка ожидания подключения");
+        }
+        if (ready == 0) throw runtime_error("Истекло время ожидания подключения узла");
+        // После REDUCE координатор ничего не шлёт: событие на abort - разрыв
+        if (abort && fds[1].revents != 0) throw runtime_error("Координатор прервал прогон");
+        break;
+    }
+    int fd = ::accept(fd_, nullptr, nullptr);
+    if (fd < 0) throw socket_error("Ошибка приёма подключения");
+    set_no_delay(fd);
+    return Connection(fd);
+}
+
+// ==================== СВОДКИ ====================
+
+void PointTotals::merge(const PointTotals& other) {
+    replications += other.replications;
+    cpu_time_ms += other.cpu_time_ms;
+    for (const auto& [name, acc] : other.metrics) metrics[name].merge(acc);
+    for (const auto& [name, acc] : other.controlled) controlled[name].merge(acc);
+}
+
+void write_totals(Serialization::Writer& out, const Totals& totals) {
+    out.write<uint64_t>(totals.size());
+    for (const auto& [point, t] : totals) {
+        out.write<uint64_t>(point);
+        out.write<uint64_t>(t.replications);
+        out.write(t.cpu_time_ms);
+        out.write<uint64_t>(t.metrics.size());
+        for (const auto& [name, acc] : t.metrics) {
+            out.write_string(name);
+            out.write(acc);
+        }
+        out.write<uint64_t>(t.controlled.size());
+        for (const auto& [name, acc] : t.controlled) {
+            out.write_string(name);
+            out.write(acc);
+        }
+    }
+}
+
+Totals read_totals(Serialization::Reader& in) {
+    Totals totals;
+    uint64_t points = in.read<uint64_t>();
+    for (uint64_t i = 0; i < points; ++i) {
+        PointTotals& t = totals[in.read<uint64_t>()];
+        t.replications = in.read<uint64_t>();
+        in.read(t.cpu_time_ms);
+        uint64_t metrics = in.read<uint64_t>();
+        for (uint64_t m = 0; m < metrics; ++m) {
+            string name = in.read_string();
+            in.read(t.metrics[name]);
+        }
+        uint64_t controlled = in.read<uint64_t>();
+        for (uint64_t m = 0; m < controlled; ++m) {
+            string name = in.read_string();
+            in.read(t.controlled[name]);
+        }
+    }
+    return totals;
+}
+
+// ==================== КООРДИНАТОР ====================
+
+Coordinator::Coordinator(uint16_t port, int accept_timeout_ms)
+    : listener_(port), accept_timeout_ms_(accept_timeout_ms) {}
+
+Sweep::Report Coordinator::run(const SweepEngine& engine, const vector<Sweep::Point>& points,
+                               size_t workers, double time, int jobs) {
+    if (workers == 0) throw invalid_argument("Нужен хотя бы один узел");
+    if (engine.baseline() >= 0) {
+        throw invalid_argument("Распределённый перебор не поддерживает парные разности с опорной точкой");
+    }
+    auto start = chrono::steady_clock::now();
+    stats_ = Stats();
+    stats_.tasks_per_worker.assign(workers, 0);
+
+    // Решения нужны для аналитического обхода и E[загрузки] управляющей переменной
+    vector<Analytic::Result> solutions(points.size());
+    if (engine.short_circuit() || engine.control_variate()) {
+        for (size_t p = 0; p < points.size(); ++p) solutions[p] = points[p].solve();
+    }
+    vector<double> control_means(points.size(), numeric_limits<double>::quiet_NaN());
+
+    struct Job {
+        WireTask task;
+        double cost;
+    };
+    vector<Job> queue;
+    Sweep::Report report;
+    report.points.resize(points.size());
+    report.confidence = engine.confidence();
+    for (size_t p = 0; p < points.size(); ++p) {
+        Sweep::PointSummary& summary = report.points[p];
+        summary.point = points[p];
+        if (engine.short_circuit() && solutions[p].exact) {
+            summary.analytic = true;
+            summary.exact = solutions[p].metrics();
+            continue;
+        }
+        if (engine.control_variate() && solutions[p].utilization_known) {
+            summary.control_mean = control_means[p] = solutions[p].utilization;
+        }
+        for (size_t r = 0; r < engine.replications(); ++r) {
+            queue.push_back(Job{WireTask{static_cast<uint32_t>(p), static_cast<uint32_t>(r)},
+                                SweepEngine::cost(points[p], time, jobs)});
+        }
+    }
+    stable_sort(queue.begin(), queue.end(), [](const Job& a, const Job& b) { return a.cost > b.cost; });
+    stats_.tasks = queue.size();
+
+    // Подключение узлов
+    struct Node {
+        Connection connection;
+        string host;
+        uint16_t port;
+    };
+    vector<Node> nodes;
+    vector<uint8_t> payload;
+    for (size_t i = 0; i < workers; ++i) {
+        Connection c = listener_.accept(accept_timeout_ms_);
+        if (c.receive(payload) != HELLO) throw runtime_error("Узел не представился");
+        Serialization::Reader in(payload);
+        uint16_t port = in.read<uint16_t>();
+        string host = c.peer_host();
+        nodes.push_back(Node{std::move(c), std::move(host), port});
+    }
+
+    Serialization::Writer plan;
+    plan.write(engine.master_seed());
+    plan.write<uint64_t>(engine.replications());
+    plan.write(engine.common_random_numbers());
+    plan.write(time);
+    plan.write(jobs);
+    plan.write_vector(points);
+    plan.write_vector(control_means);
+    for (Node& node : nodes) node.connection.send(PLAN, plan.data());
+
+    // Раздача по запросам: порция - доля 1 / (2n) оставшейся стоимости
+    double remaining = 0.0;
+    for (const Job& job : queue) remaining += job.cost;
+    size_t next = 0, reduced = 0, finished = 0;
+    bool summary_received = false;
+    Totals totals;
+
+    vector<pollfd> fds(workers);
+    for (size_t i = 0; i < workers; ++i) fds[i] = pollfd{nodes[i].connection.fd(), POLLIN, 0};
+    // Корень присылает сводку, остальные узлы - DONE; разрыв без них - сбой
+    while (!summary_received || finished < workers - 1) {
+        int ready = ::poll(fds.data(), fds.size(), -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw socket_error("Ошибка ожидания узлов");
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            if (fds[i].revents == 0) continue;
+            uint32_t type;
+            try {
+                type = nodes[i].connection.receive(payload);
+            } catch (const exception& e) {
+                throw runtime_error("Узел " + to_string(i) + ": " + e.what());
+            }
+            if (type == FAILURE) {
+                Serialization::Reader in(payload);
+                throw runtime_error("Узел " + to_string(i) + ": " + in.read_string());
+            }
+            if (type == SUMMARY && i == 0) {
+                Serialization::Reader in(payload);
+                totals = read_totals(in);
+                summary_received = true;
+                fds[i].fd = -1;
+                continue;
+            }
+            if (type == DONE && i > 0) {
+                finished++;
+                fds[i].fd = -1;
+                continue;
+            }
+            if (type != REQUEST) throw runtime_error("Неожиданное сообщение от узла " + to_string(i));
+
+            if (next < queue.size()) {
+                double target = remaining / (2.0 * workers);
+                vector<WireTask> chunk;
+                double taken = 0.0;
+                while (next < queue.size() && (chunk.empty() || taken + queue[next].cost <= target)) {
+                    chunk.push_back(queue[next].task);
+                    taken += queue[next].cost;
+                    next++;
+                }
+                remaining -= taken;
+                stats_.chunks++;
+                stats_.tasks_per_worker[i] += chunk.size();
+                Serialization::Writer out;
+                out.write_vector(chunk);
+                nodes[i].connection.send(TASKS, out.data());
+            } else {
+                // Дерево сводок: родитель узла i - (i-1)/2, корень шлёт координатору
+                Serialization::Writer out;
+                out.write_string(i == 0 ? string() : nodes[(i - 1) / 2].host);
+                out.write<uint16_t>(i == 0 ? 0 : nodes[(i - 1) / 2].port);
+                uint32_t children = 0;
+                for (size_t child : {2 * i + 1, 2 * i + 2}) children += child < workers;
+                out.write(children);
+                nodes[i].connection.send(REDUCE, out.data());
+                reduced++;
+            }
+        }
+    }
+    if (reduced != workers) throw runtime_error("Сводка получена до завершения всех узлов");
+
+    size_t collected = 0;
+    for (auto& [p, t] : totals) {
+        if (p >= points.size()) throw runtime_error("Сводка содержит точку вне плана");
+        Sweep::PointSummary& summary = report.points[p];
+        summary.replications = t.replications;
+        summary.cpu_time_ms = t.cpu_time_ms;
+        summary.metrics = std::move(t.metrics);
+        summary.controlled = std::move(t.controlled);
+        collected += t.replications;
+    }
+    if (collected != queue.size()) {
+        throw runtime_error("Сводка неполна: " + to_string(collected) + " из " + to_string(queue.size()) +
+                            " репликаций");
+    }
+
+    report.wall_time_ms = stats_.wall_time_ms =
+        chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+// ==================== УЗЕЛ ====================
+
+size_t Worker::serve(const SweepEngine::Simulate& simulate) {
+    Listener children(0);
+    Connection control = Connection::connect(host_, port_);
+    Serialization::Writer hello;
+    hello.write<uint16_t>(children.port());
+    control.send(HELLO, hello.data());
+
+    vector<uint8_t> payload;
+    if (control.receive(payload) != PLAN) throw runtime_error("Ожидался план перебора");
+    Serialization::Reader plan(payload);
+    uint64_t master_seed = plan.read<uint64_t>();
+    uint64_t replications = plan.read<uint64_t>();
+    bool common_random_numbers = plan.read<bool>();
+    double time = plan.read<double>();
+    int jobs = plan.read<int>();
+    vector<Sweep::Point> points;
+    vector<double> control_means;
+    plan.read_vector(points);
+    plan.read_vector(control_means);
+
+    SweepEngine::Simulate model = simulate ? simulate : SweepEngine::standard(time, jobs);
+    Totals totals;
+    size_t done = 0;
+    string parent_host;
+    uint16_t parent_port = 0;
+    uint32_t child_count = 0;
+    try {
+        while (true) {
+            control.send(REQUEST);
+            uint32_t type = control.receive(payload);
+            Serialization::Reader in(payload);
+            if (type == REDUCE) {
+                parent_host = in.read_string();
+                parent_port = in.read<uint16_t>();
+                child_count = in.read<uint32_t>();
+                break;
+            }
+            if (type != TASKS) throw runtime_error("Неожиданное сообщение координатора");
+            vector<WireTask> chunk;
+            in.read_vector(chunk);
+            for (const WireTask& task : chunk) {
+                if (task.point >= points.size()) throw runtime_error("Задание вне плана");
+                uint64_t seed = SweepEngine::seed_for(master_seed, replications, common_random_numbers,
+                                                      task.point, task.replication);
+                auto start = chrono::steady_clock::now();
+                ReplicationMetrics metrics = model(points[task.point], seed);
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+                PointTotals& t = totals[task.point];
+                t.replications++;
+                t.cpu_time_ms += ms;
+                auto control_value = metrics.find("server_utilization");
+                bool controlled = !std::isnan(control_means[task.point]) && control_value != metrics.end();
+                for (const auto& [name, value] : metrics) {
+                    t.metrics[name].add(value);
+                    if (controlled) t.controlled[name].add(value, control_value->second);
+                }
+                done++;
+            }
+        }
+
+        // Сводки поддерева: сначала дочерние узлы, затем передача родителю
+        for (uint32_t k = 0; k < child_count; ++k) {
+            Connection child = children.accept(-1, &control);
+            if (child.receive(payload) != SUMMARY) throw runtime_error("Ожидалась сводка дочернего узла");
+            Serialization::Reader in(payload);
+            for (auto& [point, t] : read_totals(in)) totals[point].merge(t);
+        }
+    } catch (const exception& e) {
+        Serialization::Writer failure;
+        failure.write_string(e.what());
+        try {
+            control.send(FAILURE, failure.data());
+        } catch (...) {
+        }
+        throw;
+    }
+
+    if (parent_host.empty()) {
+        control.send(SUMMARY, pack_totals(totals));
+    } else {
+        Connection::connect(parent_host, parent_port).send(SUMMARY, pack_totals(totals));
+        control.send(DONE);
+    }
+    return done;
+}
+
+// ==================== ЛОКАЛЬНЫЕ УЗЛЫ ====================
+
+LocalWorkers::LocalWorkers(size_t count, uint16_t port, const SweepEngine::Simulate& simulate,
+                           const string& host) {
+    for (size_t i = 0; i < count; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) throw socket_error("Не удалось запустить узел");
+        if (pid == 0) {
+            // Дочерний процесс не разделяет потоков родителя: только моделирование и _exit
+            int code = 0;
+            try {
+                Worker(host, port).serve(simulate);
+            } catch (...) {
+                code = 1;
+            }
+            _exit(code);
+        }
+        children_.push_back(pid);
+    }
+}
+
+LocalWorkers::~LocalWorkers() {
+    wait();
+}
+
+bool LocalWorkers::wait() {
+    bool ok = true;
+    for (pid_t pid : children_) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+    }
+    children_.clear();
+    return ok;
+}
+
+// ==================== ТЕЛЕМЕТРИЯ ====================
+
+Telemetry::Exporter::LineWriter telemetry_stream(const string& host, uint16_t port) {
+    auto connection = make_shared<Connection>(Connection::connect(host, port));
+    return [connection](const string& lines) { connection->send_raw(lines); };
+}
+
+} // namespace Distributed
@@ -0,0 +1,194 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "sweep_engine.h"
+#include "common/serialization.h"
+#include "common/telemetry.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <sys/types.h>
+
+namespace Distributed {
+
+/**
+ * Соединение TCP с кадрированием сообщений: [тип uint32][длина uint64][данные]
+ * Ошибки сети и разрыв соединения - исключения runtime_error.
+ */
+class Connection {
+private:
+    int fd_;
+
+public:
+    explicit Connection(int fd = -1) : fd_(fd) {}
+    ~Connection();
+    Connection(Connection&& other) noexcept : fd_(other.fd_) { other.fd_ = -1; }
+    Connection& operator=(Connection&& other) noexcept;
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    static Connection connect(const std::string& host, uint16_t port);
+
+    void send(uint32_t type, const std::vector<uint8_t>& payload = {});
+    uint32_t receive(std::vector<uint8_t>& payload);
+    
+    // Байты без кадрирования - для текстовых потоков (telemetry_stream)
+    void send_raw(const std::string& text);
+
+    int fd() const { return fd_; }
+    bool open() const { return fd_ >= 0; }
+    std::string peer_host() const;
+};
+
+/**
+ * Слушающий сокет на всех интерфейсах; port = 0 - выбрать свободный порт
+ */
+class Listener {
+private:
+    int fd_;
+    uint16_t port_;
+
+public:
+    explicit Listener(uint16_t port = 0);
+    ~Listener();
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+
+    // Ожидание входящего соединения; timeout_ms < 0 - без ограничения.
+    // Если задан abort и он закрылся, ожидание прерывается исключением.
+    Connection accept(int timeout_ms = -1, const Connection* abort = nullptr);
+
+    uint16_t port() const { return port_; }
+};
+
+/**
+ * Сводка узла по точкам плана: только объединяемые накопители
+ * (сырые выборки не передаются по сети)
+ */
+struct PointTotals {
+    size_t replications = 0;
+    double cpu_time_ms = 0.0;
+    std::map<std::string, Statistics::StreamingAccumulator> metrics;
+    std::map<std::string, Statistics::ControlVariateAccumulator> controlled;
+
+    void merge(const PointTotals& other);
+};
+
+using Totals = std::map<size_t, PointTotals>;    // номер точки → сводка
+
+void write_totals(Serialization::Writer& out, const Totals& totals);
+Totals read_totals(Serialization::Reader& in);
+
+// ==================== КООРДИНАТОР ====================
+
+/**
+ * Координатор распределённого перебора: очередь заданий для узлов по TCP
+ *
+ * Узлы (Worker) подключаются к координатору и получают план: точки,
+ * горизонт, зерно и режимы SweepEngine. Задания (точка, репликация)
+ * упорядочены по стоимости по убыванию и раздаются по запросу узла
+ * порциями, стоимость которых - доля 1 / (2n) оставшейся работы (guided
+ * self-scheduling): длинные точки с высокой ρ уходят первыми по одной,
+ * хвост из коротких точек расходится мелкими порциями, и узлы
+ * заканчивают почти одновременно.
+ *
+ * Зерно репликации - SweepEngine::seed_for(точка, репликация), а не номер
+ * узла, поэтому потоки разных узлов не пересекаются, и результат не
+ * зависит от распределения заданий. Каждый узел копит по точкам только
+ * потоковые накопители; по окончании заданий узлы сливают сводки по
+ * двоичному дереву (узел i принимает сводки узлов 2i+1 и 2i+2 и передаёт
+ * объединённую родителю (i-1)/2), и координатор получает одну сводку от
+ * корня. Порядок объединения зависит от распределения, поэтому средние
+ * совпадают с локальным прогоном с точностью до округления.
+ *
+ * Репликации одной конфигурации (ReplicationRunner) - план из одной точки.
+ * Парные разности с опорной точкой и файл строк (set_output) не поддерживаются:
+ * они требуют отдельных значений репликаций.
+ */
+class Coordinator {
+public:
+    struct Stats {
+        size_t tasks = 0;
+        size_t chunks = 0;                     // выданных порций
+        std::vector<size_t> tasks_per_worker;
+        double wall_time_ms = 0.0;
+    };
+
+private:
+    Listener listener_;
+    int accept_timeout_ms_;
+    Stats stats_;
+
+public:
+    /**
+     * @param port порт для подключения узлов (0 - свободный, см. port())
+     * @param accept_timeout_ms сколько ждать подключения всех узлов
+     */
+    explicit Coordinator(uint16_t port = 0, int accept_timeout_ms = 30000);
+
+    uint16_t port() const { return listener_.port(); }
+
+    /**
+     * Прогон плана на workers узлах: режимы (зерно, репликации, общие числа,
+     * аналитический обход, управляющая переменная) берутся из engine
+     * @param jobs предел заданий вместо горизонта (0 - по времени)
+     */
+    Sweep::Report run(const SweepEngine& engine, const std::vector<Sweep::Point>& points,
+                      size_t workers, double time, int jobs = 0);
+
+    const Stats& stats() const { return stats_; }
+};
+
+// ==================== УЗЕЛ ====================
+
+/**
+ * Вычислительный узел: один процесс - один поток моделирования
+ * (как ранг MPI). Запускается на каждой машине по числу ядер.
+ */
+class Worker {
+private:
+    std::string host_;
+    uint16_t port_;
+
+public:
+    Worker(std::string host, uint16_t port) : host_(std::move(host)), port_(port) {}
+
+    /**
+     * Обслуживает один план до конца; simulate должна совпадать с моделью,
+     * которую ожидает координатор (пустая - SweepEngine::standard(time, jobs)
+     * из плана). Возвращает число выполненных репликаций.
+     */
+    size_t serve(const SweepEngine::Simulate& simulate = {});
+};
+
+/**
+ * Узлы на этой машине дочерними процессами (fork): несколько узлов на
+ * многоядерной машине или проверка без кластера. Деструктор дожидается
+ * завершения процессов.
+ */
+class LocalWorkers {
+private:
+    std::vector<pid_t> children_;
+
+public:
+    LocalWorkers(size_t count, uint16_t port, const SweepEngine::Simulate& simulate = {},
+                 const std::string& host = "127.0.0.1");
+    ~LocalWorkers();
+    LocalWorkers(const LocalWorkers&) = delete;
+    LocalWorkers& operator=(const LocalWorkers&) = delete;
+
+    // Ожидание завершения; true - все узлы вышли успешно
+    bool wait();
+};
+
+/**
+ * Выгрузка телеметрии по TCP для Telemetry::Exporter: строки JSON без
+ * кадрирования, читаемые любым клиентом (например, nc -l порт).
+ * Соединение открывается сразу; разрыв - исключение из Exporter::stop().
+ */
+Telemetry::Exporter::LineWriter telemetry_stream(const std::string& host, uint16_t port);
+
+} // namespace Distributed
+
+#endif // CLUSTER_H
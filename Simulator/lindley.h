@@ -0,0 +1,232 @@
+#ifndef LINDLEY_H
+#define LINDLEY_H
+
+#include "simulator.h"
+#include "common/random_generator.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * Пакетный движок G/G/1 FIFO с бесконечным буфером по рекурсии Линдли
+ *
+ * При одном ядре и FIFO задания уходят в порядке прихода, и вся траектория
+ * задаётся рекурсией без множества событий:
+ *     a_k = a_{k-1} + A_k,  start_k = max(a_k, d_{k-1}),  d_k = start_k + S_k,
+ * то есть W_k = max(0, W_{k-1} + S_{k-1} - A_k). Времена считаются теми же
+ * операциями, что и в цикле событий Simulator, а генераторы засеваются как в
+ * Simulator::seed() и читаются по порядку, поэтому при одном зерне моменты
+ * прихода, начала и ухода совпадают с Simulator побитно. Показатели
+ * (metrics()) совпадают с ReplicationRunner::collect_metrics() с точностью
+ * до порядка суммирования.
+ *
+ * Репликации идут дорожками вектора Vector (2 на SSE2, 4 с -mavx2, 8 с
+ * -mavx512f): прогоны группы продвигаются в ногу по одному заданию за шаг,
+ * окончание по горизонту - маской, а величины берутся у генераторов дорожек
+ * пакетами generate_batch() по BLOCK. Остаток, не кратный LANES, считается
+ * тем же кодом со скалярами.
+ *
+ * Квантили, P(n) и контрольные точки не поддерживаются - для них нужен Simulator.
+ */
+namespace Lindley {
+
+// Ширина дорожек - по набору команд сборки: 256-битные сравнения без AVX
+// GCC разворачивает в скалярный код, поэтому на SSE2 дорожек две
+#if defined(__AVX512F__)
+constexpr size_t LANES = 8;
+#elif defined(__AVX__)
+constexpr size_t LANES = 4;
+#else
+constexpr size_t LANES = 2;
+#endif
+typedef double Vector __attribute__((vector_size(LANES * sizeof(double))));
+
+constexpr size_t BLOCK = 256;       // заданий за один пакет величин
+
+// Подходит ли конфигурация для рекурсии (остальное моделирует Simulator)
+inline bool applicable(int cores, int buffer, QueueDisciplines::QueueStrategyFactory<Job>::Type discipline) {
+    return cores == 1 && buffer < 0 && discipline == QueueDisciplines::QueueStrategyFactory<Job>::Type::FIFO;
+}
+
+/**
+ * Итог одной репликации: суммы за окно [0, observed_time]
+ */
+struct Replication {
+    double observed_time = 0.0;
+    double arrivals = 0.0;          // пришло к концу окна
+    double completed = 0.0;         // ушло к концу окна
+    double work = 0.0;              // работа пришедших заданий
+    double wait_sum = 0.0;          // по ушедшим заданиям
+    double system_sum = 0.0;
+    double busy_time = 0.0;
+    double queue_area = 0.0;        // интеграл длины очереди
+    double system_area = 0.0;       // интеграл числа заданий в системе
+    double rho = 0.0;
+
+    // Те же имена и определения, что у ReplicationRunner::collect_metrics()
+    std::map<std::string, double> metrics() const {
+        double t = observed_time > 0.0 ? observed_time : 0.0;
+        auto per_time = [t](double area) { return t > 0.0 ? area / t : 0.0; };
+        auto per_job = [](double sum, double count) { return count > 0.0 ? sum / count : 0.0; };
+        return {
+            {"avg_wait_time", per_job(wait_sum, completed)},
+            {"avg_system_time", per_job(system_sum, completed)},
+            {"server_utilization", per_time(busy_time)},
+            {"loss_probability", 0.0},
+            {"avg_queue_length", per_time(queue_area)},
+            {"avg_jobs_in_system", per_time(system_area)},
+            {"rho", rho},
+            {"jobs_completed", completed},
+            {"sampled_interarrival_time", arrivals > 0.0 ? t / arrivals : 0.0},
+            {"sampled_service_time", per_job(work, arrivals)}
+        };
+    }
+};
+
+namespace detail {
+
+// Состояние группы дорожек: V - double (одна дорожка) или Vector (LANES дорожек)
+template<typename V>
+struct Lanes {
+    V arrival{}, departure{}, horizon{};
+    V arrivals{}, completed{}, work{}, wait{}, system{}, busy{}, queue{}, occupancy{};
+
+    // Одно задание на каждой дорожке; за горизонтом вклад нулевой
+    void step(const V& interval, const V& service) {
+        const V zero{};
+        const V one = zero + 1.0;
+        arrival += interval;
+        V start = arrival > departure ? arrival : departure;
+        V finish = start + service;
+
+        auto admitted = arrival <= horizon;
+        auto done = finish <= horizon;
+        arrivals += admitted ? one : zero;
+        work += admitted ? service : zero;
+        completed += done ? one : zero;
+        wait += done ? start - arrival : zero;
+        system += done ? finish - arrival : zero;
+
+        // Вклады в интегралы по окну [0, horizon]: после горизонта разности нулевые
+        V a = arrival < horizon ? arrival : horizon;
+        V s = start < horizon ? start : horizon;
+        V f = finish < horizon ? finish : horizon;
+        busy += f - s;
+        queue += s - a;
+        occupancy += f - a;
+        departure = finish;
+    }
+};
+
+inline double lane(double v, size_t) { return v; }
+inline double lane(const Vector& v, size_t j) { return v[j]; }
+
+// Загрузка width соседних значений одним вектором
+template<typename V>
+inline V load(const double* p) {
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+} // namespace detail
+
+/**
+ * Движок для пары распределений; генераторы копируются на каждую дорожку
+ */
+class BatchEngine {
+private:
+    std::unique_ptr<RandomGenerator> arrival_;
+    std::unique_ptr<RandomGenerator> service_;
+    double rho_;
+
+    // Прогон width дорожек (1 или LANES) до горизонта time или до jobs ушедших
+    template<typename V>
+    void run_group(const uint64_t* seeds, size_t width, double time, long long jobs, Replication* out) const {
+        std::vector<std::unique_ptr<RandomGenerator>> arrivals, services;
+        for (size_t j = 0; j < width; ++j) {
+            arrivals.push_back(arrival_->clone());
+            services.push_back(service_->clone());
+            arrivals[j]->seed(GeneratorFactory::derive_seed(seeds[j], 0, GeneratorFactory::ARRIVAL_STREAM));
+            services[j]->seed(GeneratorFactory::derive_seed(seeds[j], 0, GeneratorFactory::SERVICE_STREAM));
+        }
+
+        detail::Lanes<V> lanes;
+        const double limit = jobs > 0 ? std::numeric_limits<double>::infinity() : time;
+        lanes.horizon = V{} + limit;
+        // Пакеты величин дорожек, переставленные в порядок [задание][дорожка]
+        std::vector<double> intervals(BLOCK * width), works(BLOCK * width);
+        double buffer[BLOCK];
+        long long job = 0;
+        bool running = true;
+        while (running) {
+            for (size_t j = 0; j < width; ++j) {
+                arrivals[j]->generate_batch(buffer, BLOCK);
+                for (size_t k = 0; k < BLOCK; ++k) intervals[k * width + j] = buffer[k];
+                services[j]->generate_batch(buffer, BLOCK);
+                for (size_t k = 0; k < BLOCK; ++k) works[k * width + j] = buffer[k];
+            }
+            for (size_t k = 0; k < BLOCK; ++k, ++job) {
+                lanes.step(detail::load<V>(&intervals[k * width]), detail::load<V>(&works[k * width]));
+                // Останов по числу заданий: окно кончается уходом задания номер jobs
+                if (job + 1 == jobs) lanes.horizon = lanes.departure;
+            }
+            running = false;
+            for (size_t j = 0; j < width; ++j) {
+                running |= detail::lane(lanes.arrival, j) <= detail::lane(lanes.horizon, j);
+            }
+        }
+
+        for (size_t j = 0; j < width; ++j) {
+            Replication& r = out[j];
+            r.observed_time = detail::lane(lanes.horizon, j);
+            r.arrivals = detail::lane(lanes.arrivals, j);
+            r.completed = detail::lane(lanes.completed, j);
+            r.work = detail::lane(lanes.work, j);
+            r.wait_sum = detail::lane(lanes.wait, j);
+            r.system_sum = detail::lane(lanes.system, j);
+            r.busy_time = detail::lane(lanes.busy, j);
+            r.queue_area = detail::lane(lanes.queue, j);
+            r.system_area = detail::lane(lanes.occupancy, j);
+            r.rho = rho_;
+        }
+    }
+
+    std::vector<Replication> run_all(const std::vector<uint64_t>& seeds, double time, long long jobs) const {
+        std::vector<Replication> results(seeds.size());
+        size_t full = seeds.size() - seeds.size() % LANES;
+        for (size_t i = 0; i < full; i += LANES) {
+            run_group<Vector>(seeds.data() + i, LANES, time, jobs, results.data() + i);
+        }
+        for (size_t i = full; i < seeds.size(); ++i) {
+            run_group<double>(seeds.data() + i, 1, time, jobs, results.data() + i);
+        }
+        return results;
+    }
+
+public:
+    BatchEngine(const RandomGenerator& arrival, const RandomGenerator& service)
+        : arrival_(arrival.clone()), service_(service.clone()),
+          rho_(arrival.mean() > 0.0 ? service.mean() / arrival.mean() : 0.0) {}
+
+    /**
+     * Репликации с зёрнами seeds (как Simulator::seed) до модельного времени time
+     */
+    std::vector<Replication> run(const std::vector<uint64_t>& seeds, double time) const {
+        return run_all(seeds, time, 0);
+    }
+
+    // До ухода jobs заданий (как Simulator::run_until_jobs)
+    std::vector<Replication> run_until_jobs(const std::vector<uint64_t>& seeds, long long jobs) const {
+        if (jobs <= 0) throw std::invalid_argument("Число заданий должно быть положительным");
+        return run_all(seeds, 0.0, jobs);
+    }
+};
+
+} // namespace Lindley
+
+#endif // LINDLEY_H
@@ -1,8 +1,10 @@
 #include "parallel_final.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
-        ParallelFinal test;
+        // Необязательный аргумент - размещение потоков пула: none, compact, scatter, no_smt
+        Parallel::Affinity affinity = argc > 1 ? Parallel::parse_affinity(argv[1]) : Parallel::Affinity::NONE;
+        ParallelFinal test(ParallelFinal::DEFAULT_SEED, affinity);
         test.run_complete_test();
     } catch (const exception& e) {
         cerr << "Ошибка: " << e.what() << endl;
@@ -0,0 +1,393 @@
+#include "multiclass_simulator.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+// ==================== ДИСЦИПЛИНЫ ====================
+
+string MultiClassSimulator::scheduling_name(Scheduling scheduling) {
+    switch (scheduling) {
+        case Scheduling::FIFO: return "FIFO";
+        case Scheduling::PRIORITY: return "PRIORITY";
+        case Scheduling::PREEMPTIVE_PRIORITY: return "PREEMPTIVE_PRIORITY";
+        case Scheduling::SPT: return "SPT";
+        case Scheduling::SRPT: return "SRPT";
+    }
+    return "UNKNOWN";
+}
+
+vector<MultiClassSimulator::Scheduling> MultiClassSimulator::all_schedulings() {
+    return {
+        Scheduling::FIFO,
+        Scheduling::PRIORITY,
+        Scheduling::PREEMPTIVE_PRIORITY,
+        Scheduling::SPT,
+        Scheduling::SRPT
+    };
+}
+
+bool MultiClassSimulator::preemptive() const {
+    return scheduling_ == Scheduling::PREEMPTIVE_PRIORITY || scheduling_ == Scheduling::SRPT;
+}
+
+MultiClassSimulator::ReadyKey MultiClassSimulator::key_of(const ClassJob& job) const {
+    switch (scheduling_) {
+        case Scheduling::PRIORITY:
+        case Scheduling::PREEMPTIVE_PRIORITY:
+            return ReadyKey{static_cast<double>(classes_[job.job_class].priority), job.id};
+        case Scheduling::SPT:
+            return ReadyKey{job.service_time, job.id};
+        case Scheduling::SRPT:
+            return ReadyKey{job.remaining, job.id};
+        case Scheduling::FIFO:
+            break;
+    }
+    return ReadyKey{0.0, job.id};
+}
+
+MultiClassSimulator::ReadyKey MultiClassSimulator::service_key(int core) const {
+    const ClassJob& job = jobs_[cores_.current_job(core)];
+    if (scheduling_ == Scheduling::SRPT) {
+        return ReadyKey{cores_.finish_time(core) - current_time_, job.id};
+    }
+    return key_of(job);
+}
+
+// ==================== КЛАСС ЗАДАНИЙ ====================
+
+MultiClassSimulator::JobClass::JobClass(unique_ptr<RandomGenerator> arrival_gen,
+                                        unique_ptr<RandomGenerator> service_gen, int class_priority)
+    : arrivals(std::move(arrival_gen)),
+      service(std::move(service_gen)),
+      priority(class_priority) {
+    reset();
+}
+
+void MultiClassSimulator::JobClass::reset() {
+    arrival_count = 0;
+    completed = 0;
+    lost = 0;
+    preemptions = 0;
+    wait.reset();
+    response.reset();
+}
+
+// ==================== КОНСТРУКТОР И ПОСТРОЕНИЕ ====================
+
+MultiClassSimulator::MultiClassSimulator(int num_cores, int buffer_cap, Scheduling scheduling)
+    : scheduling_(scheduling),
+      buffer_capacity_(buffer_cap),
+      cores_(num_cores),
+      departure_id_(num_cores, -1),
+      current_time_(0.0),
+      next_event_seq_(0),
+      events_processed_(0),
+      next_job_id_(0),
+      total_arrivals_(0),
+      jobs_completed_(0),
+      jobs_lost_(0),
+      preemptions_(0),
+      queue_area_(0.0),
+      last_update_(0.0) {
+    if (buffer_cap < -1) {
+        throw invalid_argument("Ёмкость буфера должна быть неотрицательной или -1");
+    }
+}
+
+void MultiClassSimulator::check_class(int job_class) const {
+    if (job_class < 0 || job_class >= class_count()) {
+        throw out_of_range("Неверный номер класса");
+    }
+}
+
+int MultiClassSimulator::add_class(unique_ptr<RandomGenerator> arrival_gen,
+                                   unique_ptr<RandomGenerator> service_gen, int priority) {
+    if (!arrival_gen || !service_gen) {
+        throw invalid_argument("Классу нужны генераторы прибытий и обслуживания");
+    }
+    classes_.emplace_back(std::move(arrival_gen), std::move(service_gen), priority);
+    return class_count() - 1;
+}
+
+void MultiClassSimulator::seed(uint64_t seed) {
+    for (size_t k = 0; k < classes_.size(); ++k) {
+        JobClass& cls = classes_[k];
+        cls.arrivals->seed(GeneratorFactory::derive_seed(seed, k, GeneratorFactory::ARRIVAL_STREAM));
+        cls.service->seed(GeneratorFactory::derive_seed(seed, k, GeneratorFactory::SERVICE_STREAM));
+        cls.arrival_variates.reset();
+        cls.service_variates.reset();
+    }
+}
+
+// ==================== ИНИЦИАЛИЗАЦИЯ ====================
+
+void MultiClassSimulator::initialize() {
+    if (classes_.empty()) {
+        throw logic_error("В системе нет классов заданий");
+    }
+
+    current_time_ = 0.0;
+    next_event_seq_ = 0;
+    events_processed_ = 0;
+    next_job_id_ = 0;
+    total_arrivals_ = 0;
+    jobs_completed_ = 0;
+    jobs_lost_ = 0;
+    preemptions_ = 0;
+    wait_.reset();
+    response_.reset();
+    queue_area_ = 0.0;
+    last_update_ = 0.0;
+
+    events_.clear();
+    ready_.clear();
+    jobs_.clear();
+    cores_.reset();
+    fill(departure_id_.begin(), departure_id_.end(), -1);
+    for (JobClass& cls : classes_) cls.reset();
+
+    for (int k = 0; k < class_count(); ++k) schedule_arrival(k);
+}
+
+// ==================== ГЛАВНЫЙ ЦИКЛ МОДЕЛИРОВАНИЯ ====================
+
+void MultiClassSimulator::run(double simulation_time) {
+    initialize();
+    advance(simulation_time, numeric_limits<long long>::max());
+}
+
+void MultiClassSimulator::run_until_jobs(long long jobs_to_complete) {
+    initialize();
+    advance(numeric_limits<double>::infinity(), jobs_to_complete);
+}
+
+void MultiClassSimulator::advance(double time_limit, long long jobs_limit) {
+    while (!events_.empty() && events_.top().time <= time_limit && jobs_completed_ < jobs_limit) {
+        ClassEvent event = events_.pop();
+        events_processed_++;
+        current_time_ = event.time;
+
+        switch (event.type) {
+            case ClassEvent::ARRIVAL:
+                process_arrival(event.job_class);
+                break;
+            case ClassEvent::DEPARTURE:
+                process_departure(event.job_handle, event.core_id);
+                break;
+        }
+    }
+
+    // При остановке по времени модельное время доводится до горизонта
+    if (jobs_completed_ < jobs_limit && isfinite(time_limit)) {
+        current_time_ = max(current_time_, time_limit);
+    }
+    integrate();
+}
+
+// ==================== ОБРАБОТКА СОБЫТИЙ ====================
+
+// Вызывается до изменения очереди: с прошлого обновления её длина была постоянной
+void MultiClassSimulator::integrate() {
+    double dt = current_time_ - last_update_;
+    if (dt > 0.0) {
+        queue_area_ += dt * static_cast<double>(ready_.size());
+        last_update_ = current_time_;
+    }
+}
+
+void MultiClassSimulator::process_arrival(int job_class) {
+    JobClass& cls = classes_[job_class];
+    total_arrivals_++;
+    cls.arrival_count++;
+    integrate();
+
+    double service_time = cls.service_variates.next(*cls.service);
+    int handle = jobs_.emplace(next_job_id_++, job_class, current_time_, service_time);
+
+    int core = cores_.acquire(handle, current_time_, current_time_ + service_time);
+    if (core != -1) {
+        start_service(handle, core);
+    } else if (buffer_capacity_ != -1 && static_cast<int>(ready_.size()) >= buffer_capacity_) {
+        // Буфер полон - задание теряется, никого не вытесняя
+        cls.lost++;
+        jobs_lost_++;
+        jobs_.release(handle);
+    } else {
+        ReadyKey key = key_of(jobs_[handle]);
+        int victim = preemptive() ? preemption_victim(key) : -1;
+        if (victim != -1) {
+            preempt(victim, handle);
+        } else {
+            ready_.push(handle, key);
+        }
+    }
+
+    schedule_arrival(job_class);
+}
+
+void MultiClassSimulator::process_departure(int job_handle, int core_id) {
+    integrate();
+
+    const ClassJob& job = jobs_[job_handle];
+    JobClass& cls = classes_[job.job_class];
+    double response = current_time_ - job.arrival_time;
+    // Без вытеснения разность равна ожиданию до начала обслуживания с точностью округления
+    double wait = max(0.0, response - job.service_time);
+    cls.completed++;
+    cls.wait.add(wait);
+    cls.response.add(response);
+    wait_.add(wait);
+    response_.add(response);
+    jobs_completed_++;
+    jobs_.release(job_handle);
+    departure_id_[core_id] = -1;
+
+    // Ядро переходит к лучшему ожидающему заданию без освобождения
+    if (!ready_.empty()) {
+        start_service(ready_.pop(), core_id);
+    } else {
+        cores_.release(core_id, current_time_);
+    }
+}
+
+void MultiClassSimulator::start_service(int job_handle, int core_id) {
+    ClassJob& job = jobs_[job_handle];
+    job.core = core_id;
+    double finish = current_time_ + job.remaining;
+    cores_.reassign(core_id, job_handle, finish);
+    departure_id_[core_id] = push_event(ClassEvent(finish, job_handle, core_id));
+}
+
+// Ядро с худшим по ключу заданием, если прибывшее строго лучше его; иначе -1
+int MultiClassSimulator::preemption_victim(const ReadyKey& arriving) const {
+    int victim = -1;
+    ReadyKey worst{-numeric_limits<double>::infinity(), -1};
+    for (int core = 0; core < cores_.size(); ++core) {
+        ReadyKey key = service_key(core);
+        if (worst < key) {
+            worst = key;
+            victim = core;
+        }
+    }
+    return arriving.primary < worst.primary ? victim : -1;
+}
+
+void MultiClassSimulator::preempt(int core_id, int job_handle) {
+    int victim = cores_.current_job(core_id);
+    events_.cancel(departure_id_[core_id]);
+
+    ClassJob& job = jobs_[victim];
+    job.remaining = cores_.finish_time(core_id) - current_time_;
+    job.core = -1;
+    ready_.push(victim, key_of(job));
+    classes_[job.job_class].preemptions++;
+    preemptions_++;
+
+    start_service(job_handle, core_id);
+}
+
+// ==================== ПЛАНИРОВАНИЕ ====================
+
+void MultiClassSimulator::schedule_arrival(int job_class) {
+    JobClass& cls = classes_[job_class];
+    double interval = cls.arrival_variates.next(*cls.arrivals);
+    push_event(ClassEvent(current_time_ + interval, job_class));
+}
+
+int MultiClassSimulator::push_event(ClassEvent event) {
+    event.seq = next_event_seq_++;
+    return events_.schedule(event);
+}
+
+// ==================== СТАТИСТИКА ====================
+
+MultiClassSimulator::ClassResults MultiClassSimulator::class_results(int job_class) const {
+    check_class(job_class);
+    const JobClass& cls = classes_[job_class];
+    double T = current_time_;
+
+    ClassResults r;
+    r.priority = cls.priority;
+    r.arrivals = cls.arrival_count;
+    r.completed = cls.completed;
+    r.lost = cls.lost;
+    r.preemptions = cls.preemptions;
+    r.throughput = T > 0.0 ? cls.completed / T : 0.0;
+    r.avg_wait_time = cls.wait.mean();
+    r.avg_response_time = cls.response.mean();
+    r.wait_time_variance = cls.wait.variance();
+    return r;
+}
+
+double MultiClassSimulator::avg_queue_length() const {
+    return current_time_ > 0.0 ? queue_area_ / current_time_ : 0.0;
+}
+
+double MultiClassSimulator::server_utilization() const {
+    if (current_time_ <= 0.0) return 0.0;
+    double busy = 0.0;
+    for (int core = 0; core < cores_.size(); ++core) busy += cores_.busy_time(core, current_time_);
+    return busy / (current_time_ * cores_.size());
+}
+
+double MultiClassSimulator::loss_probability() const {
+    return total_arrivals_ > 0 ? static_cast<double>(jobs_lost_) / total_arrivals_ : 0.0;
+}
+
+double MultiClassSimulator::throughput() const {
+    return current_time_ > 0.0 ? jobs_completed_ / current_time_ : 0.0;
+}
+
+double MultiClassSimulator::rho() const {
+    double load = 0.0;
+    for (const JobClass& cls : classes_) {
+        if (cls.arrivals->mean() > 0.0) load += cls.service->mean() / cls.arrivals->mean();
+    }
+    return load / cores_.size();
+}
+
+// ==================== МЕТОДЫ ВЫВОДА ====================
+
+void MultiClassSimulator::print_configuration() const {
+    cout << fixed << setprecision(4);
+    cout << "\nКОНФИГУРАЦИЯ МНОГОКЛАССОВОЙ СИСТЕМЫ:\n";
+    cout << "  Дисциплина: " << scheduling_name(scheduling_) << "\n";
+    cout << "  Ядер: " << cores_.size() << ", буфер: "
+         << (buffer_capacity_ == -1 ? "∞" : to_string(buffer_capacity_)) << "\n";
+    for (size_t k = 0; k < classes_.size(); ++k) {
+        const JobClass& cls = classes_[k];
+        double lambda = cls.arrivals->mean() > 0.0 ? 1.0 / cls.arrivals->mean() : 0.0;
+        cout << "  Класс " << k << ": " << cls.arrivals->name() << " / " << cls.service->name()
+             << ", приоритет " << cls.priority << ", λ = " << lambda
+             << ", ρ = " << lambda * cls.service->mean() / cores_.size() << "\n";
+    }
+    double load = rho();
+    cout << "  Суммарная нагрузка ρ = " << load << (load < 1.0 ? "" : " (НЕстационарна!)") << "\n";
+}
+
+void MultiClassSimulator::print_statistics() const {
+    cout << "\n========== РЕЗУЛЬТАТЫ МНОГОКЛАССОВОГО МОДЕЛИРОВАНИЯ ==========\n\n";
+    cout << fixed << setprecision(2);
+    cout << "  Время моделирования: " << current_time_ << "\n";
+    cout << "  Поступило: " << total_arrivals_ << ", обслужено: " << jobs_completed_
+         << ", потеряно: " << jobs_lost_ << "\n";
+    cout << "  Вытеснений: " << preemptions_ << "\n";
+    cout << "  Обработано событий: " << events_processed_ << "\n";
+    cout << "  Загрузка сервера: " << server_utilization() * 100 << "%\n";
+    cout << fixed << setprecision(4);
+    cout << "  Среднее ожидание: " << avg_wait_time() << ", среднее пребывание: "
+         << avg_response_time() << ", Lq = " << avg_queue_length() << "\n\n";
+
+    cout << "  Класс  Приор.  Обслужено  Вытеснений       W       R\n";
+    for (int k = 0; k < class_count(); ++k) {
+        ClassResults r = class_results(k);
+        cout << setw(7) << k << setw(8) << r.priority << setw(11) << r.completed
+             << setw(12) << r.preemptions
+             << setw(8) << setprecision(3) << r.avg_wait_time
+             << setw(8) << r.avg_response_time << "\n";
+    }
+}
@@ -0,0 +1,250 @@
+#ifndef MULTICLASS_SIMULATOR_H
+#define MULTICLASS_SIMULATOR_H
+
+#include "common/random_generator.h"
+#include "common/event_set.h"
+#include "common/indexed_heap.h"
+#include "common/job_table.h"
+#include "common/core_allocator.h"
+#include "common/statistics.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ==================== СТРУКТУРЫ ДАННЫХ МНОГОКЛАССОВОЙ СИСТЕМЫ ====================
+
+/**
+ * Задание класса: остаток работы уменьшается при вытеснении, поэтому время
+ * ожидания считается как время в системе без времени обслуживания
+ */
+struct ClassJob {
+    int id;                    // уникальный идентификатор (порядок прибытия)
+    int job_class;             // класс задания
+    double arrival_time;       // время поступления
+    double service_time;       // требуемое время обслуживания
+    double remaining;          // оставшаяся работа на момент постановки в очередь
+    int core;                  // ядро обслуживания (-1 = ожидает в очереди)
+
+    ClassJob() : id(-1), job_class(-1), arrival_time(0.0), service_time(0.0), remaining(0.0), core(-1) {}
+    ClassJob(int _id, int cls, double arrival, double service)
+        : id(_id), job_class(cls), arrival_time(arrival), service_time(service),
+          remaining(service), core(-1) {}
+};
+
+/**
+ * Событие многоклассовой системы: прибытие задания класса или завершение
+ * обслуживания на ядре
+ */
+struct ClassEvent {
+    enum Type { ARRIVAL, DEPARTURE };
+
+    double time;        // время события
+    Type type;          // тип события
+    int job_class;      // класс прибытия (для ARRIVAL)
+    int job_handle;     // дескриптор задания (для DEPARTURE)
+    int core_id;        // ядро (для DEPARTURE)
+    unsigned long long seq;  // порядковый номер планирования (разрешает равенство времён)
+
+    ClassEvent() : time(0.0), type(ARRIVAL), job_class(-1), job_handle(-1), core_id(-1), seq(0) {}
+    ClassEvent(double t, int cls)
+        : time(t), type(ARRIVAL), job_class(cls), job_handle(-1), core_id(-1), seq(0) {}
+    ClassEvent(double t, int handle, int cid)
+        : time(t), type(DEPARTURE), job_class(-1), job_handle(handle), core_id(cid), seq(0) {}
+
+    bool operator>(const ClassEvent& other) const {
+        if (time != other.time) return time > other.time;
+        return seq > other.seq;
+    }
+};
+
+// ==================== МНОГОКЛАССОВЫЙ СИМУЛЯТОР ====================
+
+/**
+ * Система G/G/c/K с несколькими классами заданий и приоритетным обслуживанием
+ *
+ * У каждого класса свой поток прибытий, генератор обслуживания и приоритет
+ * (меньше = выше). Очередь ожидающих - индексированная куча по ключу
+ * дисциплины и номеру задания:
+ *   FIFO                - порядок прибытия;
+ *   PRIORITY            - приоритет класса без вытеснения;
+ *   PREEMPTIVE_PRIORITY - приоритет класса с вытеснением и дообслуживанием
+ *                         (preemptive-resume);
+ *   SPT                 - кратчайшее время обслуживания без вытеснения;
+ *   SRPT                - кратчайшая оставшаяся работа с вытеснением.
+ * При вытеснении запланированное завершение отменяется в множестве событий
+ * (IndexedHeapEventSet, O(log n)), остаток работы вытесненного задания
+ * сохраняется, и оно возвращается в очередь; равные ключи обслуживаются в
+ * порядке прибытия, поэтому вытесненное задание продолжит первым в своём
+ * классе. Жертва - задание с наибольшим ключом среди обслуживаемых (O(c)).
+ * Буфер ограничивает число ожидающих: прибытие в полный буфер теряется
+ * и никого не вытесняет.
+ */
+class MultiClassSimulator {
+public:
+    enum class Scheduling {
+        FIFO,
+        PRIORITY,
+        PREEMPTIVE_PRIORITY,
+        SPT,
+        SRPT
+    };
+
+    static std::string scheduling_name(Scheduling scheduling);
+    static std::vector<Scheduling> all_schedulings();
+
+    // Сводка по классу за прогон
+    struct ClassResults {
+        int priority;
+        long long arrivals;
+        long long completed;
+        long long lost;                // потери из-за полного буфера
+        long long preemptions;         // сколько раз задания класса вытеснялись
+        double throughput;             // завершений в единицу времени
+        double avg_wait_time;          // время в системе вне обслуживания
+        double avg_response_time;      // время в системе
+        double wait_time_variance;
+    };
+
+private:
+    struct JobClass {
+        std::unique_ptr<RandomGenerator> arrivals;
+        std::unique_ptr<RandomGenerator> service;
+        VariateBuffer arrival_variates;
+        VariateBuffer service_variates;
+        int priority;
+
+        long long arrival_count;
+        long long completed;
+        long long lost;
+        long long preemptions;
+        Statistics::StreamingAccumulator wait;
+        Statistics::StreamingAccumulator response;
+
+        JobClass(std::unique_ptr<RandomGenerator> arrival_gen, std::unique_ptr<RandomGenerator> service_gen,
+                 int class_priority);
+        void reset();
+    };
+
+    // Ключ очереди ожидающих: ключ дисциплины, при равенстве - порядок прибытия
+    struct ReadyKey {
+        double primary;
+        int job_id;
+
+        bool operator<(const ReadyKey& other) const {
+            if (primary != other.primary) return primary < other.primary;
+            return job_id < other.job_id;
+        }
+    };
+
+    std::vector<JobClass> classes_;
+    Scheduling scheduling_;
+    int buffer_capacity_;                    // ёмкость буфера (-1 = бесконечный)
+
+    EventSets::IndexedHeapEventSet<ClassEvent> events_;
+    IndexedHeaps::IndexedHeap<ReadyKey> ready_;     // ожидающие задания по дескриптору
+    JobTables::SlabTable<ClassJob> jobs_;            // задания в системе
+    CoreAllocators::CoreAllocator cores_;            // текущее задание ядра - дескриптор
+    std::vector<int> departure_id_;                  // событие завершения на ядре (-1 = нет)
+
+    double current_time_;
+    unsigned long long next_event_seq_;
+    long long events_processed_;
+    int next_job_id_;
+    long long total_arrivals_;
+    long long jobs_completed_;
+    long long jobs_lost_;
+    long long preemptions_;
+    Statistics::StreamingAccumulator wait_;          // по всем классам
+    Statistics::StreamingAccumulator response_;
+    double queue_area_;                              // интеграл числа ожидающих
+    double last_update_;
+
+    bool preemptive() const;
+    ReadyKey key_of(const ClassJob& job) const;      // ключ ожидающего задания
+    ReadyKey service_key(int core) const;            // ключ обслуживаемого задания сейчас
+
+    void initialize();
+    void advance(double time_limit, long long jobs_limit);
+    void process_arrival(int job_class);
+    void process_departure(int job_handle, int core_id);
+    void start_service(int job_handle, int core_id);
+    int preemption_victim(const ReadyKey& arriving) const;
+    void preempt(int core_id, int job_handle);
+    void schedule_arrival(int job_class);
+    int push_event(ClassEvent event);
+    void integrate();
+    void check_class(int job_class) const;
+
+public:
+    /**
+     * @param num_cores количество ядер сервера
+     * @param buffer_cap ёмкость буфера ожидающих (-1 = бесконечный)
+     * @param scheduling дисциплина обслуживания
+     */
+    explicit MultiClassSimulator(int num_cores = 1, int buffer_cap = -1,
+                                 Scheduling scheduling = Scheduling::FIFO);
+
+    MultiClassSimulator(const MultiClassSimulator&) = delete;
+    MultiClassSimulator& operator=(const MultiClassSimulator&) = delete;
+
+    // ============= ПОСТРОЕНИЕ СИСТЕМЫ =============
+
+    /**
+     * Добавляет класс заданий
+     * @param arrival_gen генератор интервалов между прибытиями класса
+     * @param service_gen генератор времени обслуживания класса
+     * @param priority приоритет (меньше = выше), для PRIORITY и PREEMPTIVE_PRIORITY
+     * @return номер класса
+     */
+    int add_class(std::unique_ptr<RandomGenerator> arrival_gen,
+                  std::unique_ptr<RandomGenerator> service_gen,
+                  int priority = 0);
+
+    void set_scheduling(Scheduling scheduling) { scheduling_ = scheduling; }
+    void set_core_policy(CoreAllocators::Policy policy) { cores_.set_policy(policy); }
+
+    /**
+     * Детерминированная инициализация потоков: у класса k прибытия - поток
+     * (k, 0), обслуживание - (k, 1) (см. GeneratorFactory::derive_seed)
+     */
+    void seed(uint64_t seed);
+
+    // ============= МОДЕЛИРОВАНИЕ =============
+
+    void run(double simulation_time);
+    void run_until_jobs(long long jobs_to_complete);
+
+    // ============= СТАТИСТИКА =============
+
+    ClassResults class_results(int job_class) const;
+
+    double avg_wait_time() const { return wait_.mean(); }
+    double avg_response_time() const { return response_.mean(); }
+    double avg_queue_length() const;
+    double server_utilization() const;
+    double loss_probability() const;
+    double throughput() const;
+
+    // Суммарная нагрузка ρ = Σ λ_k E[S_k] / c
+    double rho() const;
+
+    void print_configuration() const;
+    void print_statistics() const;
+
+    // ============= GETTERS =============
+
+    int class_count() const { return static_cast<int>(classes_.size()); }
+    Scheduling scheduling() const { return scheduling_; }
+    double current_time() const { return current_time_; }
+    long long events_processed() const { return events_processed_; }
+    long long total_arrivals() const { return total_arrivals_; }
+    long long jobs_completed() const { return jobs_completed_; }
+    long long jobs_lost() const { return jobs_lost_; }
+    long long preemptions() const { return preemptions_; }
+    int jobs_in_system() const { return static_cast<int>(jobs_.size()); }
+    int queue_length() const { return static_cast<int>(ready_.size()); }
+    size_t job_table_allocations() const { return jobs_.allocations(); }
+};
+
+#endif // MULTICLASS_SIMULATOR_H
@@ -0,0 +1,483 @@
+#include "network_simulator.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+// ==================== МАТРИЦА МАРШРУТИЗАЦИИ ====================
+
+RoutingMatrix::RoutingMatrix(int stations)
+    : stations_(stations), row_start_(static_cast<size_t>(stations) + 1, 0), compiled_(true) {
+    if (stations < 0) {
+        throw invalid_argument("Число станций не может быть отрицательным");
+    }
+}
+
+void RoutingMatrix::check(int station) const {
+    if (station < 0 || station >= stations_) {
+        throw out_of_range("Неверный номер станции");
+    }
+}
+
+int RoutingMatrix::add_station() {
+    row_start_.push_back(row_start_.back());
+    return stations_++;
+}
+
+void RoutingMatrix::set(int from, int to, double probability) {
+    check(from);
+    check(to);
+    if (!(probability >= 0.0 && probability <= 1.0)) {
+        throw invalid_argument("Вероятность перехода должна лежать в [0, 1]");
+    }
+
+    auto existing = find_if(entries_.begin(), entries_.end(),
+                            [&](const Entry& e) { return e.from == from && e.to == to; });
+    if (existing != entries_.end()) {
+        if (probability > 0.0) {
+            existing->probability = probability;
+        } else {
+            entries_.erase(existing);
+        }
+    } else if (probability > 0.0) {
+        entries_.push_back(Entry{from, to, probability});
+    }
+    compiled_ = false;
+}
+
+double RoutingMatrix::probability(int from, int to) const {
+    check(from);
+    check(to);
+    for (const Entry& e : entries_) {
+        if (e.from == from && e.to == to) return e.probability;
+    }
+    return 0.0;
+}
+
+double RoutingMatrix::exit_probability(int from) const {
+    check(from);
+    double total = 0.0;
+    for (const Entry& e : entries_) {
+        if (e.from == from) total += e.probability;
+    }
+    return max(0.0, 1.0 - total);
+}
+
+void RoutingMatrix::compile() {
+    // Сортировка по (from, to) даёт строки CSR и детерминированный порядок
+    // переходов внутри строки независимо от порядка вызовов set()
+    vector<Entry> sorted = entries_;
+    sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+
+    row_start_.assign(static_cast<size_t>(stations_) + 1, 0);
+    targets_.clear();
+    cumulative_.clear();
+    targets_.reserve(sorted.size());
+    cumulative_.reserve(sorted.size());
+
+    size_t next = 0;
+    for (int from = 0; from < stations_; ++from) {
+        row_start_[from] = static_cast<int>(targets_.size());
+        double total = 0.0;
+        while (next < sorted.size() && sorted[next].from == from) {
+            total += sorted[next].probability;
+            targets_.push_back(sorted[next].to);
+            cumulative_.push_back(total);
+            next++;
+        }
+        if (total > 1.0 + 1e-9) {
+            throw invalid_argument("Сумма вероятностей переходов со станции " + to_string(from) +
+                                   " больше 1");
+        }
+    }
+    row_start_[stations_] = static_cast<int>(targets_.size());
+    compiled_ = true;
+}
+
+vector<pair<int, double>> RoutingMatrix::row(int from) const {
+    check(from);
+    vector<pair<int, double>> result;
+    double previous = 0.0;
+    for (int k = row_start_[from]; k < row_start_[from + 1]; ++k) {
+        result.emplace_back(targets_[k], cumulative_[k] - previous);
+        previous = cumulative_[k];
+    }
+    return result;
+}
+
+// ==================== СТАНЦИЯ ====================
+
+NetworkSimulator::Station::Station(unique_ptr<RandomGenerator> service_gen, int num_cores, int buffer_cap,
+                                   unique_ptr<QueueDisciplines::QueueStrategy<int>> discipline)
+    : service(std::move(service_gen)),
+      routing(0.0, 1.0),
+      queue(std::move(discipline)),
+      cores(num_cores),
+      buffer_capacity(buffer_cap) {
+    reset();
+}
+
+void NetworkSimulator::Station::reset() {
+    queue->clear();
+    cores.reset();
+    arrival_count = 0;
+    external_count = 0;
+    completed = 0;
+    lost = 0;
+    wait.reset();
+    response.reset();
+    busy_area = 0.0;
+    queue_area = 0.0;
+    last_update = 0.0;
+}
+
+// ==================== КОНСТРУКТОР И ПОСТРОЕНИЕ ====================
+
+NetworkSimulator::NetworkSimulator(EventSetType event_set_type)
+    : event_queue_(EventSets::EventSetFactory<NetworkEvent>::create(event_set_type)),
+      current_time_(0.0),
+      next_event_seq_(0),
+      events_processed_(0),
+      next_job_id_(0),
+      total_arrivals_(0),
+      jobs_completed_(0),
+      jobs_lost_(0) {}
+
+void NetworkSimulator::check_station(int station) const {
+    if (station < 0 || station >= station_count()) {
+        throw out_of_range("Неверный номер станции");
+    }
+}
+
+int NetworkSimulator::add_station(unique_ptr<RandomGenerator> service_gen, int num_cores,
+                                  int buffer_cap, QueueType queue_type) {
+    if (!service_gen) {
+        throw invalid_argument("Станции нужен генератор обслуживания");
+    }
+    if (num_cores <= 0) {
+        throw invalid_argument("Количество ядер должно быть положительным");
+    }
+    stations_.emplace_back(std::move(service_gen), num_cores, buffer_cap,
+                           QueueDisciplines::QueueStrategyFactory<int>::create(queue_type));
+    return routing_.add_station();
+}
+
+void NetworkSimulator::set_external_arrivals(int station, unique_ptr<RandomGenerator> arrival_gen) {
+    check_station(station);
+    stations_[station].arrivals = std::move(arrival_gen);
+    stations_[station].arrival_variates.reset();
+}
+
+void NetworkSimulator::set_routing(int from, int to, double probability) {
+    routing_.set(from, to, probability);
+}
+
+void NetworkSimulator::set_core_policy(int station, CoreAllocators::Policy policy) {
+    check_station(station);
+    stations_[station].cores.set_policy(policy);
+}
+
+void NetworkSimulator::seed(uint64_t seed) {
+    for (size_t i = 0; i < stations_.size(); ++i) {
+        Station& st = stations_[i];
+        if (st.arrivals) st.arrivals->seed(GeneratorFactory::derive_seed(seed, i, GeneratorFactory::ARRIVAL_STREAM));
+        st.service->seed(GeneratorFactory::derive_seed(seed, i, GeneratorFactory::SERVICE_STREAM));
+        st.queue->seed(GeneratorFactory::derive_seed(seed, i, GeneratorFactory::DISCIPLINE_STREAM));
+        st.routing.seed(GeneratorFactory::derive_seed(seed, i, 3));
+        st.arrival_variates.reset();
+        st.service_variates.reset();
+        st.routing_variates.reset();
+    }
+}
+
+// ==================== ИНИЦИАЛИЗАЦИЯ ====================
+
+void NetworkSimulator::initialize() {
+    if (stations_.empty()) {
+        throw logic_error("В сети нет станций");
+    }
+    // Матрица собирается до сброса состояния: ошибка в ней не портит прошлый прогон
+    if (!routing_.compiled()) routing_.compile();
+
+    current_time_ = 0.0;
+    next_event_seq_ = 0;
+    events_processed_ = 0;
+    next_job_id_ = 0;
+    total_arrivals_ = 0;
+    jobs_completed_ = 0;
+    jobs_lost_ = 0;
+    sojourn_.reset();
+    visits_.reset();
+
+    event_queue_->clear();
+    jobs_.clear();
+    for (Station& st : stations_) st.reset();
+
+    for (int i = 0; i < station_count(); ++i) {
+        if (stations_[i].arrivals) schedule_external_arrival(i);
+    }
+}
+
+// ==================== ГЛАВНЫЙ ЦИКЛ МОДЕЛИРОВАНИЯ ====================
+
+void NetworkSimulator::run(double simulation_time) {
+    initialize();
+    advance(simulation_time, numeric_limits<long long>::max());
+}
+
+void NetworkSimulator::run_until_jobs(long long jobs_to_complete) {
+    initialize();
+    advance(numeric_limits<double>::infinity(), jobs_to_complete);
+}
+
+void NetworkSimulator::advance(double time_limit, long long jobs_limit) {
+    while (!event_queue_->empty() && event_queue_->top().time <= time_limit &&
+           jobs_completed_ < jobs_limit) {
+        NetworkEvent event = event_queue_->pop();
+        events_processed_++;
+        current_time_ = event.time;
+
+        switch (event.type) {
+            case NetworkEvent::ARRIVAL:
+                process_arrival(event.station);
+                break;
+            case NetworkEvent::DEPARTURE:
+                process_departure(event.station, event.job_handle, event.core_id);
+                break;
+        }
+    }
+
+    // При остановке по времени модельное время доводится до горизонта
+    if (jobs_completed_ < jobs_limit && isfinite(time_limit)) {
+        current_time_ = max(current_time_, time_limit);
+    }
+
+    // Интегралы всех станций доводятся до конца прогона: единственный проход по станциям
+    for (Station& st : stations_) integrate(st);
+}
+
+// ==================== ОБРАБОТКА СОБЫТИЙ ====================
+
+// Вызывается до изменения состояния станции: с прошлого обновления оно было постоянным
+void NetworkSimulator::integrate(Station& st) {
+    double dt = current_time_ - st.last_update;
+    if (dt > 0.0) {
+        st.busy_area += dt * st.cores.busy_count();
+        st.queue_area += dt * static_cast<double>(st.queue->size());
+        st.last_update = current_time_;
+    }
+}
+
+void NetworkSimulator::process_arrival(int station) {
+    total_arrivals_++;
+    stations_[station].external_count++;
+
+    int handle = jobs_.acquire(NetworkJob(next_job_id_++, current_time_));
+    enter_station(station, handle);
+
+    schedule_external_arrival(station);
+}
+
+void NetworkSimulator::enter_station(int station, int job_handle) {
+    Station& st = stations_[station];
+    integrate(st);
+    st.arrival_count++;
+
+    NetworkJob& job = jobs_[job_handle];
+    job.station = station;
+    job.visits++;
+    job.arrival_time = current_time_;
+    job.start_time = -1.0;
+    job.service_time = st.service_variates.next(*st.service);
+
+    int core = st.cores.acquire(job.id, current_time_, current_time_ + job.service_time);
+    if (core != -1) {
+        job.start_time = current_time_;
+        push_event(NetworkEvent(current_time_ + job.service_time, station, job_handle, core));
+    } else if (st.buffer_capacity != -1 &&
+               static_cast<int>(st.queue->size()) >= st.buffer_capacity) {
+        // Буфер полон - задание теряется и покидает сеть
+        st.lost++;
+        jobs_lost_++;
+        jobs_.release(job_handle);
+    } else {
+        st.queue->push(job_handle);
+    }
+}
+
+void NetworkSimulator::process_departure(int station, int job_handle, int core_id) {
+    Station& st = stations_[station];
+    integrate(st);
+
+    NetworkJob& job = jobs_[job_handle];
+    st.completed++;
+    st.wait.add(job.start_time - job.arrival_time);
+    st.response.add(current_time_ - job.arrival_time);
+
+    // Ядро переходит к следующему заданию очереди без освобождения
+    if (!st.queue->empty()) {
+        int next_handle = st.queue->pop();
+        NetworkJob& next = jobs_[next_handle];
+        next.start_time = current_time_;
+        st.cores.reassign(core_id, next.id, current_time_ + next.service_time);
+        push_event(NetworkEvent(current_time_ + next.service_time, station, next_handle, core_id));
+    } else {
+        st.cores.release(core_id, current_time_);
+    }
+
+    // Маршрутизация: задание переходит на следующую станцию тем же дескриптором
+    int target = routing_.route(station, st.routing_variates.next(st.routing));
+    if (target == -1) {
+        jobs_completed_++;
+        sojourn_.add(current_time_ - job.entry_time);
+        visits_.add(job.visits);
+        jobs_.release(job_handle);
+    } else {
+        enter_station(target, job_handle);
+    }
+}
+
+// ==================== ПЛАНИРОВАНИЕ ====================
+
+void NetworkSimulator::schedule_external_arrival(int station) {
+    Station& st = stations_[station];
+    double interval = st.arrival_variates.next(*st.arrivals);
+    push_event(NetworkEvent(current_time_ + interval, station));
+}
+
+void NetworkSimulator::push_event(NetworkEvent event) {
+    event.seq = next_event_seq_++;
+    event_queue_->push(event);
+}
+
+// ==================== АНАЛИТИКА ====================
+
+vector<double> NetworkSimulator::traffic_rates() const {
+    RoutingMatrix routing = routing_;
+    if (!routing.compiled()) routing.compile();
+
+    size_t n = stations_.size();
+    vector<double> external(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        if (stations_[i].arrivals && stations_[i].arrivals->mean() > 0.0) {
+            external[i] = 1.0 / stations_[i].arrivals->mean();
+        }
+    }
+
+    // Итерации Гаусса-Зейделя по столбцам: λ_j = γ_j + Σ_i λ_i P[i][j].
+    // Для открытой сети (из каждой станции достижим уход) итерации сходятся
+    vector<vector<pair<int, double>>> incoming(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (const auto& edge : routing.row(static_cast<int>(i))) {
+            incoming[edge.first].emplace_back(static_cast<int>(i), edge.second);
+        }
+    }
+
+    vector<double> rates = external;
+    const int MAX_ITERATIONS = 100000;
+    for (int iter = 0; iter < MAX_ITERATIONS; ++iter) {
+        double change = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            double value = external[j];
+            for (const auto& edge : incoming[j]) value += rates[edge.first] * edge.second;
+            change = max(change, abs(value - rates[j]) / max(value, 1e-300));
+            rates[j] = value;
+        }
+        if (change < 1e-13) return rates;
+    }
+    throw runtime_error("Уравнения баланса потоков не сходятся: сеть не открыта");
+}
+
+// ==================== СТАТИСТИКА ====================
+
+NetworkSimulator::StationResults NetworkSimulator::station_results(int station) const {
+    check_station(station);
+    const Station& st = stations_[station];
+    double T = current_time_;
+
+    StationResults r;
+    r.arrivals = st.arrival_count;
+    r.external_arrivals = st.external_count;
+    r.completed = st.completed;
+    r.lost = st.lost;
+    r.cores = st.cores.size();
+    r.throughput = T > 0.0 ? st.completed / T : 0.0;
+    r.utilization = T > 0.0 ? st.busy_area / (T * st.cores.size()) : 0.0;
+    r.avg_queue_length = T > 0.0 ? st.queue_area / T : 0.0;
+    r.avg_jobs = T > 0.0 ? (st.queue_area + st.busy_area) / T : 0.0;
+    r.avg_wait_time = st.wait.mean();
+    r.avg_response_time = st.response.mean();
+    return r;
+}
+
+double NetworkSimulator::loss_probability() const {
+    return total_arrivals_ > 0 ? static_cast<double>(jobs_lost_) / total_arrivals_ : 0.0;
+}
+
+double NetworkSimulator::throughput() const {
+    return current_time_ > 0.0 ? jobs_completed_ / current_time_ : 0.0;
+}
+
+double NetworkSimulator::avg_jobs_in_network() const {
+    if (current_time_ <= 0.0) return 0.0;
+    double area = 0.0;
+    for (const Station& st : stations_) area += st.queue_area + st.busy_area;
+    return area / current_time_;
+}
+
+// ==================== МЕТОДЫ ВЫВОДА ====================
+
+void NetworkSimulator::print_configuration() const {
+    cout << fixed << setprecision(4);
+    cout << "\nКОНФИГУРАЦИЯ СЕТИ:\n";
+    cout << "  Станций: " << stations_.size() << "\n";
+    cout << "  Переходов в матрице маршрутизации: " << routing_.transitions() << "\n";
+    cout << "  Множество событий: " << event_queue_->name() << "\n";
+
+    vector<double> rates = traffic_rates();
+    for (size_t i = 0; i < stations_.size(); ++i) {
+        const Station& st = stations_[i];
+        double rho = rates[i] * st.service->mean() / st.cores.size();
+        cout << "  Станция " << i << ": "
+             << (st.arrivals ? st.arrivals->name() : string("-")) << " / "
+             << st.service->name() << " / " << st.cores.size()
+             << " / " << (st.buffer_capacity == -1 ? "∞" : to_string(st.buffer_capacity))
+             << ", " << st.queue->name() << ", λ = " << rates[i] << ", ρ = " << rho
+             << (rho < 1.0 ? "" : " (НЕстационарна!)") << "\n";
+    }
+}
+
+void NetworkSimulator::print_statistics(size_t max_rows) const {
+    cout << "\n========== РЕЗУЛЬТАТЫ МОДЕЛИРОВАНИЯ СЕТИ ==========\n\n";
+    cout << fixed << setprecision(2);
+    cout << "  Время моделирования: " << current_time_ << "\n";
+    cout << "  Поступило в сеть: " << total_arrivals_ << "\n";
+    cout << "  Покинуло сеть: " << jobs_completed_ << "\n";
+    cout << "  Потеряно: " << jobs_lost_ << "\n";
+    cout << "  Обработано событий: " << events_processed_ << "\n";
+    cout << fixed << setprecision(4);
+    cout << "  Среднее время в сети: " << avg_sojourn_time() << "\n";
+    cout << "  Среднее число визитов: " << avg_visits() << "\n";
+    cout << "  Среднее число заданий в сети: " << avg_jobs_in_network()
+         << " (λU = " << throughput() * avg_sojourn_time() << ")\n\n";
+
+    cout << "  Станция  Прибытий   Загрузка      Lq       L       W       R\n";
+    size_t rows = min(max_rows, stations_.size());
+    for (size_t i = 0; i < rows; ++i) {
+        StationResults r = station_results(static_cast<int>(i));
+        cout << setw(9) << i << setw(10) << r.arrivals
+             << setw(10) << setprecision(2) << r.utilization * 100 << "%"
+             << setw(8) << setprecision(3) << r.avg_queue_length
+             << setw(8) << r.avg_jobs
+             << setw(8) << r.avg_wait_time
+             << setw(8) << r.avg_response_time << "\n";
+    }
+    if (rows < stations_.size()) {
+        cout << "  ... ещё " << stations_.size() - rows << " станций\n";
+    }
+}
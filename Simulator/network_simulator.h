@@ -0,0 +1,292 @@
+#ifndef NETWORK_SIMULATOR_H
+#define NETWORK_SIMULATOR_H
+
+#include "common/random_generator.h"
+#include "common/queue_disciplines.h"
+#include "common/event_set.h"
+#include "common/job_table.h"
+#include "common/core_allocator.h"
+#include "common/statistics.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ==================== СТРУКТУРЫ ДАННЫХ СЕТИ ====================
+
+/**
+ * Задание в сети: одна запись в таблице заданий на всё время пребывания в сети.
+ * При переходе между станциями меняются поля текущего визита, а очереди станций
+ * хранят только дескриптор записи
+ */
+struct NetworkJob {
+    int id;                    // уникальный идентификатор
+    int station;               // текущая станция
+    int visits;                // число посещённых станций (включая текущую)
+    double entry_time;         // время входа в сеть
+    double arrival_time;       // время прибытия на текущую станцию
+    double service_time;       // время обслуживания на текущей станции
+    double start_time;         // начало обслуживания на текущей станции
+
+    NetworkJob() : id(-1), station(-1), visits(0), entry_time(0.0),
+                   arrival_time(0.0), service_time(0.0), start_time(-1.0) {}
+    NetworkJob(int _id, double entry)
+        : id(_id), station(-1), visits(0), entry_time(entry),
+          arrival_time(entry), service_time(0.0), start_time(-1.0) {}
+};
+
+/**
+ * Событие сети: внешнее прибытие на станцию или завершение обслуживания
+ */
+struct NetworkEvent {
+    enum Type { ARRIVAL, DEPARTURE };
+
+    double time;        // время события
+    Type type;          // тип события
+    int station;        // станция события
+    int job_handle;     // дескриптор задания (для DEPARTURE)
+    int core_id;        // ядро станции (для DEPARTURE)
+    unsigned long long seq;  // порядковый номер планирования (разрешает равенство времён)
+
+    NetworkEvent() : time(0.0), type(ARRIVAL), station(-1), job_handle(-1), core_id(-1), seq(0) {}
+    NetworkEvent(double t, int st)
+        : time(t), type(ARRIVAL), station(st), job_handle(-1), core_id(-1), seq(0) {}
+    NetworkEvent(double t, int st, int handle, int cid)
+        : time(t), type(DEPARTURE), station(st), job_handle(handle), core_id(cid), seq(0) {}
+
+    bool operator>(const NetworkEvent& other) const {
+        if (time != other.time) return time > other.time;
+        return seq > other.seq;
+    }
+};
+
+/**
+ * Разреженная матрица маршрутизации P[i][j] в формате CSR
+ *
+ * Строка i хранит накопленные вероятности переходов со станции i, поэтому
+ * выбор следующей станции - двоичный поиск по строке: O(log d) для d
+ * исходящих переходов без хеш-таблиц. Остаток 1 - Σ_j P[i][j] - вероятность
+ * ухода из сети. Переходы добавляются set(), строки собираются при первом
+ * обращении после изменения.
+ */
+class RoutingMatrix {
+private:
+    struct Entry {
+        int from;
+        int to;
+        double probability;
+    };
+
+    int stations_;
+    std::vector<Entry> entries_;         // заданные переходы (последнее set() побеждает)
+    std::vector<int> row_start_;         // CSR: начало строки i, размер stations_ + 1
+    std::vector<int> targets_;
+    std::vector<double> cumulative_;     // накопленная вероятность внутри строки
+    bool compiled_;
+
+    void check(int station) const;
+
+public:
+    explicit RoutingMatrix(int stations = 0);
+
+    // Добавляет станцию без переходов; возвращает её номер
+    int add_station();
+
+    // Задаёт P[from][to] (0 удаляет переход)
+    void set(int from, int to, double probability);
+    double probability(int from, int to) const;
+    double exit_probability(int from) const;
+
+    // Следующая станция по равномерному u ∈ [0,1); -1 - уход из сети
+    int route(int from, double u) const {
+        int lo = row_start_[from], hi = row_start_[from + 1];
+        if (lo == hi || u >= cumulative_[hi - 1]) return -1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (u < cumulative_[mid]) hi = mid; else lo = mid + 1;
+        }
+        return targets_[lo];
+    }
+
+    // Собирает строки CSR и проверяет, что Σ_j P[i][j] ≤ 1
+    void compile();
+    bool compiled() const { return compiled_; }
+
+    int size() const { return stations_; }
+    size_t transitions() const { return entries_.size(); }
+
+    // Переходы строки from после compile(): (станция, вероятность)
+    std::vector<std::pair<int, double>> row(int from) const;
+};
+
+// ==================== СИМУЛЯТОР СЕТИ ====================
+
+/**
+ * Сеть станций G/G/c/K с вероятностной маршрутизацией (тандемы, сети Джексона)
+ *
+ * Каждая станция повторяет логику Simulator: поток внешних прибытий (может
+ * отсутствовать), генератор обслуживания, дисциплина QueueStrategy, ядра
+ * CoreAllocator и буфер ограниченной ёмкости. Все станции делят одно множество
+ * событий и одну таблицу заданий; задание после обслуживания переходит на
+ * следующую станцию по матрице маршрутизации - переносится дескриптор, сама
+ * запись не копируется. Задание, пришедшее на станцию с полным буфером,
+ * теряется.
+ *
+ * Статистика по станциям интегрируется лениво: при событии обновляются
+ * только затронутые станции, поэтому стоимость события не зависит от числа
+ * станций. Все случайные потоки станции выводятся из зерна по её номеру,
+ * поэтому станция - естественная единица разбиения для движков PDES.
+ */
+class NetworkSimulator {
+public:
+    using QueueType = QueueDisciplines::QueueStrategyFactory<int>::Type;
+    using EventSetType = EventSets::EventSetFactory<NetworkEvent>::Type;
+    
+    // Сводка по станции за прогон
+    struct StationResults {
+        long long arrivals;            // все прибытия: внешние и переходы с других станций
+        long long external_arrivals;   // прибытия извне сети
+        long long completed;           // завершённые обслуживания
+        long long lost;                // потери из-за полного буфера
+        double throughput;             // завершений в единицу времени
+        double utilization;            // доля занятости ядер
+        double avg_queue_length;       // Lq (среднее по времени)
+        double avg_jobs;               // L (среднее по времени)
+        double avg_wait_time;          // ожидание на визит
+        double avg_response_time;      // пребывание на визит
+        int cores;
+    };
+    
+private:
+    struct Station {
+        std::unique_ptr<RandomGenerator> arrivals;    // nullptr - нет внешнего потока
+        std::unique_ptr<RandomGenerator> service;
+        UniformGenerator routing;                     // выбор следующей станции
+        VariateBuffer arrival_variates;
+        VariateBuffer service_variates;
+        VariateBuffer routing_variates;
+        std::unique_ptr<QueueDisciplines::QueueStrategy<int>> queue;   // дескрипторы заданий
+        CoreAllocators::CoreAllocator cores;
+        int buffer_capacity;           // -1 = бесконечный
+        
+        long long arrival_count;
+        long long external_count;
+        long long completed;
+        long long lost;
+        Statistics::StreamingAccumulator wait;
+        Statistics::StreamingAccumulator response;
+        double busy_area;              // интеграл числа занятых ядер
+        double queue_area;             // интеграл длины очереди
+        double last_update;            // момент последнего интегрирования
+        
+        Station(std::unique_ptr<RandomGenerator> service_gen, int num_cores, int buffer_cap,
+                std::unique_ptr<QueueDisciplines::QueueStrategy<int>> discipline);
+        void reset();
+    };
+    
+    std::vector<Station> stations_;
+    RoutingMatrix routing_;
+    std::unique_ptr<EventSets::EventSet<NetworkEvent>> event_queue_;
+    JobTables::SlabTable<NetworkJob> jobs_;      // задания в сети (по дескриптору)
+    
+    double current_time_;
+    unsigned long long next_event_seq_;
+    long long events_processed_;
+    int next_job_id_;
+    long long total_arrivals_;     // внешние прибытия в сеть
+    long long jobs_completed_;     // задания, покинувшие сеть
+    long long jobs_lost_;          // потери на любой станции
+    Statistics::StreamingAccumulator sojourn_;   // время пребывания в сети
+    Statistics::StreamingAccumulator visits_;    // число визитов на задание
+    
+    void initialize();
+    void advance(double time_limit, long long jobs_limit);
+    void process_arrival(int station);
+    void process_departure(int station, int job_handle, int core_id);
+    void enter_station(int station, int job_handle);
+    void schedule_external_arrival(int station);
+    void push_event(NetworkEvent event);
+    void integrate(Station& station);
+    void check_station(int station) const;
+    
+public:
+    explicit NetworkSimulator(EventSetType event_set_type = EventSetType::BINARY_HEAP);
+    
+    NetworkSimulator(const NetworkSimulator&) = delete;
+    NetworkSimulator& operator=(const NetworkSimulator&) = delete;
+    
+    // ============= ПОСТРОЕНИЕ СЕТИ =============
+    
+    /**
+     * Добавляет станцию без внешнего потока и переходов
+     * @param service_gen генератор времени обслуживания
+     * @param num_cores количество ядер станции
+     * @param buffer_cap ёмкость буфера (-1 = бесконечный)
+     * @param queue_type дисциплина очереди станции
+     * @return номер станции
+     */
+    int add_station(std::unique_ptr<RandomGenerator> service_gen,
+                    int num_cores = 1,
+                    int buffer_cap = -1,
+                    QueueType queue_type = QueueType::FIFO);
+    
+    // Внешний поток прибытий на станцию (nullptr снимает поток)
+    void set_external_arrivals(int station, std::unique_ptr<RandomGenerator> arrival_gen);
+    
+    // Вероятность перехода после обслуживания на from к станции to
+    void set_routing(int from, int to, double probability);
+    
+    void set_core_policy(int station, CoreAllocators::Policy policy);
+    
+    /**
+     * Детерминированная инициализация потоков: у станции i прибытия - поток
+     * (i, 0), обслуживание - (i, 1), дисциплина - (i, 2), маршрутизация - (i, 3)
+     * (см. GeneratorFactory::derive_seed)
+     */
+    void seed(uint64_t seed);
+    
+    // ============= МОДЕЛИРОВАНИЕ =============
+    
+    void run(double simulation_time);
+    
+    // До заданного числа заданий, покинувших сеть
+    void run_until_jobs(long long jobs_to_complete);
+    
+    /**
+     * Решение уравнений баланса потоков λ = γ + Pᵀλ (γ - интенсивности внешних
+     * потоков, 1 / среднее интервала). Для открытой сети Джексона из станций
+     * M/M/c это точные интенсивности прибытий на станции.
+     */
+    std::vector<double> traffic_rates() const;
+    
+    // ============= СТАТИСТИКА =============
+    
+    StationResults station_results(int station) const;
+    
+    double avg_sojourn_time() const { return sojourn_.mean(); }
+    double avg_visits() const { return visits_.mean(); }
+    const Statistics::StreamingAccumulator& sojourn_stats() const { return sojourn_; }
+    double loss_probability() const;
+    double throughput() const;
+    
+    // Среднее число заданий в сети (сумма L по станциям)
+    double avg_jobs_in_network() const;
+    
+    void print_configuration() const;
+    void print_statistics(size_t max_rows = 20) const;
+    
+    // ============= GETTERS =============
+    
+    int station_count() const { return static_cast<int>(stations_.size()); }
+    const RoutingMatrix& routing() const { return routing_; }
+    std::string current_event_set() const { return event_queue_->name(); }
+    double current_time() const { return current_time_; }
+    long long events_processed() const { return events_processed_; }
+    long long total_arrivals() const { return total_arrivals_; }
+    long long jobs_completed() const { return jobs_completed_; }
+    long long jobs_lost() const { return jobs_lost_; }
+    int jobs_in_network() const { return static_cast<int>(jobs_.size()); }
+    size_t job_table_allocations() const { return jobs_.allocations(); }
+};
+
+#endif // NETWORK_SIMULATOR_H
@@ -0,0 +1,237 @@
+#include "pdes/conservative.h"
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+
+namespace PDES {
+
+static const double INFINITE_TIME = numeric_limits<double>::infinity();
+
+ConservativeEngine::ConservativeEngine() : ConservativeEngine(Config()) {}
+
+ConservativeEngine::ConservativeEngine(Config config) : config_(config) {}
+
+int ConservativeEngine::add_process(unique_ptr<LogicalProcess> process) {
+    auto rec = make_unique<ProcessRecord>();
+    rec->lp = std::move(process);
+    rec->id = static_cast<int>(processes_.size());
+    processes_.push_back(std::move(rec));
+    return processes_.back()->id;
+}
+
+void ConservativeEngine::connect(int source, int target, double lookahead) {
+    if (source < 0 || source >= static_cast<int>(processes_.size()) ||
+        target < 0 || target >= static_cast<int>(processes_.size())) {
+        throw out_of_range("Канал между несуществующими LP");
+    }
+    if (source == target) {
+        throw invalid_argument("Собственные события LP не требуют канала");
+    }
+    if (!(lookahead >= 0.0)) {
+        throw invalid_argument("Lookahead канала должен быть неотрицательным");
+    }
+
+    ProcessRecord& src = *processes_[source];
+    if (Channel* existing = find_output(src, target)) {
+        // Повторное объявление: действует наименьшая гарантия
+        existing->lookahead = min(existing->lookahead, lookahead);
+        return;
+    }
+
+    channels_.push_back(make_unique<Channel>(source, target, lookahead));
+    src.outputs.push_back(channels_.back().get());
+    processes_[target]->inputs.push_back(channels_.back().get());
+}
+
+ConservativeEngine::Channel* ConservativeEngine::find_output(ProcessRecord& rec, int target) const {
+    for (Channel* ch : rec.outputs) {
+        if (ch->target == target) return ch;
+    }
+    return nullptr;
+}
+
+// Поиск цикла по каналам с нулевым lookahead (обход в глубину)
+void ConservativeEngine::check_zero_lookahead_cycles() const {
+    enum Color { WHITE, GRAY, BLACK };
+    vector<Color> color(processes_.size(), WHITE);
+
+    for (size_t root = 0; root < processes_.size(); ++root) {
+        if (color[root] != WHITE) continue;
+        vector<pair<int, size_t>> stack{{static_cast<int>(root), 0}};
+        color[root] = GRAY;
+
+        while (!stack.empty()) {
+            auto& [node, next] = stack.back();
+            const auto& outputs = processes_[node]->outputs;
+            if (next == outputs.size()) {
+                color[node] = BLACK;
+                stack.pop_back();
+                continue;
+            }
+            const Channel* ch = outputs[next++];
+            if (ch->lookahead > 0.0) continue;
+            if (color[ch->target] == GRAY) {
+                throw invalid_argument("Цикл каналов с нулевым lookahead: возможна взаимная блокировка");
+            }
+            if (color[ch->target] == WHITE) {
+                color[ch->target] = GRAY;
+                stack.push_back({ch->target, 0});
+            }
+        }
+    }
+}
+
+// ==================== ВИЗИТ LP ====================
+
+bool ConservativeEngine::visit(ProcessRecord& rec, double end_time, Context& ctx, WorkerStats& ws) {
+    // Часы читаются до разбора ящика: всё, что раньше прочитанных часов,
+    // к этому моменту уже лежит в ящике
+    double safe = INFINITE_TIME;
+    for (const Channel* ch : rec.inputs) {
+        safe = min(safe, ch->clock.load(memory_order_acquire));
+    }
+
+    {
+        lock_guard<mutex> lock(rec.mailbox_mutex);
+        for (const auto& msg : rec.mailbox) {
+            rec.pending.insert(msg);
+        }
+        rec.mailbox.clear();
+    }
+
+    bool progress = false;
+    while (!rec.pending.empty()) {
+        const Message& head = *rec.pending.begin();
+        if (head.time > end_time) break;
+        if (!(head.time < safe)) {
+            ws.blocked++;
+            break;
+        }
+
+        Message event = head;
+        rec.pending.erase(rec.pending.begin());
+        ctx.reset(event.time, rec.id);
+        rec.lp->handle(event, ctx);
+
+        for (const auto& out : ctx.outbox()) {
+            if (out.target == rec.id) {
+                if (!event.before(out)) {
+                    throw logic_error("Собственное событие должно следовать за текущим");
+                }
+                rec.pending.insert(out);
+                continue;
+            }
+            Channel* ch = find_output(rec, out.target);
+            if (!ch) {
+                throw logic_error("Сообщение по необъявленному каналу");
+            }
+            if (out.time < event.time + ch->lookahead) {
+                throw logic_error("Нарушение lookahead канала");
+            }
+            ProcessRecord& target = *processes_[out.target];
+            lock_guard<mutex> lock(target.mailbox_mutex);
+            target.mailbox.push_back(out);
+        }
+
+        ws.processed++;
+        progress = true;
+    }
+
+    // Нулевые сообщения: обещание получателям на основе нижней границы
+    // времени следующего события этого LP
+    double bound = min(safe, rec.pending.empty() ? INFINITE_TIME : rec.pending.begin()->time);
+    if (bound > end_time) {
+        rec.done = true;
+    }
+    for (Channel* ch : rec.outputs) {
+        double promise = rec.done ? INFINITE_TIME : bound + ch->lookahead;
+        if (promise > ch->clock.load(memory_order_relaxed)) {
+            ch->clock.store(promise, memory_order_release);
+            ws.null_messages++;
+            progress = true;
+        }
+    }
+
+    return progress;
+}
+
+// ==================== РАБОЧИЙ ЦИКЛ ====================
+
+void ConservativeEngine::worker_loop(size_t worker, double end_time, WorkerStats& ws) {
+    vector<ProcessRecord*> mine;
+    for (auto& rec : processes_) {
+        if (rec->owner == worker) mine.push_back(rec.get());
+    }
+
+    Context ctx;
+    while (true) {
+        bool all_done = true;
+        bool progress = false;
+        for (ProcessRecord* rec : mine) {
+            if (rec->done) continue;
+            progress |= visit(*rec, end_time, ctx, ws);
+            all_done &= rec->done;
+        }
+        if (all_done) break;
+        if (!progress) {
+            this_thread::yield();
+        }
+    }
+}
+
+void ConservativeEngine::run(double end_time) {
+    auto start_time = chrono::steady_clock::now();
+
+    check_zero_lookahead_cycles();
+
+    // Начальные события доставляются напрямую: потоки ещё не запущены
+    Context ctx;
+    for (auto& rec : processes_) {
+        ctx.reset(0.0, rec->id);
+        rec->lp->initialize(ctx);
+        for (const auto& out : ctx.outbox()) {
+            if (out.target != rec->id && !find_output(*rec, out.target)) {
+                throw logic_error("Сообщение по необъявленному каналу");
+            }
+            processes_.at(out.target)->pending.insert(out);
+        }
+    }
+    for (auto& ch : channels_) {
+        ch->clock.store(0.0);
+    }
+
+    size_t workers = config_.threads > 0 ? config_.threads : thread::hardware_concurrency();
+    workers = max<size_t>(1, min(workers, processes_.size()));
+    for (auto& rec : processes_) {
+        rec->owner = static_cast<size_t>(rec->id) % workers;
+        rec->done = false;
+    }
+
+    vector<WorkerStats> worker_stats(workers);
+    vector<thread> threads;
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(&ConservativeEngine::worker_loop, this, w, end_time, ref(worker_stats[w]));
+    }
+    worker_loop(0, end_time, worker_stats[0]);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& ws : worker_stats) {
+        stats_.events_processed += ws.processed;
+        stats_.null_messages += ws.null_messages;
+        stats_.blocked_visits += ws.blocked;
+    }
+
+    for (auto& rec : processes_) {
+        rec->lp->finalize(end_time);
+    }
+
+    auto end_wall = chrono::steady_clock::now();
+    stats_.wall_time_ms = chrono::duration<double, milli>(end_wall - start_time).count();
+}
+
+} // namespace PDES
@@ -0,0 +1,95 @@
+#ifndef CONSERVATIVE_H
+#define CONSERVATIVE_H
+
+#include "pdes/logical_process.h"
+#include <set>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace PDES {
+
+/**
+ * Консервативный движок Чанди-Мисры-Брайанта с нулевыми сообщениями
+ *
+ * Топология каналов объявляется заранее через connect(), и у каждого канала
+ * есть lookahead - гарантированное опережение меток времени сообщений.
+ * LP обрабатывает событие, только если его время строго меньше часов всех
+ * входных каналов; после каждого визита LP обещает получателям, что следующие
+ * сообщения будут не раньше (нижняя граница ближайшего события + lookahead).
+ * В общей памяти нулевое сообщение - это монотонное повышение часов канала,
+ * а не отдельный объект в почтовом ящике. Откатов нет, поэтому состояние
+ * не сохраняется. Каждый цикл каналов обязан иметь положительный суммарный
+ * lookahead, иначе возможна взаимная блокировка - это проверяется в run().
+ */
+class ConservativeEngine : public Kernel {
+public:
+    struct Config {
+        size_t threads = 0;               // 0 = min(число ядер, число LP)
+    };
+
+    struct Stats {
+        long long events_processed = 0;
+        long long null_messages = 0;      // повышения часов каналов
+        long long blocked_visits = 0;     // визиты, где ближайшее событие ещё небезопасно
+        double wall_time_ms = 0.0;
+    };
+
+private:
+    struct Channel {
+        int source;
+        int target;
+        double lookahead;
+        std::atomic<double> clock;        // нижняя граница меток будущих сообщений
+
+        Channel(int s, int t, double la) : source(s), target(t), lookahead(la), clock(0.0) {}
+    };
+
+    struct ProcessRecord {
+        std::unique_ptr<LogicalProcess> lp;
+        int id = -1;
+        size_t owner = 0;
+        bool done = false;
+        std::set<Message, Message::Order> pending;
+        std::vector<Channel*> inputs;
+        std::vector<Channel*> outputs;
+
+        std::mutex mailbox_mutex;
+        std::vector<Message> mailbox;
+    };
+
+    struct WorkerStats {
+        long long processed = 0;
+        long long null_messages = 0;
+        long long blocked = 0;
+    };
+
+    Config config_;
+    std::vector<std::unique_ptr<ProcessRecord>> processes_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+    Stats stats_;
+
+    Channel* find_output(ProcessRecord& rec, int target) const;
+    void check_zero_lookahead_cycles() const;
+    bool visit(ProcessRecord& rec, double end_time, Context& ctx, WorkerStats& ws);
+    void worker_loop(size_t worker, double end_time, WorkerStats& ws);
+
+public:
+    ConservativeEngine();
+    explicit ConservativeEngine(Config config);
+
+    int add_process(std::unique_ptr<LogicalProcess> process) override;
+    LogicalProcess& process(int id) override { return *processes_.at(id)->lp; }
+    size_t process_count() const override { return processes_.size(); }
+    void connect(int source, int target, double lookahead) override;
+    void run(double end_time) override;
+    std::string name() const override { return "CONSERVATIVE_CMB"; }
+
+    const Stats& stats() const { return stats_; }
+};
+
+} // namespace PDES
+
+#endif // CONSERVATIVE_H
@@ -0,0 +1,162 @@
+#ifndef LOGICAL_PROCESS_H
+#define LOGICAL_PROCESS_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace PDES {
+
+/**
+ * Сообщение между логическими процессами (LP)
+ *
+ * Порядок обработки задаётся ключом (time, source, kind, tag); модель обязана
+ * делать ключи сообщений одного отправителя уникальными (например, tag = номер
+ * задания). Поле id уникально в пределах прогона и служит для сопоставления
+ * сообщения с его антисообщением.
+ */
+struct Message {
+    double time;          // метка времени получения
+    int source;           // LP-отправитель
+    int target;           // LP-получатель
+    int kind;             // тип события (определяется моделью)
+    long long tag;        // целочисленная полезная нагрузка
+    double data[3];       // вещественная полезная нагрузка
+    uint64_t id;          // уникальный идентификатор экземпляра
+    bool anti;            // антисообщение (отмена ранее посланного)
+
+    Message()
+        : time(0.0), source(-1), target(-1), kind(0), tag(0),
+          data{0.0, 0.0, 0.0}, id(0), anti(false) {}
+
+    bool before(const Message& other) const {
+        if (time != other.time) return time < other.time;
+        if (source != other.source) return source < other.source;
+        if (kind != other.kind) return kind < other.kind;
+        return tag < other.tag;
+    }
+
+    struct Order {
+        bool operator()(const Message& a, const Message& b) const { return a.before(b); }
+    };
+};
+
+/**
+ * Контекст обработки события: текущее время LP и отправка сообщений
+ */
+class Context {
+private:
+    double now_;
+    int self_;
+    std::vector<Message> outbox_;
+
+public:
+    Context() : now_(0.0), self_(-1) {}
+
+    void reset(double now, int self) {
+        now_ = now;
+        self_ = self;
+        outbox_.clear();
+    }
+
+    double now() const { return now_; }
+    int self() const { return self_; }
+
+    // Послать сообщение LP target с меткой времени time >= now()
+    void send(int target, double time, int kind, long long tag = 0,
+              double d0 = 0.0, double d1 = 0.0, double d2 = 0.0) {
+        if (time < now_) {
+            throw std::logic_error("Сообщение в прошлое: нарушение причинности");
+        }
+        Message msg;
+        msg.time = time;
+        msg.source = self_;
+        msg.target = target;
+        msg.kind = kind;
+        msg.tag = tag;
+        msg.data[0] = d0;
+        msg.data[1] = d1;
+        msg.data[2] = d2;
+        outbox_.push_back(msg);
+    }
+
+    std::vector<Message>& outbox() { return outbox_; }
+};
+
+// Снимок состояния LP (для отката в оптимистичных алгоритмах)
+struct StateSnapshot {
+    virtual ~StateSnapshot() = default;
+};
+
+/**
+ * Логический процесс - часть модели со своим состоянием
+ * и локальным временем, взаимодействующая с другими только сообщениями
+ */
+class LogicalProcess {
+public:
+    virtual ~LogicalProcess() = default;
+
+    // Начальные события (вызывается один раз до запуска, now() = 0)
+    virtual void initialize(Context& ctx) = 0;
+
+    // Обработка одного события
+    virtual void handle(const Message& msg, Context& ctx) = 0;
+
+    // Сохранение и восстановление полного состояния
+    virtual std::unique_ptr<StateSnapshot> save_state() const = 0;
+    virtual void restore_state(const StateSnapshot& snapshot) = 0;
+
+    // Завершение прогона: учёт незавершённых к end_time величин
+    virtual void finalize(double /*end_time*/) {}
+};
+
+/**
+ * Базовый класс LP, всё состояние которого собрано в копируемой структуре S
+ */
+template<typename S>
+class StatefulProcess : public LogicalProcess {
+private:
+    struct Snapshot : StateSnapshot {
+        S state;
+        explicit Snapshot(const S& s) : state(s) {}
+    };
+
+protected:
+    S state_;
+
+public:
+    std::unique_ptr<StateSnapshot> save_state() const override {
+        return std::make_unique<Snapshot>(state_);
+    }
+
+    void restore_state(const StateSnapshot& snapshot) override {
+        state_ = static_cast<const Snapshot&>(snapshot).state;
+    }
+
+    const S& state() const { return state_; }
+};
+
+/**
+ * Общий интерфейс движков параллельного моделирования
+ */
+class Kernel {
+public:
+    virtual ~Kernel() = default;
+    virtual int add_process(std::unique_ptr<LogicalProcess> process) = 0;
+    virtual LogicalProcess& process(int id) = 0;
+    virtual size_t process_count() const = 0;
+    
+    // Объявление канала source → target с гарантированным опережением lookahead:
+    // каждое сообщение, посланное при обработке события t, имеет метку >= t + lookahead.
+    // Консервативным движкам топология обязательна, оптимистичные её игнорируют.
+    virtual void connect(int /*source*/, int /*target*/, double /*lookahead*/) {}
+    
+    virtual void run(double end_time) = 0;
+    virtual std::string name() const = 0;
+};
+
+} // namespace PDES
+
+#endif // LOGICAL_PROCESS_H
@@ -0,0 +1,171 @@
+#include "pdes/station_model.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace PDES {
+
+// ==================== ИСТОЧНИК ====================
+
+StationModel::SourceProcess::SourceProcess(unique_ptr<RandomGenerator> arrivals, int queue)
+    : queue_(queue) {
+    state_.arrivals = GeneratorState(std::move(arrivals));
+}
+
+void StationModel::SourceProcess::initialize(Context& ctx) {
+    double t = ctx.now() + state_.arrivals.generate();
+    ctx.send(queue_, t, ARRIVAL, state_.next_index);
+    ctx.send(ctx.self(), t, TICK, state_.next_index);
+    state_.next_index++;
+}
+
+void StationModel::SourceProcess::handle(const Message&, Context& ctx) {
+    double t = ctx.now() + state_.arrivals.generate();
+    ctx.send(queue_, t, ARRIVAL, state_.next_index);
+    ctx.send(ctx.self(), t, TICK, state_.next_index);
+    state_.next_index++;
+}
+
+// ==================== ОЧЕРЕДЬ И ДИСПЕТЧЕР ЯДЕР ====================
+
+StationModel::QueueProcess::QueueProcess(unique_ptr<RandomGenerator> service, int cores, int buffer_cap,
+                                         int first_group, int cores_per_group)
+    : buffer_capacity_(buffer_cap),
+      first_group_(first_group),
+      cores_per_group_(cores_per_group) {
+    state_.service = GeneratorState(std::move(service));
+    state_.busy.assign(cores, 0);
+    state_.busy_since.assign(cores, 0.0);
+}
+
+void StationModel::QueueProcess::start_service(int core, const QueuedJob& job, Context& ctx) {
+    double finish = ctx.now() + job.service_time;
+    state_.busy[core] = 1;
+    state_.busy_since[core] = ctx.now();
+    ctx.send(ctx.self(), finish, DEPARTURE, core);
+    ctx.send(first_group_ + core / cores_per_group_, finish, COMPLETE, job.id,
+             job.arrival_time, ctx.now(), job.service_time);
+}
+
+void StationModel::QueueProcess::handle(const Message& msg, Context& ctx) {
+    if (msg.kind == ARRIVAL) {
+        state_.arrivals++;
+        QueuedJob job{state_.next_job_id++, ctx.now(), state_.service.generate()};
+
+        // Свободное ядро с наименьшим номером, как CoreAllocators::Policy::LOWEST_INDEX в Simulator
+        auto free_core = find(state_.busy.begin(), state_.busy.end(), 0);
+        if (free_core != state_.busy.end()) {
+            start_service(static_cast<int>(free_core - state_.busy.begin()), job, ctx);
+        } else if (buffer_capacity_ != -1 &&
+                   static_cast<int>(state_.queue.size()) >= buffer_capacity_) {
+            state_.lost++;
+        } else {
+            state_.queue.push_back(job);
+        }
+    } else if (msg.kind == DEPARTURE) {
+        int core = static_cast<int>(msg.tag);
+        state_.busy[core] = 0;
+        if (!state_.queue.empty()) {
+            QueuedJob next = state_.queue.front();
+            state_.queue.pop_front();
+            start_service(core, next, ctx);
+        }
+    }
+}
+
+void StationModel::QueueProcess::finalize(double end_time) {
+    state_.unfinished_busy_time = 0.0;
+    for (size_t core = 0; core < state_.busy.size(); ++core) {
+        if (state_.busy[core]) {
+            state_.unfinished_busy_time += end_time - state_.busy_since[core];
+        }
+    }
+}
+
+// ==================== ГРУППА ЯДЕР ====================
+
+void StationModel::CoreGroupProcess::handle(const Message& msg, Context& ctx) {
+    double arrival = msg.data[0];
+    double start = msg.data[1];
+    double service = msg.data[2];
+
+    state_.wait.add(start - arrival);
+    state_.system.add(ctx.now() - arrival);
+    state_.completed++;
+    state_.busy_time += service;
+}
+
+// ==================== МОДЕЛЬ ====================
+
+StationModel::StationModel(unique_ptr<RandomGenerator> arrival_gen,
+                           unique_ptr<RandomGenerator> service_gen,
+                           int num_cores, int buffer_cap, int core_groups, uint64_t seed)
+    : arrival_gen_(std::move(arrival_gen)),
+      service_gen_(std::move(service_gen)),
+      num_cores_(num_cores),
+      buffer_capacity_(buffer_cap),
+      core_groups_(min(max(core_groups, 1), max(num_cores, 1)))
+{
+    if (num_cores_ <= 0) {
+        throw invalid_argument("Количество ядер должно быть положительным");
+    }
+    arrival_gen_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::ARRIVAL_STREAM));
+    service_gen_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::SERVICE_STREAM));
+}
+
+void StationModel::build(Kernel& kernel) {
+    if (source_) {
+        throw logic_error("Модель уже построена");
+    }
+
+    int base = static_cast<int>(kernel.process_count());
+    int queue_id = base + 1;
+    int first_group = base + 2;
+    int cores_per_group = (num_cores_ + core_groups_ - 1) / core_groups_;
+
+    // Lookahead каналов - гарантированные минимумы интервалов и времён обслуживания
+    double arrival_lookahead = arrival_gen_->min_value();
+    double service_lookahead = service_gen_->min_value();
+
+    auto source = make_unique<SourceProcess>(std::move(arrival_gen_), queue_id);
+    auto queue = make_unique<QueueProcess>(std::move(service_gen_), num_cores_, buffer_capacity_,
+                                           first_group, cores_per_group);
+    source_ = source.get();
+    queue_ = queue.get();
+    kernel.add_process(std::move(source));
+    kernel.add_process(std::move(queue));
+
+    for (int g = 0; g < core_groups_; ++g) {
+        auto group = make_unique<CoreGroupProcess>();
+        groups_.push_back(group.get());
+        kernel.add_process(std::move(group));
+    }
+
+    kernel.connect(base, queue_id, arrival_lookahead);
+    for (int g = 0; g < core_groups_; ++g) {
+        kernel.connect(queue_id, first_group + g, service_lookahead);
+    }
+}
+
+StationModel::Results StationModel::results(double end_time) const {
+    if (!queue_) {
+        throw logic_error("Модель не построена");
+    }
+
+    Results r;
+    r.end_time = end_time;
+    r.cores = num_cores_;
+    r.total_arrivals = queue_->state().arrivals;
+    r.jobs_lost = queue_->state().lost;
+    r.busy_time = queue_->state().unfinished_busy_time;
+    for (const CoreGroupProcess* group : groups_) {
+        r.wait.merge(group->state().wait);
+        r.system.merge(group->state().system);
+        r.jobs_completed += group->state().completed;
+        r.busy_time += group->state().busy_time;
+    }
+    return r;
+}
+
+} // namespace PDES
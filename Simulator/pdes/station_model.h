@@ -0,0 +1,173 @@
+#ifndef STATION_MODEL_H
+#define STATION_MODEL_H
+
+#include "pdes/logical_process.h"
+#include "common/random_generator.h"
+#include "common/statistics.h"
+#include <deque>
+#include <vector>
+#include <memory>
+
+namespace PDES {
+
+/**
+ * Копируемая обёртка над генератором: копия клонирует состояние потока,
+ * поэтому генератор откатывается вместе с состоянием LP
+ */
+class GeneratorState {
+private:
+    std::unique_ptr<RandomGenerator> generator_;
+
+public:
+    GeneratorState() = default;
+    explicit GeneratorState(std::unique_ptr<RandomGenerator> gen) : generator_(std::move(gen)) {}
+    GeneratorState(const GeneratorState& other)
+        : generator_(other.generator_ ? other.generator_->clone() : nullptr) {}
+    GeneratorState& operator=(const GeneratorState& other) {
+        if (this != &other) {
+            generator_ = other.generator_ ? other.generator_->clone() : nullptr;
+        }
+        return *this;
+    }
+
+    double generate() { return generator_->generate(); }
+    const RandomGenerator& generator() const { return *generator_; }
+};
+
+/**
+ * Станция G/G/c/K (FIFO), разбитая на логические процессы:
+ *   LP 0      - источник заявок (поток прибытий);
+ *   LP 1      - очередь и диспетчер ядер (поток времён обслуживания);
+ *   LP 2..    - группы ядер (учёт завершённых заданий).
+ *
+ * Очередь знает время обслуживания в момент старта, поэтому сама планирует
+ * освобождение ядра, а группе ядер сообщает о завершении заранее - с опережением
+ * не меньше минимального времени обслуживания. Потоки случайных чисел
+ * засеваются так же, как Simulator::seed(), и разбор событий идёт в том же
+ * порядке, поэтому при одном зерне результаты совпадают с последовательным
+ * Simulator::run(end_time) (для непрерывных распределений, где совпадения
+ * моментов событий невозможны).
+ *
+ * Граф LP ациклический: источник → очередь → группы. Lookahead каналов берётся
+ * из RandomGenerator::min_value() потоков прибытий и обслуживания, поэтому
+ * детерминированное и равномерное обслуживание дают консервативному движку
+ * положительное опережение.
+ */
+class StationModel {
+public:
+    enum Kind {
+        ARRIVAL = 0,      // источник → очередь
+        DEPARTURE = 1,    // очередь → очередь: освобождение ядра (tag = ядро)
+        COMPLETE = 2,     // очередь → группа: завершение задания (tag = номер задания)
+        TICK = 3          // источник → источник: следующее прибытие
+    };
+
+    struct Results {
+        long long total_arrivals = 0;
+        long long jobs_completed = 0;
+        long long jobs_lost = 0;
+        Statistics::StreamingAccumulator wait;
+        Statistics::StreamingAccumulator system;
+        double busy_time = 0.0;
+        double end_time = 0.0;
+        int cores = 0;
+
+        double avg_wait_time() const { return wait.mean(); }
+        double avg_system_time() const { return system.mean(); }
+        double server_utilization() const {
+            return end_time > 0.0 ? busy_time / (end_time * cores) : 0.0;
+        }
+        double loss_probability() const {
+            return total_arrivals > 0 ? static_cast<double>(jobs_lost) / total_arrivals : 0.0;
+        }
+    };
+
+    struct SourceState {
+        GeneratorState arrivals;
+        long long next_index = 0;
+    };
+
+    struct QueuedJob {
+        long long id;
+        double arrival_time;
+        double service_time;
+    };
+
+    struct QueueState {
+        GeneratorState service;
+        long long next_job_id = 0;
+        long long arrivals = 0;
+        long long lost = 0;
+        std::vector<char> busy;
+        std::vector<double> busy_since;
+        std::deque<QueuedJob> queue;
+        double unfinished_busy_time = 0.0;   // вычисляется в finalize()
+    };
+
+    struct GroupState {
+        Statistics::StreamingAccumulator wait;
+        Statistics::StreamingAccumulator system;
+        long long completed = 0;
+        double busy_time = 0.0;
+    };
+
+    class SourceProcess : public StatefulProcess<SourceState> {
+        int queue_;
+    public:
+        SourceProcess(std::unique_ptr<RandomGenerator> arrivals, int queue);
+        void initialize(Context& ctx) override;
+        void handle(const Message& msg, Context& ctx) override;
+    };
+
+    class QueueProcess : public StatefulProcess<QueueState> {
+        int buffer_capacity_;
+        int first_group_;
+        int cores_per_group_;
+        void start_service(int core, const QueuedJob& job, Context& ctx);
+    public:
+        QueueProcess(std::unique_ptr<RandomGenerator> service, int cores, int buffer_cap,
+                     int first_group, int cores_per_group);
+        void initialize(Context&) override {}
+        void handle(const Message& msg, Context& ctx) override;
+        void finalize(double end_time) override;
+    };
+
+    class CoreGroupProcess : public StatefulProcess<GroupState> {
+    public:
+        void initialize(Context&) override {}
+        void handle(const Message& msg, Context& ctx) override;
+    };
+
+private:
+    std::unique_ptr<RandomGenerator> arrival_gen_;
+    std::unique_ptr<RandomGenerator> service_gen_;
+    int num_cores_;
+    int buffer_capacity_;
+    int core_groups_;
+
+    SourceProcess* source_ = nullptr;
+    QueueProcess* queue_ = nullptr;
+    std::vector<CoreGroupProcess*> groups_;
+    double end_time_ = 0.0;
+
+public:
+    /**
+     * @param core_groups число LP-групп ядер (ограничивается числом ядер)
+     * @param seed зерно; потоки выводятся как в Simulator::seed()
+     */
+    StationModel(std::unique_ptr<RandomGenerator> arrival_gen,
+                 std::unique_ptr<RandomGenerator> service_gen,
+                 int num_cores, int buffer_cap, int core_groups, uint64_t seed);
+
+    // Создаёт LP модели в движке (один раз)
+    void build(Kernel& kernel);
+
+    // Сводка после kernel.run(end_time)
+    Results results(double end_time) const;
+
+    int process_count() const { return 2 + core_groups_; }
+};
+
+} // namespace PDES
+
+#endif // STATION_MODEL_H
@@ -0,0 +1,285 @@
+#include "pdes/time_warp.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+namespace PDES {
+
+// Число пустых итераций перед запросом GVT простаивающим потоком
+static const int IDLE_SPINS_BEFORE_GVT = 64;
+
+TimeWarpEngine::TimeWarpEngine() : TimeWarpEngine(Config()) {}
+
+TimeWarpEngine::TimeWarpEngine(Config config)
+    : config_(config),
+      next_message_id_(1),
+      gvt_requested_(false),
+      gvt_(0.0),
+      finished_(false)
+{
+    if (config_.gvt_interval == 0) {
+        throw invalid_argument("Интервал вычисления GVT должен быть положительным");
+    }
+    if (!(config_.optimism_window > 0.0)) {
+        throw invalid_argument("Окно оптимизма должно быть положительным");
+    }
+}
+
+int TimeWarpEngine::add_process(unique_ptr<LogicalProcess> process) {
+    auto rec = make_unique<ProcessRecord>();
+    rec->lp = std::move(process);
+    rec->id = static_cast<int>(processes_.size());
+    processes_.push_back(std::move(rec));
+    return processes_.back()->id;
+}
+
+// ==================== ДОСТАВКА И ОТМЕНА СООБЩЕНИЙ ====================
+
+void TimeWarpEngine::deliver(const Message& msg) {
+    ProcessRecord& target = *processes_[msg.target];
+    lock_guard<mutex> lock(target.mailbox_mutex);
+    target.mailbox.push_back(msg);
+}
+
+void TimeWarpEngine::cancel(ProcessRecord& rec, const Message& msg, WorkerStats& ws) {
+    if (msg.target == rec.id) {
+        // Собственное событие ещё не обработано (более поздние уже откачены)
+        auto it = rec.pending.find(msg);
+        if (it != rec.pending.end() && it->id == msg.id) {
+            rec.pending.erase(it);
+        }
+        return;
+    }
+
+    Message anti = msg;
+    anti.anti = true;
+    deliver(anti);
+    ws.anti_messages++;
+}
+
+void TimeWarpEngine::rollback(ProcessRecord& rec, const Message& straggler, WorkerStats& ws) {
+    unique_ptr<StateSnapshot> restore;
+    ws.rollbacks++;
+
+    while (!rec.processed.empty() && !rec.processed.back().event.before(straggler)) {
+        Processed& undone = rec.processed.back();
+        for (const auto& sent : undone.sent) {
+            cancel(rec, sent, ws);
+        }
+        rec.pending.insert(undone.event);
+        restore = std::move(undone.before);
+        rec.processed.pop_back();
+        ws.rolled_back++;
+    }
+
+    // Последний отменённый снимок - состояние до самого раннего отменённого события
+    if (restore) {
+        rec.lp->restore_state(*restore);
+    }
+}
+
+void TimeWarpEngine::drain_mailbox(ProcessRecord& rec, WorkerStats& ws) {
+    vector<Message> batch;
+    {
+        lock_guard<mutex> lock(rec.mailbox_mutex);
+        if (rec.mailbox.empty()) return;
+        batch.swap(rec.mailbox);
+    }
+
+    for (const auto& msg : batch) {
+        if (!msg.anti) {
+            if (!rec.processed.empty() && msg.before(rec.processed.back().event)) {
+                rollback(rec, msg, ws);
+            }
+            rec.pending.insert(msg);
+            continue;
+        }
+
+        // Антисообщение: аннигиляция с ещё не обработанным оригиналом...
+        auto it = rec.pending.find(msg);
+        if (it != rec.pending.end() && it->id == msg.id) {
+            rec.pending.erase(it);
+            continue;
+        }
+
+        // ...или откат за обработанный оригинал
+        rollback(rec, msg, ws);
+        it = rec.pending.find(msg);
+        if (it == rec.pending.end() || it->id != msg.id) {
+            throw logic_error("Антисообщение без соответствующего сообщения");
+        }
+        rec.pending.erase(it);
+    }
+}
+
+// ==================== ОБРАБОТКА СОБЫТИЙ ====================
+
+void TimeWarpEngine::process_next(ProcessRecord& rec, Context& ctx, WorkerStats& ws) {
+    Processed entry;
+    entry.event = *rec.pending.begin();
+    rec.pending.erase(rec.pending.begin());
+    entry.before = rec.lp->save_state();
+
+    ctx.reset(entry.event.time, rec.id);
+    rec.lp->handle(entry.event, ctx);
+
+    for (auto& out : ctx.outbox()) {
+        if (out.target < 0 || out.target >= static_cast<int>(processes_.size())) {
+            throw out_of_range("Неверный адресат сообщения");
+        }
+        out.id = next_message_id_++;
+        if (out.target == rec.id) {
+            if (!entry.event.before(out)) {
+                throw logic_error("Собственное событие должно следовать за текущим");
+            }
+            rec.pending.insert(out);
+        } else {
+            deliver(out);
+        }
+        entry.sent.push_back(out);
+    }
+
+    rec.processed.push_back(std::move(entry));
+    ws.processed++;
+}
+
+// ==================== GVT И СБОР МУСОРА ====================
+
+double TimeWarpEngine::local_minimum(size_t worker) {
+    double minimum = numeric_limits<double>::infinity();
+    for (auto& rec : processes_) {
+        if (rec->owner != worker) continue;
+        if (!rec->pending.empty()) {
+            minimum = min(minimum, rec->pending.begin()->time);
+        }
+        lock_guard<mutex> lock(rec->mailbox_mutex);
+        for (const auto& msg : rec->mailbox) {
+            minimum = min(minimum, msg.time);
+        }
+    }
+    return minimum;
+}
+
+void TimeWarpEngine::fossil_collect(size_t worker) {
+    for (auto& rec : processes_) {
+        if (rec->owner != worker) continue;
+        while (!rec->processed.empty() && rec->processed.front().event.time < gvt_) {
+            rec->processed.pop_front();
+        }
+    }
+}
+
+// ==================== РАБОЧИЙ ЦИКЛ ====================
+
+void TimeWarpEngine::worker_loop(size_t worker, size_t /*workers*/, double end_time,
+                                 Parallel::Barrier& barrier, WorkerStats& ws) {
+    vector<ProcessRecord*> mine;
+    for (auto& rec : processes_) {
+        if (rec->owner == worker) mine.push_back(rec.get());
+    }
+
+    Context ctx;
+    size_t since_gvt = 0;
+    int idle_spins = 0;
+
+    while (true) {
+        for (ProcessRecord* rec : mine) {
+            drain_mailbox(*rec, ws);
+        }
+
+        if (!gvt_requested_.load()) {
+            // Ближайшее событие среди своих LP в пределах окна оптимизма
+            double limit = min(end_time, gvt_ + config_.optimism_window);
+            ProcessRecord* best = nullptr;
+            for (ProcessRecord* rec : mine) {
+                if (rec->pending.empty() || rec->pending.begin()->time > limit) continue;
+                if (!best || rec->pending.begin()->before(*best->pending.begin())) {
+                    best = rec;
+                }
+            }
+
+            if (best) {
+                process_next(*best, ctx, ws);
+                idle_spins = 0;
+                if (++since_gvt < config_.gvt_interval) continue;
+            } else if (++idle_spins < IDLE_SPINS_BEFORE_GVT) {
+                this_thread::yield();
+                continue;
+            }
+            gvt_requested_ = true;
+        }
+
+        // Синхронное вычисление GVT: все потоки остановлены, сообщения лежат в ящиках
+        barrier.arrive_and_wait();
+        local_minimum_[worker] = local_minimum(worker);
+        barrier.arrive_and_wait();
+        if (worker == 0) {
+            gvt_ = *min_element(local_minimum_.begin(), local_minimum_.end());
+            finished_ = gvt_ > end_time;
+            gvt_requested_ = false;
+            stats_.gvt_rounds++;
+        }
+        barrier.arrive_and_wait();
+
+        fossil_collect(worker);
+        since_gvt = 0;
+        idle_spins = 0;
+        if (finished_) break;
+    }
+}
+
+void TimeWarpEngine::run(double end_time) {
+    auto start_time = chrono::steady_clock::now();
+
+    // Начальные события доставляются напрямую: потоки ещё не запущены
+    Context ctx;
+    for (auto& rec : processes_) {
+        ctx.reset(0.0, rec->id);
+        rec->lp->initialize(ctx);
+        for (auto& out : ctx.outbox()) {
+            out.id = next_message_id_++;
+            processes_.at(out.target)->pending.insert(out);
+        }
+    }
+
+    size_t workers = config_.threads > 0 ? config_.threads : Parallel::ThreadPool::default_concurrency();
+    workers = max<size_t>(1, min(workers, processes_.size()));
+    for (auto& rec : processes_) {
+        rec->owner = static_cast<size_t>(rec->id) % workers;
+    }
+
+    gvt_ = 0.0;
+    finished_ = false;
+    gvt_requested_ = false;
+    local_minimum_.assign(workers, numeric_limits<double>::infinity());
+
+    Parallel::Barrier barrier(workers);
+    vector<WorkerStats> worker_stats(workers);
+    vector<thread> threads;
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(&TimeWarpEngine::worker_loop, this, w, workers, end_time,
+                             ref(barrier), ref(worker_stats[w]));
+    }
+    worker_loop(0, workers, end_time, barrier, worker_stats[0]);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& ws : worker_stats) {
+        stats_.events_processed += ws.processed;
+        stats_.events_rolled_back += ws.rolled_back;
+        stats_.rollbacks += ws.rollbacks;
+        stats_.anti_messages += ws.anti_messages;
+    }
+
+    for (auto& rec : processes_) {
+        rec->lp->finalize(end_time);
+    }
+
+    auto end_wall = chrono::steady_clock::now();
+    stats_.wall_time_ms = chrono::duration<double, milli>(end_wall - start_time).count();
+}
+
+} // namespace PDES
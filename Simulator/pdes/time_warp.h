@@ -0,0 +1,112 @@
+#ifndef TIME_WARP_H
+#define TIME_WARP_H
+
+#include "pdes/logical_process.h"
+#include "common/thread_pool.h"
+#include <set>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace PDES {
+
+/**
+ * Оптимистичный движок Time Warp (Jefferson, 1985)
+ *
+ * LP распределяются по рабочим потокам и обрабатывают события, не дожидаясь
+ * гарантий причинности. Перед каждым событием сохраняется копия состояния LP.
+ * Сообщение из прошлого (straggler) вызывает откат: состояние восстанавливается,
+ * отменённые события возвращаются в очередь, а посланные ими сообщения
+ * отзываются антисообщениями (агрессивная отмена). Глобальное виртуальное
+ * время (GVT) вычисляется синхронно на барьере; всё, что старше GVT,
+ * зафиксировано и удаляется (fossil collection).
+ */
+class TimeWarpEngine : public Kernel {
+public:
+    struct Config {
+        size_t threads = 0;               // 0 = min(число ядер, число LP)
+        size_t gvt_interval = 2048;       // событий на поток между вычислениями GVT
+        double optimism_window = std::numeric_limits<double>::infinity();  // окно GVT + W
+    };
+
+    struct Stats {
+        long long events_processed = 0;   // включая отменённые
+        long long events_rolled_back = 0;
+        long long rollbacks = 0;
+        long long anti_messages = 0;
+        long long gvt_rounds = 0;
+        double wall_time_ms = 0.0;
+
+        long long events_committed() const { return events_processed - events_rolled_back; }
+        double efficiency() const {
+            return events_processed > 0 ? static_cast<double>(events_committed()) / events_processed : 1.0;
+        }
+    };
+
+private:
+    struct Processed {
+        Message event;
+        std::unique_ptr<StateSnapshot> before;   // состояние до обработки события
+        std::vector<Message> sent;               // посланные сообщения (для отмены)
+    };
+
+    struct ProcessRecord {
+        std::unique_ptr<LogicalProcess> lp;
+        int id = -1;
+        size_t owner = 0;
+        std::set<Message, Message::Order> pending;
+        std::deque<Processed> processed;
+
+        std::mutex mailbox_mutex;
+        std::vector<Message> mailbox;
+    };
+
+    struct WorkerStats {
+        long long processed = 0;
+        long long rolled_back = 0;
+        long long rollbacks = 0;
+        long long anti_messages = 0;
+    };
+
+    Config config_;
+    std::vector<std::unique_ptr<ProcessRecord>> processes_;
+    Stats stats_;
+    std::atomic<uint64_t> next_message_id_;
+
+    // Синхронизация вычисления GVT
+    std::atomic<bool> gvt_requested_;
+    std::vector<double> local_minimum_;
+    double gvt_;
+    bool finished_;
+
+    void deliver(const Message& msg);
+    void cancel(ProcessRecord& rec, const Message& msg, WorkerStats& ws);
+    void rollback(ProcessRecord& rec, const Message& straggler, WorkerStats& ws);
+    void drain_mailbox(ProcessRecord& rec, WorkerStats& ws);
+    void process_next(ProcessRecord& rec, Context& ctx, WorkerStats& ws);
+    double local_minimum(size_t worker);
+    void fossil_collect(size_t worker);
+    void worker_loop(size_t worker, size_t workers, double end_time,
+                     Parallel::Barrier& barrier, WorkerStats& ws);
+
+public:
+    TimeWarpEngine();
+    explicit TimeWarpEngine(Config config);
+
+    int add_process(std::unique_ptr<LogicalProcess> process) override;
+    LogicalProcess& process(int id) override { return *processes_.at(id)->lp; }
+    size_t process_count() const override { return processes_.size(); }
+    void run(double end_time) override;
+    std::string name() const override { return "TIME_WARP"; }
+
+    const Stats& stats() const { return stats_; }
+    double gvt() const { return gvt_; }
+};
+
+} // namespace PDES
+
+#endif // TIME_WARP_H
@@ -0,0 +1,357 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include "common/event_set.h"
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <limits>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * Моделирование взаимодействием процессов на сопрограммах C++20
+ *
+ * Сущность модели - сопрограмма Process, которая ждёт модельного времени
+ * (co_await env.hold(dt)) и ресурсов (co_await server.acquire()), а не
+ * набор обработчиков событий: время наладки, отпуска, поломки и
+ * повторные попытки добавляются строками в теле процесса, без правки
+ * цикла событий. Пробуждения процессов планируются в EventSets тем же
+ * порядком (время, порядковый номер), что и события Simulator.
+ *
+ * Кадры сопрограмм берутся из пула FramePool потока: после прогрева
+ * порождение процесса на задание не обращается к системному распределителю.
+ * Окружение и его процессы принадлежат одному потоку.
+ */
+namespace Processes {
+
+/**
+ * Пул кадров сопрограмм: списки свободных блоков по классам размера
+ *
+ * Блок класса k имеет размер (k + 1)·GRANULE; кадры больше CLASSES·GRANULE
+ * берутся у системы напрямую. Пул свой у каждого потока (local()); блок,
+ * освобождённый в другом потоке, переходит в пул этого потока. При
+ * выключенном пуле (set_enabled(false)) блоки возвращаются системе сразу -
+ * для сравнения в бенчмарке.
+ */
+class FramePool {
+public:
+    static constexpr size_t GRANULE = 64;
+    static constexpr size_t CLASSES = 16;     // до 1 КиБ
+
+private:
+    struct Block { Block* next; };
+
+    Block* free_[CLASSES] = {};
+    size_t allocations_ = 0;                  // блоков от системного распределителя
+    size_t reused_ = 0;                       // выдано из списков свободных
+    bool enabled_ = true;
+
+    static size_t size_class(size_t size) { return (size + GRANULE - 1) / GRANULE - 1; }
+
+public:
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    ~FramePool() {
+        for (Block*& head : free_) {
+            while (head) {
+                Block* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+
+    static FramePool& local() {
+        thread_local FramePool pool;
+        return pool;
+    }
+
+    void* allocate(size_t size) {
+        size_t k = size_class(size);
+        if (k >= CLASSES) {
+            ++allocations_;
+            return ::operator new(size);
+        }
+        if (Block* block = free_[k]) {
+            free_[k] = block->next;
+            ++reused_;
+            return block;
+        }
+        ++allocations_;
+        return ::operator new((k + 1) * GRANULE);
+    }
+
+    void deallocate(void* p, size_t size) {
+        size_t k = size_class(size);
+        if (k >= CLASSES || !enabled_) {
+            ::operator delete(p);
+            return;
+        }
+        Block* block = static_cast<Block*>(p);
+        block->next = free_[k];
+        free_[k] = block;
+    }
+
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+    size_t allocations() const { return allocations_; }
+    size_t reused() const { return reused_; }
+};
+
+/**
+ * Пробуждение процесса; порядок как у Event: время, затем порядок планирования
+ */
+struct Wakeup {
+    double time;
+    unsigned long long seq;
+    std::coroutine_handle<> handle;
+
+    bool operator>(const Wakeup& other) const {
+        if (time != other.time) return time > other.time;
+        return seq > other.seq;
+    }
+};
+
+using EventSetType = EventSets::EventSetFactory<Wakeup>::Type;
+
+class Environment;
+
+/**
+ * Процесс - сопрограмма модели; начинает работу после Environment::spawn()
+ *
+ * Завершившийся процесс освобождает свой кадр сам; процессы, не
+ * дошедшие до конца к уничтожению окружения, уничтожаются вместе с ним.
+ */
+class Process {
+public:
+    struct promise_type {
+        Environment* env = nullptr;
+        promise_type* prev = nullptr;         // список живых процессов окружения
+        promise_type* next = nullptr;
+
+        Process get_return_object() {
+            return Process(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception();
+        ~promise_type();
+
+        static void* operator new(size_t size) { return FramePool::local().allocate(size); }
+        static void operator delete(void* p, size_t size) { FramePool::local().deallocate(p, size); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+
+    explicit Process(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    friend class Environment;
+
+public:
+    Process(Process&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    Process& operator=(Process&&) = delete;
+    Process(const Process&) = delete;
+    ~Process() {
+        if (handle_) handle_.destroy();      // процесс так и не запущен
+    }
+};
+
+/**
+ * Ожидание модельного времени delay (co_await env.hold(delay)); нулевая
+ * задержка уступает очередь процессам, уже запланированным на этот момент
+ */
+class Hold {
+private:
+    Environment& env_;
+    double delay_;
+
+public:
+    Hold(Environment& env, double delay) : env_(env), delay_(delay) {}
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) const;
+    void await_resume() const noexcept {}
+};
+
+/**
+ * Окружение: модельное время, множество пробуждений и живые процессы
+ */
+class Environment {
+private:
+    double now_ = 0.0;
+    unsigned long long next_seq_ = 0;
+    long long events_processed_ = 0;
+    std::unique_ptr<EventSets::EventSet<Wakeup>> events_;
+    // Бинарная куча по умолчанию вызывается статически, как в ядре Simulator
+    EventSets::BinaryHeapEventSet<Wakeup>* heap_;
+    Process::promise_type* processes_ = nullptr;
+    size_t live_ = 0;
+    std::exception_ptr failure_;
+
+    friend struct Process::promise_type;
+
+    void link(Process::promise_type& p) {
+        p.env = this;
+        p.next = processes_;
+        if (processes_) processes_->prev = &p;
+        processes_ = &p;
+        ++live_;
+    }
+
+    void unlink(Process::promise_type& p) {
+        if (p.prev) p.prev->next = p.next; else processes_ = p.next;
+        if (p.next) p.next->prev = p.prev;
+        --live_;
+    }
+
+    Wakeup pop() { return heap_ ? heap_->pop() : events_->pop(); }
+    const Wakeup& top() const { return heap_ ? heap_->top() : events_->top(); }
+
+public:
+    explicit Environment(EventSetType type = EventSetType::BINARY_HEAP)
+        : events_(EventSets::EventSetFactory<Wakeup>::create(type)),
+          heap_(type == EventSetType::BINARY_HEAP
+                    ? static_cast<EventSets::BinaryHeapEventSet<Wakeup>*>(events_.get()) : nullptr) {}
+
+    ~Environment() {
+        while (processes_) {
+            std::coroutine_handle<Process::promise_type>::from_promise(*processes_).destroy();
+        }
+    }
+
+    Environment(const Environment&) = delete;
+    Environment& operator=(const Environment&) = delete;
+
+    double now() const { return now_; }
+    long long events_processed() const { return events_processed_; }
+    size_t processes() const { return live_; }
+    std::string event_set() const { return events_->name(); }
+
+    // Запуск процесса сейчас же: он выполняется до первого ожидания, и
+    // вызывающий продолжает после этого (без пробуждения через множество)
+    void spawn(Process process) {
+        std::coroutine_handle<Process::promise_type> handle = process.handle_;
+        process.handle_ = nullptr;
+        link(handle.promise());
+        handle.resume();
+    }
+
+    Hold hold(double delay) {
+        if (!(delay >= 0.0)) throw std::invalid_argument("Задержка процесса должна быть неотрицательной");
+        return Hold(*this, delay);
+    }
+
+    void schedule(double time, std::coroutine_handle<> handle) {
+        Wakeup wakeup{time, next_seq_++, handle};
+        if (heap_) heap_->push(wakeup); else events_->push(wakeup);
+    }
+
+    /**
+     * Пробуждения с меткой не позже until, затем время доводится до until
+     * (бесконечный until - пока есть пробуждения). Исключение процесса
+     * прерывает прогон и передаётся вызывающему.
+     */
+    void run(double until = std::numeric_limits<double>::infinity()) {
+        while (!(heap_ ? heap_->empty() : events_->empty()) && top().time <= until) {
+            Wakeup wakeup = pop();
+            now_ = wakeup.time;
+            ++events_processed_;
+            wakeup.handle.resume();
+            if (failure_) std::rethrow_exception(std::exchange(failure_, nullptr));
+        }
+        if (failure_) std::rethrow_exception(std::exchange(failure_, nullptr));
+        if (until != std::numeric_limits<double>::infinity() && until > now_) now_ = until;
+    }
+};
+
+inline void Process::promise_type::unhandled_exception() {
+    if (env) env->failure_ = std::current_exception();
+}
+
+inline Process::promise_type::~promise_type() {
+    if (env) env->unlink(*this);
+}
+
+inline void Hold::await_suspend(std::coroutine_handle<> handle) const {
+    env_.schedule(env_.now() + delay_, handle);
+}
+
+/**
+ * Ресурс из capacity одинаковых единиц (ядер) с очередью FIFO
+ *
+ * co_await acquire() занимает единицу сразу или ставит процесс в очередь;
+ * release() передаёт единицу первому ожидающему, и тот продолжает работу в
+ * тот же момент модельного времени. Интеграл занятости - для загрузки.
+ */
+class Resource {
+private:
+    Environment& env_;
+    int capacity_;
+    int busy_ = 0;
+    std::deque<std::coroutine_handle<>> waiting_;
+    double busy_area_ = 0.0;
+    double last_change_ = 0.0;
+
+    void account() {
+        busy_area_ += busy_ * (env_.now() - last_change_);
+        last_change_ = env_.now();
+    }
+
+public:
+    class Acquire {
+    private:
+        Resource& resource_;
+
+    public:
+        explicit Acquire(Resource& resource) : resource_(resource) {}
+        bool await_ready() const {
+            if (resource_.busy_ == resource_.capacity_) return false;
+            resource_.account();
+            ++resource_.busy_;
+            return true;
+        }
+        void await_suspend(std::coroutine_handle<> handle) const { resource_.waiting_.push_back(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    Resource(Environment& env, int capacity) : env_(env), capacity_(capacity) {
+        if (capacity < 1) throw std::invalid_argument("Ёмкость ресурса должна быть положительной");
+    }
+
+    Acquire acquire() { return Acquire(*this); }
+
+    void release() {
+        if (busy_ == 0) throw std::logic_error("Освобождение незанятого ресурса");
+        if (!waiting_.empty()) {
+            std::coroutine_handle<> next = waiting_.front();
+            waiting_.pop_front();
+            env_.schedule(env_.now(), next);     // единица переходит без простоя
+            return;
+        }
+        account();
+        --busy_;
+    }
+
+    int capacity() const { return capacity_; }
+    int busy() const { return busy_; }
+    bool available() const { return busy_ < capacity_; }
+    size_t queue_length() const { return waiting_.size(); }
+
+    // Средняя занятость единицы за [0, now]
+    double utilization() const {
+        double now = env_.now();
+        double area = busy_area_ + busy_ * (now - last_change_);
+        return now > 0.0 ? area / (now * capacity_) : 0.0;
+    }
+};
+
+} // namespace Processes
+
+#endif // PROCESS_H
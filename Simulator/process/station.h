@@ -0,0 +1,135 @@
+#ifndef PROCESS_STATION_H
+#define PROCESS_STATION_H
+
+#include "process/process.h"
+#include "common/random_generator.h"
+#include "common/statistics.h"
+#include <memory>
+#include <stdexcept>
+
+namespace Processes {
+
+/**
+ * Станция G/G/c/K FIFO процессами: источник и по процессу на задание
+ *
+ * Процесс задания - вся его история подряд: приход, захват ядра, работа,
+ * уход. Потоки засеваются как в Simulator::seed() и читаются в том же
+ * порядке, а показатели учитываются в те же моменты, поэтому без повторных
+ * попыток траектория совпадает с Simulator той же конфигурации с FIFO:
+ * ожидания, уходы и потери совпадают побитно. Загрузка - до округления:
+ * Resource копит интеграл занятости только при её изменении, а Simulator -
+ * на каждом событии.
+ *
+ * При retrial_rate > 0 - система с повторными попытками: задание, заставшее
+ * все ядра занятыми, не ждёт в очереди, а уходит на орбиту и повторяет
+ * попытку через Exp(retrial_rate) (поток RETRIAL_STREAM); буфер тогда не
+ * используется. В Simulator такая модель потребовала бы нового типа события
+ * и правки цикла, здесь это три строки процесса задания.
+ */
+class StationModel {
+public:
+    static constexpr uint64_t RETRIAL_STREAM = 3;   // после потоков GeneratorFactory
+
+private:
+    std::unique_ptr<RandomGenerator> arrival_;
+    std::unique_ptr<RandomGenerator> service_;
+    std::unique_ptr<RandomGenerator> retrial_;
+    int cores_;
+    int buffer_;
+    double retrial_rate_;
+    EventSetType event_set_type_;
+    VariateBuffer arrival_variates_;
+    VariateBuffer service_variates_;
+    VariateBuffer retrial_variates_;
+
+    Statistics::StreamingAccumulator wait_stats_;
+    Statistics::StreamingAccumulator system_stats_;
+    long long arrivals_ = 0;
+    long long completed_ = 0;
+    long long lost_ = 0;
+    long long retrials_ = 0;
+    double utilization_ = 0.0;
+    long long events_ = 0;
+
+    Process source(Environment& env, Resource& cores) {
+        while (true) {
+            co_await env.hold(arrival_variates_.next(*arrival_));
+            ++arrivals_;
+            double work = service_variates_.next(*service_);
+            if (retrial_rate_ <= 0.0 && buffer_ >= 0 && !cores.available() &&
+                cores.queue_length() >= static_cast<size_t>(buffer_)) {
+                ++lost_;
+                continue;
+            }
+            env.spawn(job(env, cores, work));
+        }
+    }
+
+    Process job(Environment& env, Resource& cores, double work) {
+        double arrival = env.now();
+        if (retrial_rate_ > 0.0) {
+            while (!cores.available()) {
+                ++retrials_;
+                co_await env.hold(retrial_variates_.next(*retrial_));
+            }
+        }
+        co_await cores.acquire();
+        double start = env.now();
+        co_await env.hold(work);
+        cores.release();
+        // Как в Simulator: ожидание и пребывание учитываются при уходе
+        ++completed_;
+        wait_stats_.add(start - arrival);
+        system_stats_.add(env.now() - arrival);
+    }
+
+public:
+    StationModel(const RandomGenerator& arrival, const RandomGenerator& service, int cores = 1,
+                 int buffer = -1, double retrial_rate = 0.0,
+                 EventSetType event_set_type = EventSetType::BINARY_HEAP)
+        : arrival_(arrival.clone()), service_(service.clone()),
+          retrial_(GeneratorFactory::create_exponential(retrial_rate > 0.0 ? retrial_rate : 1.0)),
+          cores_(cores), buffer_(buffer), retrial_rate_(retrial_rate), event_set_type_(event_set_type) {
+        if (cores < 1) throw std::invalid_argument("Число ядер должно быть положительным");
+        if (retrial_rate < 0.0) throw std::invalid_argument("Интенсивность повторных попыток отрицательна");
+    }
+
+    // Потоки как у Simulator::seed(); повторные попытки - поток RETRIAL_STREAM
+    void seed(uint64_t seed) {
+        arrival_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::ARRIVAL_STREAM));
+        service_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::SERVICE_STREAM));
+        retrial_->seed(GeneratorFactory::derive_seed(seed, 0, RETRIAL_STREAM));
+        arrival_variates_.reset();
+        service_variates_.reset();
+        retrial_variates_.reset();
+    }
+
+    // Прогон с пустой системы до модельного времени time
+    void run(double time) {
+        wait_stats_.reset();
+        system_stats_.reset();
+        arrivals_ = completed_ = lost_ = retrials_ = 0;
+
+        Environment env(event_set_type_);
+        Resource cores(env, cores_);
+        env.spawn(source(env, cores));
+        env.run(time);
+        utilization_ = cores.utilization();
+        events_ = env.events_processed();
+    }
+
+    double avg_wait_time() const { return wait_stats_.mean(); }
+    double avg_system_time() const { return system_stats_.mean(); }
+    double server_utilization() const { return utilization_; }
+    double loss_probability() const { return arrivals_ > 0 ? static_cast<double>(lost_) / arrivals_ : 0.0; }
+    double retrials_per_job() const { return arrivals_ > 0 ? static_cast<double>(retrials_) / arrivals_ : 0.0; }
+    long long total_arrivals() const { return arrivals_; }
+    long long jobs_completed() const { return completed_; }
+    long long jobs_lost() const { return lost_; }
+    long long events_processed() const { return events_; }
+    const Statistics::StreamingAccumulator& wait_time_stats() const { return wait_stats_; }
+};
+
+} // namespace Processes
+
+#endif // PROCESS_STATION_H
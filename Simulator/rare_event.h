@@ -0,0 +1,362 @@
+#ifndef RARE_EVENT_H
+#define RARE_EVENT_H
+
+#include "simulator.h"
+#include "replication_runner.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Оценка малых вероятностей потери (1e-6 и меньше) для систем с конечным буфером
+ *
+ * Грубое моделирование оценивает P(потери) долей потерянных заданий, и для
+ * относительной ошибки RE ему нужно около (1 - p) / (p·RE²) прибытий -
+ * при p = 1e-9 это 1e11 заданий на 10%. Оба метода здесь опираются на
+ * регенерацию: цикл начинается с прихода задания в пустую систему, и
+ *     P(потери) = γ · E[потерь | заполнение] / E[прибытий за цикл],
+ * где γ - вероятность заполнить систему (c + buffer заданий) до её
+ * опустошения. Знаменатель не редок и оценивается грубо; γ и потери после
+ * заполнения - методом ускорения:
+ *   Splitting           - расщепление с фиксированными усилиями (RESTART с
+ *                         порогами по числу заданий) на любом Simulator;
+ *                         копии траекторий - контрольные точки checkpoint();
+ *   ImportanceSampling  - экспоненциальный поворот вложенной цепи M/M/c/K
+ *                         (интенсивности прибытий и уходов меняются местами).
+ *
+ * Повторения независимы (зёрна ReplicationRunner::seed_for) и идут на пуле
+ * потоков; относительная ошибка - по разбросу повторений. Ускорение -
+ * отношение времени грубого моделирования, которое дало бы ту же
+ * относительную ошибку (по биномиальной дисперсии, то есть без учёта
+ * группирования потерь, которое грубому методу только мешает), к
+ * суммарному времени повторений.
+ */
+namespace RareEvent {
+
+/**
+ * Итог оценки по всем повторениям
+ */
+struct Estimate {
+    std::string method;
+    double probability = 0.0;            // оценка вероятности потери
+    double relative_error = 0.0;         // стандартная ошибка / оценка
+    size_t repetitions = 0;
+    double events = 0.0;                 // событий (переходов цепи) во всех повторениях
+    double cpu_time_ms = 0.0;            // суммарное время повторений
+    double crude_events = 0.0;           // грубому методу для той же относительной ошибки
+    double crude_time_ms = 0.0;          // его время при измеренной скорости событий
+    std::vector<double> level_probabilities;   // условные вероятности ступеней (Splitting)
+
+    double speedup() const { return cpu_time_ms > 0.0 ? crude_time_ms / cpu_time_ms : 0.0; }
+    double work_ratio() const { return events > 0.0 ? crude_events / events : 0.0; }
+};
+
+namespace detail {
+
+// Повторение метода: оценка и измерения для пересчёта в затраты грубого метода
+inline ReplicationMetrics repetition(double probability, double events, double ms,
+                                     double crude_events_per_arrival, double crude_ms_per_event) {
+    return {
+        {"probability", probability},
+        {"events", events},
+        {"time_ms", ms},
+        {"crude_events_per_arrival", crude_events_per_arrival},
+        {"crude_ms_per_event", crude_ms_per_event}
+    };
+}
+
+inline Estimate summarize(const std::string& method, const ReplicationReport& report) {
+    if (report.replications < 2) throw std::invalid_argument("Нужно хотя бы два повторения");
+    const auto& p = report.accumulators.at("probability");
+    Estimate e;
+    e.method = method;
+    e.repetitions = report.replications;
+    e.probability = p.mean();
+    e.relative_error = e.probability > 0.0
+        ? std::sqrt(p.variance() / static_cast<double>(report.replications)) / e.probability : 0.0;
+    e.events = report.mean("events") * report.replications;
+    e.cpu_time_ms = report.mean("time_ms") * report.replications;
+    if (e.probability > 0.0 && e.relative_error > 0.0) {
+        double arrivals = (1.0 - e.probability) / (e.probability * e.relative_error * e.relative_error);
+        e.crude_events = arrivals * report.mean("crude_events_per_arrival");
+        e.crude_time_ms = e.crude_events * report.mean("crude_ms_per_event");
+    }
+    for (size_t k = 1;; ++k) {
+        auto level = report.accumulators.find("level_" + std::to_string(k));
+        if (level == report.accumulators.end()) break;
+        e.level_probabilities.push_back(level->second.mean());
+    }
+    return e;
+}
+
+inline double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace detail
+
+// ==================== РАСЩЕПЛЕНИЕ ====================
+
+/**
+ * Расщепление с фиксированными усилиями по порогам числа заданий в системе
+ *
+ * Ступень 0 - грубый прогон cycles циклов регенерации: он даёт
+ * E[прибытий за цикл] и контрольные точки в начале каждого периода
+ * занятости. Ступень k делает effort испытаний: восстанавливает по кругу
+ * точку входа на порог L(k-1), засевает потоки заново (Simulator::seed) и
+ * моделирует до порога L(k) (успех - его состояние становится точкой
+ * входа следующей ступени) или до опустошения системы. Доля успехов p(k)
+ * - условная вероятность ступени, γ = Π p(k). Последняя ступень из
+ * состояний заполненной системы считает потери до опустошения.
+ *
+ * Точка входа берётся сразу после прибытия, поэтому работа ожидающих
+ * заданий и интервал до следующего прибытия выбираются заново
+ * (Simulator::redraw_unrevealed) вместе с новым зерном; общими у копий
+ * остаются только начатые обслуживания, и копии условно независимы при
+ * общем состоянии - это и нужно расщеплению. Подходят любые
+ * распределения и дисциплины; оценка несмещённая при любых порогах, а от
+ * их выбора зависит только дисперсия (лучше всего p(k) одного порядка).
+ */
+struct SplittingOptions {
+    std::vector<int> levels;    // пороги по возрастанию, последний - c + buffer; пусто - 2, 3, ..., c + buffer
+    size_t effort = 1000;       // испытаний на ступень
+    size_t cycles = 1000;       // циклов регенерации грубой ступени 0
+};
+
+class Splitting {
+private:
+    std::unique_ptr<RandomGenerator> arrival_;
+    std::unique_ptr<RandomGenerator> service_;
+    int cores_;
+    int buffer_;
+    QueueDisciplines::QueueStrategyFactory<Job>::Type discipline_;
+    SplittingOptions options_;
+
+    std::unique_ptr<Simulator> make() const {
+        return std::make_unique<Simulator>(arrival_->clone(), service_->clone(), cores_, buffer_, discipline_);
+    }
+
+    // Сдвиг числа событий Simulator за один resume()
+    static double advance(Simulator& sim, const Simulator::StopCondition& stop) {
+        long long before = sim.events_processed();
+        sim.resume(stop);
+        return static_cast<double>(sim.events_processed() - before);
+    }
+
+public:
+    Splitting(const RandomGenerator& arrival, const RandomGenerator& service, int cores, int buffer,
+              QueueDisciplines::QueueStrategyFactory<Job>::Type discipline =
+                  QueueDisciplines::QueueStrategyFactory<Job>::Type::FIFO,
+              SplittingOptions options = {})
+        : arrival_(arrival.clone()), service_(service.clone()), cores_(cores), buffer_(buffer),
+          discipline_(discipline), options_(std::move(options)) {
+        if (cores < 1 || buffer < 0) {
+            throw std::invalid_argument("Расщепление требует конечного буфера и хотя бы одного ядра");
+        }
+        if (options_.effort == 0 || options_.cycles == 0) {
+            throw std::invalid_argument("Число испытаний и циклов должно быть положительным");
+        }
+        int capacity = cores + buffer;
+        if (options_.levels.empty()) {
+            for (int level = 2; level <= capacity; ++level) options_.levels.push_back(level);
+        }
+        for (size_t k = 0; k < options_.levels.size(); ++k) {
+            int previous = k ? options_.levels[k - 1] : 1;
+            if (options_.levels[k] <= previous) throw std::invalid_argument("Пороги должны возрастать и быть больше 1");
+        }
+        if (!options_.levels.empty() && options_.levels.back() != capacity) {
+            throw std::invalid_argument("Последний порог должен быть ёмкостью системы c + buffer");
+        }
+    }
+
+    int capacity() const { return cores_ + buffer_; }
+    const std::vector<int>& levels() const { return options_.levels; }
+
+    /**
+     * Одно повторение с зерном seed: вероятность, затраты и p(k) ступеней ("level_k")
+     */
+    ReplicationMetrics replicate(uint64_t seed) const {
+        using Stop = Simulator::StopCondition;
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<Simulator> sim = make();
+        sim->seed(seed);
+        double events = 0.0;
+
+        // Ступень 0: грубые циклы регенерации с точками входа в начале периода занятости
+        std::vector<std::vector<uint8_t>> entrances;
+        entrances.reserve(options_.cycles);
+        const Stop busy = Stop::when([](const Simulator& s) { return s.jobs_in_system() > 0; });
+        const Stop empty = Stop::when([](const Simulator& s) { return s.jobs_in_system() == 0; });
+        for (size_t cycle = 0; cycle < options_.cycles; ++cycle) {
+            events += advance(*sim, busy);
+            entrances.push_back(sim->checkpoint());
+            events += advance(*sim, empty);
+        }
+        double crude_ms = detail::elapsed_ms(start);
+        double arrivals_per_cycle = static_cast<double>(sim->total_arrivals()) / options_.cycles;
+        double crude_events_per_arrival = events / sim->total_arrivals();
+        double crude_ms_per_event = events > 0.0 ? crude_ms / events : 0.0;
+
+        // Ступени 1..m: от порога к порогу, неудача - опустошение системы
+        ReplicationMetrics result;
+        uint64_t trial = 0;
+        double gamma = 1.0;
+        for (size_t k = 0; k < options_.levels.size() && gamma > 0.0; ++k) {
+            const int level = options_.levels[k];
+            const Stop stop = Stop::when([level](const Simulator& s) {
+                int n = s.jobs_in_system();
+                return n >= level || n == 0;
+            });
+            std::vector<std::vector<uint8_t>> next;
+            for (size_t i = 0; i < options_.effort; ++i) {
+                sim->restore(entrances[i % entrances.size()]);
+                sim->seed(GeneratorFactory::derive_seed(seed, ++trial));
+                sim->redraw_unrevealed();
+                events += advance(*sim, stop);
+                if (sim->jobs_in_system() >= level) next.push_back(sim->checkpoint());
+            }
+            double p = static_cast<double>(next.size()) / options_.effort;
+            result["level_" + std::to_string(k + 1)] = p;
+            gamma *= p;
+            entrances.swap(next);
+        }
+
+        // Последняя ступень: потери от заполнения до опустошения
+        double losses = 0.0;
+        if (gamma > 0.0) {
+            for (size_t i = 0; i < options_.effort; ++i) {
+                sim->restore(entrances[i % entrances.size()]);
+                sim->seed(GeneratorFactory::derive_seed(seed, ++trial));
+                sim->redraw_unrevealed();
+                int lost = sim->jobs_lost();
+                events += advance(*sim, empty);
+                losses += sim->jobs_lost() - lost;
+            }
+            losses /= options_.effort;
+        }
+
+        double probability = gamma * losses / arrivals_per_cycle;
+        ReplicationMetrics metrics = detail::repetition(probability, events, detail::elapsed_ms(start),
+                                                        crude_events_per_arrival, crude_ms_per_event);
+        metrics.insert(result.begin(), result.end());
+        return metrics;
+    }
+
+    // repetitions независимых повторений на пуле runner
+    Estimate run(ReplicationRunner& runner, size_t repetitions) const {
+        ReplicationReport report = runner.run(repetitions, [this](size_t, uint64_t seed) {
+            return replicate(seed);
+        });
+        return detail::summarize("расщепление", report);
+    }
+};
+
+// ==================== ВЫБОРКА ПО ЗНАЧИМОСТИ ====================
+
+/**
+ * Экспоненциальный поворот для M/M/c/K по вложенной цепи переходов
+ *
+ * В состоянии n прибытие происходит с вероятностью λ / (λ + d(n)), где
+ * d(n) = min(n, c)·μ. Для оценки γ цепь от 1 до заполнения или опустошения
+ * моделируется с переставленными интенсивностями (прибытие - d(n) / (λ + d(n)))
+ * там, где уходы преобладают; вес пути - произведение отношений
+ * вероятностей шагов. Для M/M/1 это асимптотически эффективный поворот
+ * (θ = ln(μ/λ)). После заполнения путь идёт без поворота до опустошения,
+ * и вклад цикла - вес, умноженный на число потерь. Знаменатель оценивается
+ * теми же paths циклами без поворота. Событие - один переход цепи.
+ */
+class ImportanceSampling {
+private:
+    double lambda_;
+    double mu_;
+    int cores_;
+    int capacity_;
+    size_t paths_;
+
+    double departures(int n) const { return std::min(n, cores_) * mu_; }
+
+public:
+    ImportanceSampling(double lambda, double mu, int cores, int buffer, size_t paths = 10000)
+        : lambda_(lambda), mu_(mu), cores_(cores), capacity_(cores + buffer), paths_(paths) {
+        if (lambda <= 0.0 || mu <= 0.0 || cores < 1 || buffer < 0 || paths == 0) {
+            throw std::invalid_argument("M/M/c/K: λ, μ, c и число путей должны быть положительными, "
+                                        "буфер - неотрицательным");
+        }
+    }
+
+    ReplicationMetrics replicate(uint64_t seed) const {
+        auto start = std::chrono::steady_clock::now();
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        double events = 0.0;
+
+        // Цикл без поворота от n до опустошения; arrivals и losses - счётчики цикла
+        auto plain = [&](int n, double& arrivals, double& losses) {
+            while (n > 0) {
+                events += 1.0;
+                if (unit(rng) < lambda_ / (lambda_ + departures(n))) {
+                    arrivals += 1.0;
+                    if (n == capacity_) losses += 1.0; else ++n;
+                } else {
+                    --n;
+                }
+            }
+        };
+
+        // Знаменатель: прибытий за цикл регенерации
+        double arrivals = 0.0;
+        double crude_losses = 0.0;
+        for (size_t i = 0; i < paths_; ++i) {
+            arrivals += 1.0;
+            plain(1, arrivals, crude_losses);
+        }
+        double crude_ms = detail::elapsed_ms(start);
+        double crude_events = events;
+        double arrivals_per_cycle = arrivals / paths_;
+
+        // Числитель: повёрнутый путь до заполнения, затем потери без поворота
+        double weighted = 0.0;
+        for (size_t i = 0; i < paths_; ++i) {
+            int n = 1;
+            double weight = 1.0;
+            while (n > 0 && n < capacity_) {
+                events += 1.0;
+                double d = departures(n);
+                double up = lambda_ / (lambda_ + d);
+                double twisted = lambda_ < d ? d / (lambda_ + d) : up;
+                if (unit(rng) < twisted) {
+                    weight *= up / twisted;
+                    ++n;
+                } else {
+                    weight *= (1.0 - up) / (1.0 - twisted);
+                    --n;
+                }
+            }
+            if (n == capacity_) {
+                double unused = 0.0;
+                double losses = 0.0;
+                plain(n, unused, losses);
+                weighted += weight * losses;
+            }
+        }
+
+        double probability = weighted / paths_ / arrivals_per_cycle;
+        return detail::repetition(probability, events, detail::elapsed_ms(start),
+                                  crude_events / arrivals, crude_events > 0.0 ? crude_ms / crude_events : 0.0);
+    }
+
+    Estimate run(ReplicationRunner& runner, size_t repetitions) const {
+        ReplicationReport report = runner.run(repetitions, [this](size_t, uint64_t seed) {
+            return replicate(seed);
+        });
+        return detail::summarize("выборка по значимости", report);
+    }
+};
+
+} // namespace RareEvent
+
+#endif // RARE_EVENT_H
@@ -0,0 +1,413 @@
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "simulator.h"
+#include "analytic.h"
+#include "lindley.h"
+#include "common/thread_pool.h"
+#include "common/statistics.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+// Показатели одной репликации: имя метрики → значение
+using ReplicationMetrics = std::map<std::string, double>;
+
+/**
+ * Сводный результат серии репликаций
+ *
+ * Результаты хранятся и объединяются в порядке номеров репликаций,
+ * поэтому отчёт не зависит от числа потоков и порядка их завершения.
+ * per_replication - независимые наблюдения, по которым строятся интервалы:
+ * показатели репликации, среднее антитетической пары (run_antithetic) или
+ * разность двух конфигураций на общих случайных числах (run_paired).
+ * naive_variance - дисперсия наблюдения, которую дал бы тот же объём
+ * моделирования без снижения дисперсии; по ней считается variance_reduction().
+ * Отчёт по аналитическому решению (ReplicationRunner::solved) не содержит
+ * репликаций: точные значения лежат в exact, полуширина интервалов нулевая.
+ */
+struct ReplicationReport {
+    size_t replications = 0;           // число прогонов симулятора
+    double wall_time_ms = 0.0;
+    double confidence = 0.95;
+    std::vector<ReplicationMetrics> per_replication;
+    std::map<std::string, Statistics::StreamingAccumulator> accumulators;
+    std::map<std::string, double> naive_variance;
+    ReplicationMetrics exact;
+
+    Statistics::ConfidenceInterval interval(const std::string& metric) const {
+        auto known = exact.find(metric);
+        if (known != exact.end()) {
+            return Statistics::ConfidenceInterval{known->second, 0.0, confidence, 0};
+        }
+        auto it = accumulators.find(metric);
+        if (it == accumulators.end()) {
+            throw std::invalid_argument("Неизвестная метрика: " + metric);
+        }
+        return Statistics::confidence_interval(it->second, confidence);
+    }
+
+    double mean(const std::string& metric) const {
+        return interval(metric).mean;
+    }
+
+    // Во сколько раз антитетические пары или общие случайные числа уменьшили
+    // дисперсию оценки при том же числе прогонов (1 - обычные репликации)
+    double variance_reduction(const std::string& metric) const {
+        auto naive = naive_variance.find(metric);
+        if (naive == naive_variance.end()) return 1.0;
+        double actual = accumulators.at(metric).variance();
+        return actual > 0.0 ? naive->second / actual : std::numeric_limits<double>::infinity();
+    }
+
+    /**
+     * Оценка metric с управляющими переменными: имя показателя → его
+     * известное математическое ожидание (например, input_controls() или
+     * загрузка ядер из Analytic::solve); пары берутся из тех же наблюдений
+     */
+    Statistics::ControlledEstimate controlled(const std::string& metric,
+                                              const std::map<std::string, double>& controls) const {
+        std::vector<double> y;
+        std::vector<std::vector<double>> c(controls.size());
+        std::vector<double> expected;
+        for (const auto& entry : controls) expected.push_back(entry.second);
+        for (const auto& metrics : per_replication) {
+            y.push_back(value(metrics, metric));
+            size_t j = 0;
+            for (const auto& entry : controls) c[j++].push_back(value(metrics, entry.first));
+        }
+        return Statistics::controlled_estimate(y, c, expected, confidence);
+    }
+
+    Statistics::ConfidenceInterval controlled_interval(const std::string& metric, const std::string& control,
+                                                       double control_mean) const {
+        if (exact.count(metric)) return interval(metric);
+        return controlled(metric, {{control, control_mean}}).interval;
+    }
+
+private:
+    static double value(const ReplicationMetrics& metrics, const std::string& name) {
+        auto it = metrics.find(name);
+        if (it == metrics.end()) throw std::invalid_argument("Неизвестная метрика: " + name);
+        return it->second;
+    }
+};
+
+/**
+ * Запуск независимых репликаций на пуле потоков с воспроизводимыми зёрнами
+ *
+ * Репликация index получает зерно GeneratorFactory::derive_seed(master_seed, index),
+ * поэтому последовательный и параллельный прогоны дают одинаковые результаты.
+ * Репликации раздаются пулу пакетами, чтобы тысячи коротких прогонов
+ * не упирались в накладные расходы на постановку задач.
+ */
+class ReplicationRunner {
+public:
+    using ReplicationFunction = std::function<ReplicationMetrics(size_t index, uint64_t seed)>;
+    // Репликация антитетической пары: antithetic - вторая половина пары (1 - U)
+    using AntitheticFunction = std::function<ReplicationMetrics(size_t index, uint64_t seed, bool antithetic)>;
+
+private:
+    uint64_t master_seed_;
+    double confidence_;
+    Parallel::Affinity affinity_;
+    std::unique_ptr<Parallel::ThreadPool> pool_;
+
+    // threads = 0: по потоку на логическое ЦП, при NO_SMT - на физическое ядро
+    static std::unique_ptr<Parallel::ThreadPool> make_pool(size_t threads, Parallel::Affinity affinity) {
+        if (affinity == Parallel::Affinity::NONE) return std::make_unique<Parallel::ThreadPool>(threads);
+        Parallel::Topology topology = Parallel::Topology::detect();
+        if (threads == 0) {
+            threads = affinity == Parallel::Affinity::NO_SMT ? topology.physical() : topology.logical();
+        }
+        return std::make_unique<Parallel::ThreadPool>(threads, topology.placement(affinity, threads));
+    }
+
+    static ReplicationReport merge(std::vector<ReplicationMetrics> results, double confidence) {
+        ReplicationReport report;
+        report.replications = results.size();
+        report.confidence = confidence;
+        for (const auto& metrics : results) {
+            for (const auto& [name, value] : metrics) {
+                report.accumulators[name].add(value);
+            }
+        }
+        report.per_replication = std::move(results);
+        return report;
+    }
+
+    // Прогоны produce(0..count-1) на пуле в порядке номеров
+    template<typename Produce>
+    std::vector<ReplicationMetrics> produce_all(size_t count, const Produce& produce) {
+        std::vector<ReplicationMetrics> results(count);
+        size_t grain = std::max<size_t>(1, count / (pool_->size() * 8));
+
+        std::vector<std::future<void>> batches;
+        for (size_t first = 0; first < count; first += grain) {
+            size_t last = std::min(first + grain, count);
+            batches.push_back(pool_->submit([&, first, last]() {
+                for (size_t i = first; i < last; ++i) {
+                    results[i] = produce(i);
+                }
+            }));
+        }
+        for (auto& batch : batches) {
+            batch.get();
+        }
+        return results;
+    }
+
+    // Покомпонентное объединение наблюдений a и b по общим метрикам
+    template<typename Combine>
+    static ReplicationMetrics combine(const ReplicationMetrics& a, const ReplicationMetrics& b, Combine f) {
+        ReplicationMetrics out;
+        for (const auto& [name, value] : a) {
+            auto other = b.find(name);
+            if (other != b.end()) out[name] = f(value, other->second);
+        }
+        return out;
+    }
+
+public:
+    /**
+     * @param affinity размещение рабочих потоков по ЦП (Parallel::Topology);
+     *                 закреплённые потоки дают воспроизводимые замеры
+     *                 масштабируемости, от размещения результаты не зависят
+     */
+    explicit ReplicationRunner(uint64_t master_seed = 1, size_t threads = 0, double confidence = 0.95,
+                               Parallel::Affinity affinity = Parallel::Affinity::NONE)
+        : master_seed_(master_seed),
+          confidence_(confidence),
+          affinity_(affinity),
+          pool_(make_pool(threads, affinity)) {
+        if (confidence <= 0.0 || confidence >= 1.0) {
+            throw std::invalid_argument("Доверительная вероятность должна лежать в (0, 1)");
+        }
+    }
+
+    uint64_t master_seed() const { return master_seed_; }
+    void set_master_seed(uint64_t seed) { master_seed_ = seed; }
+    size_t threads() const { return pool_->size(); }
+    Parallel::Affinity affinity() const { return affinity_; }
+    Parallel::ThreadPool& pool() { return *pool_; }
+
+    uint64_t seed_for(size_t index) const {
+        return GeneratorFactory::derive_seed(master_seed_, index);
+    }
+
+    // Параллельный прогон на пуле
+    ReplicationReport run(size_t replications, const ReplicationFunction& replicate) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<ReplicationMetrics> results =
+            produce_all(replications, [&](size_t i) { return replicate(i, seed_for(i)); });
+
+        auto end = std::chrono::steady_clock::now();
+        ReplicationReport report = merge(std::move(results), confidence_);
+        report.wall_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        return report;
+    }
+
+    // Тот же набор репликаций в вызывающем потоке (эталон для сравнения)
+    ReplicationReport run_sequential(size_t replications, const ReplicationFunction& replicate) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<ReplicationMetrics> results(replications);
+        for (size_t i = 0; i < replications; ++i) {
+            results[i] = replicate(i, seed_for(i));
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        ReplicationReport report = merge(std::move(results), confidence_);
+        report.wall_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        return report;
+    }
+
+    /**
+     * Серия G/G/1 FIFO с бесконечным буфером пакетным движком Линдли:
+     * репликации раздаются пулу группами, и в каждой группе прогоны идут в
+     * ногу по дорожкам SIMD. Зёрна - seed_for(i), как у run(), поэтому при
+     * тех же генераторах отчёт совпадает с прогоном Simulator до округления.
+     * @param jobs предел ушедших заданий вместо горизонта (0 - по времени)
+     */
+    ReplicationReport run_lindley(size_t replications, const RandomGenerator& arrival,
+                                  const RandomGenerator& service, double time, int jobs = 0) {
+        auto start = std::chrono::steady_clock::now();
+
+        Lindley::BatchEngine engine(arrival, service);
+        std::vector<ReplicationMetrics> results(replications);
+        size_t grain = std::max<size_t>(1, replications / (pool_->size() * 8));
+        grain = (grain + Lindley::LANES - 1) / Lindley::LANES * Lindley::LANES;
+        std::vector<std::future<void>> batches;
+        for (size_t first = 0; first < replications; first += grain) {
+            size_t last = std::min(first + grain, replications);
+            batches.push_back(pool_->submit([&, first, last]() {
+                std::vector<uint64_t> seeds;
+                for (size_t i = first; i < last; ++i) seeds.push_back(seed_for(i));
+                std::vector<Lindley::Replication> lanes =
+                    jobs > 0 ? engine.run_until_jobs(seeds, jobs) : engine.run(seeds, time);
+                for (size_t i = first; i < last; ++i) results[i] = lanes[i - first].metrics();
+            }));
+        }
+        for (auto& batch : batches) {
+            batch.get();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        ReplicationReport report = merge(std::move(results), confidence_);
+        report.wall_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        return report;
+    }
+
+    /**
+     * Антитетические пары: репликация i прогоняется дважды с зерном seed_for(i)
+     * - обычным потоком и отражённым (Simulator::set_antithetic). Наблюдение -
+     * среднее пары, дисперсия сравнивается с дисперсией среднего двух
+     * независимых прогонов. Выигрыш есть, когда показатель монотонен по
+     * входным величинам (времена ожидания, длины очередей).
+     */
+    ReplicationReport run_antithetic(size_t pairs, const AntitheticFunction& replicate) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<ReplicationMetrics> runs = produce_all(2 * pairs, [&](size_t j) {
+            return replicate(j / 2, seed_for(j / 2), j % 2 == 1);
+        });
+        std::vector<ReplicationMetrics> means(pairs);
+        for (size_t i = 0; i < pairs; ++i) {
+            means[i] = combine(runs[2 * i], runs[2 * i + 1], [](double a, double b) { return (a + b) / 2.0; });
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        ReplicationReport report = merge(std::move(means), confidence_);
+        report.replications = runs.size();
+        std::map<std::string, Statistics::StreamingAccumulator> single;
+        for (const auto& metrics : runs) {
+            for (const auto& [name, value] : metrics) single[name].add(value);
+        }
+        for (const auto& [name, acc] : single) report.naive_variance[name] = acc.variance() / 2.0;
+        report.wall_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        return report;
+    }
+
+    /**
+     * Разность first - second двух конфигураций на общих случайных числах:
+     * обе получают зерно seed_for(i), а отдельные потоки прибытий и
+     * обслуживания (GeneratorFactory::ARRIVAL_STREAM, SERVICE_STREAM) дают
+     * j-му заданию в обеих один и тот же интервал и одну и ту же работу.
+     * naive_variance - Var(first) + Var(second), как у независимых прогонов.
+     */
+    ReplicationReport run_paired(size_t replications, const ReplicationFunction& first,
+                                 const ReplicationFunction& second) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<ReplicationMetrics> runs = produce_all(2 * replications, [&](size_t j) {
+            return j % 2 == 0 ? first(j / 2, seed_for(j / 2)) : second(j / 2, seed_for(j / 2));
+        });
+        std::vector<ReplicationMetrics> differences(replications);
+        std::map<std::string, Statistics::StreamingAccumulator> a, b;
+        for (size_t i = 0; i < replications; ++i) {
+            differences[i] = combine(runs[2 * i], runs[2 * i + 1], [](double x, double y) { return x - y; });
+            for (const auto& [name, value] : runs[2 * i]) a[name].add(value);
+            for (const auto& [name, value] : runs[2 * i + 1]) b[name].add(value);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        ReplicationReport report = merge(std::move(differences), confidence_);
+        report.replications = runs.size();
+        for (const auto& [name, acc] : a) {
+            auto other = b.find(name);
+            if (other != b.end()) report.naive_variance[name] = acc.variance() + other->second.variance();
+        }
+        report.wall_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        return report;
+    }
+
+    // Управляющие переменные входных потоков: выборочные средние интервала и
+    // работы (collect_metrics) с известными E[A] и E[S] генераторов
+    static std::map<std::string, double> input_controls(const RandomGenerator& arrival,
+                                                        const RandomGenerator& service) {
+        return {
+            {"sampled_interarrival_time", arrival.mean()},
+            {"sampled_service_time", service.mean()}
+        };
+    }
+
+    // Отчёт без моделирования по точному решению (solution.exact)
+    ReplicationReport solved(const Analytic::Result& solution) const {
+        if (!solution.exact) {
+            throw std::invalid_argument("Для конфигурации нет точного аналитического решения");
+        }
+        ReplicationReport report;
+        report.confidence = confidence_;
+        report.exact = solution.metrics();
+        return report;
+    }
+
+    // Имя показателя интервала k: "interval[k].name"
+    static std::string interval_metric(size_t k, const std::string& name) {
+        return "interval[" + std::to_string(k) + "]." + name;
+    }
+    
+    // Имя производной показателя: "ipa.name/d_lambda", "lr.name/d_mu"
+    static std::string derivative_metric(const std::string& method, const std::string& name,
+                                         Sensitivity::Parameter parameter) {
+        return method + "." + name + (parameter == Sensitivity::LAMBDA ? "/d_lambda" : "/d_mu");
+    }
+    
+    /**
+     * Стандартный набор показателей симулятора; при включённой статистике по
+     * интервалам - и показатели каждого интервала (interval_metric):
+     * arrival_rate, avg_jobs_in_system, avg_busy_cores, loss_probability и,
+     * если в интервале пришли ушедшие задания, avg_wait_time и avg_system_time.
+     * При включённой оценке чувствительности - имеющиеся производные
+     * avg_wait_time, avg_system_time и server_utilization (derivative_metric)
+     */
+    static ReplicationMetrics collect_metrics(const Simulator& sim) {
+        ReplicationMetrics metrics = {
+            {"avg_wait_time", sim.avg_wait_time()},
+            {"avg_system_time", sim.avg_system_time()},
+            {"server_utilization", sim.server_utilization()},
+            {"loss_probability", sim.loss_probability()},
+            {"avg_queue_length", sim.avg_queue_length()},
+            {"avg_jobs_in_system", sim.avg_jobs_in_system()},
+            {"rho", sim.rho()},
+            {"jobs_completed", static_cast<double>(sim.jobs_completed())},
+            {"sampled_interarrival_time", sim.sampled_interarrival_time()},
+            {"sampled_service_time", sim.sampled_service_time()}
+        };
+        if (const Statistics::IntervalStatistics* intervals = sim.interval_statistics()) {
+            for (size_t k = 0; k < intervals->bins(); ++k) {
+                metrics[interval_metric(k, "arrival_rate")] = intervals->arrival_rate(k);
+                metrics[interval_metric(k, "avg_jobs_in_system")] = intervals->avg_jobs_in_system(k);
+                metrics[interval_metric(k, "avg_busy_cores")] = intervals->avg_busy_cores(k);
+                metrics[interval_metric(k, "loss_probability")] = intervals->loss_probability(k);
+                const Statistics::IntervalStatistics::Bin& bin = intervals->bin(k);
+                if (!bin.wait.empty()) {
+                    metrics[interval_metric(k, "avg_wait_time")] = bin.wait.mean();
+                    metrics[interval_metric(k, "avg_system_time")] = bin.system.mean();
+                }
+            }
+        }
+        if (sim.sensitivity_enabled()) {
+            Sensitivity::Estimates e = sim.sensitivity();
+            const struct { const char* method; const char* name; const Sensitivity::Derivative& value; } derivatives[] = {
+                {"ipa", "avg_wait_time", e.wait_ipa}, {"ipa", "avg_system_time", e.system_ipa},
+                {"ipa", "server_utilization", e.utilization_ipa}, {"lr", "avg_wait_time", e.wait_lr},
+                {"lr", "avg_system_time", e.system_lr}, {"lr", "server_utilization", e.utilization_lr}};
+            for (const auto& d : derivatives) {
+                for (Sensitivity::Parameter parameter : {Sensitivity::LAMBDA, Sensitivity::MU}) {
+                    double value = d.value[parameter];
+                    if (!std::isnan(value)) metrics[derivative_metric(d.method, d.name, parameter)] = value;
+                }
+            }
+        }
+        return metrics;
+    }
+};
+
+#endif // REPLICATION_RUNNER_H
@@ -1,10 +1,13 @@
 #include "simulator.h"
+#include "basic_simulator.h"
+#include "analytic.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <limits>
 
 using namespace std;
 
@@ -14,7 +17,8 @@ Simulator::Simulator(unique_ptr<RandomGenerator> arrival_gen,
                      unique_ptr<RandomGenerator> service_gen,
                      int num_cores,
                      int buffer_cap,
-                     QueueDisciplines::QueueStrategyFactory<Job>::Type queue_type)
+                     QueueDisciplines::QueueStrategyFactory<Job>::Type queue_type,
+                     EventSetType event_set_type)
     : current_time_(0.0),
       jobs_completed_(0),
       jobs_lost_(0),
@@ -24,27 +28,38 @@ Simulator::Simulator(unique_ptr<RandomGenerator> arrival_gen,
       service_generator_(std::move(service_gen)),
       num_cores_(num_cores),
       buffer_capacity_(buffer_cap),
-      queue_strategy_(QueueDisciplines::QueueStrategyFactory<Job>::create(queue_type)),
+      queue_strategy_(QueueDisciplines::QueueStrategyFactory<int>::create(queue_type)),
+      event_queue_(EventSets::EventSetFactory<Event>::create(event_set_type)),
+      next_event_seq_(0),
+      events_processed_(0),
+      cores_(num_cores),
+      sample_mode_(Statistics::SampleMode::STREAMING),
+      stats_start_time_(0.0),
       total_busy_time_(0.0),
-      last_busy_check_time_(0.0) 
+      queue_area_(0.0),
+      service_work_(0.0),
+      last_busy_check_time_(0.0),
+      system_state_(num_cores > 0 && buffer_cap >= 0
+                        ? static_cast<size_t>(num_cores + buffer_cap)
+                        : static_cast<size_t>(num_cores > 0 ? num_cores : 0) + UNBOUNDED_STATE_LIMIT),
+      started_(false) 
 {
     if (num_cores_ <= 0) {
         throw invalid_argument("Количество ядер должно быть положительным");
     }
     
     // Создаем стратегию очереди
-    queue_strategy_ = QueueDisciplines::QueueStrategyFactory<Job>::create(queue_type);
+    queue_strategy_ = QueueDisciplines::QueueStrategyFactory<int>::create(queue_type);
     
-    cores_busy_.resize(num_cores_, false);
-    cores_finish_time_.resize(num_cores_, 0.0);
-    cores_current_job_.resize(num_cores_, -1);
+    select_kernel();
 }
 
 Simulator::Simulator(unique_ptr<RandomGenerator> arrival_gen,
                      unique_ptr<RandomGenerator> service_gen,
-                     std::unique_ptr<QueueDisciplines::QueueStrategy<Job>> queue_strategy,
+                     std::unique_ptr<QueueDisciplines::QueueStrategy<int>> queue_strategy,
                      int num_cores,
-                     int buffer_cap)
+                     int buffer_cap,
+                     EventSetType event_set_type)
     : current_time_(0.0),
       jobs_completed_(0),
       jobs_lost_(0),
@@ -55,16 +70,26 @@ Simulator::Simulator(unique_ptr<RandomGenerator> arrival_gen,
       num_cores_(num_cores),
       buffer_capacity_(buffer_cap),
       queue_strategy_(std::move(queue_strategy)),
+      event_queue_(EventSets::EventSetFactory<Event>::create(event_set_type)),
+      next_event_seq_(0),
+      events_processed_(0),
+      cores_(num_cores),
+      sample_mode_(Statistics::SampleMode::STREAMING),
+      stats_start_time_(0.0),
       total_busy_time_(0.0),
-      last_busy_check_time_(0.0)
+      queue_area_(0.0),
+      service_work_(0.0),
+      last_busy_check_time_(0.0),
+      system_state_(num_cores > 0 && buffer_cap >= 0
+                        ? static_cast<size_t>(num_cores + buffer_cap)
+                        : static_cast<size_t>(num_cores > 0 ? num_cores : 0) + UNBOUNDED_STATE_LIMIT),
+      started_(false)
 {
     if (num_cores_ <= 0) {
         throw invalid_argument("Количество ядер должно быть положительным");
     }
     
-    cores_busy_.resize(num_cores_, false);
-    cores_finish_time_.resize(num_cores_, 0.0);
-    cores_current_job_.resize(num_cores_, -1);
+    select_kernel();
 }
 
 // ==================== ИНИЦИАЛИЗАЦИЯ ====================
@@ -76,280 +101,527 @@ void Simulator::initialize() {
     next_job_id_ = 0;
     total_arrivals_ = 0;
     total_busy_time_ = 0.0;
+    queue_area_ = 0.0;
+    service_work_ = 0.0;
     last_busy_check_time_ = 0.0;
+    system_state_.reset();
     
-    while (!event_queue_.empty()) event_queue_.pop();
-    queue_strategy_ = queue_strategy_->clone();
+    event_queue_->clear();
+    next_event_seq_ = 0;
+    events_processed_ = 0;
+    queue_strategy_->clear();
     active_jobs_.clear();
     
+    wait_stats_.reset();
+    system_stats_.reset();
+    if (wait_sketch_) wait_sketch_->reset();
+    if (system_sketch_) system_sketch_->reset();
+    if (warmup_) warmup_->reset();
+    if (intervals_) intervals_->reset();
+    // IPA несмещена, пока возмущение не меняет порядка обслуживания и нет потерь
+    if (sensitivity_) sensitivity_->reset(queue_strategy_->name() == "FIFO" && buffer_capacity_ == -1);
     wait_times_.clear();
     system_times_.clear();
+    stats_start_time_ = 0.0;
+    if (profile_) profile_->reset();
+    if (telemetry_) telemetry_->reset();
     
-    fill(cores_busy_.begin(), cores_busy_.end(), false);
-    fill(cores_finish_time_.begin(), cores_finish_time_.end(), 0.0);
-    fill(cores_current_job_.begin(), cores_current_job_.end(), -1);
+    cores_.reset();
+}
+
+void Simulator::seed(uint64_t seed) {
+    arrival_generator_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::ARRIVAL_STREAM));
+    service_generator_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::SERVICE_STREAM));
+    queue_strategy_->seed(GeneratorFactory::derive_seed(seed, 0, GeneratorFactory::DISCIPLINE_STREAM));
+    arrival_variates_.reset();
+    service_variates_.reset();
+}
+
+void Simulator::set_antithetic(bool enabled) {
+    arrival_generator_->set_antithetic(enabled);
+    service_generator_->set_antithetic(enabled);
+    arrival_variates_.reset();
+    service_variates_.reset();
 }
 
 // ==================== ОБНОВЛЕНИЕ СТАТИСТИКИ ЗАНЯТОСТИ ====================
 
+// Вызывается до изменения состояния событием: на интервале с прошлой проверки
+// состояние было постоянным, поэтому интегралы занятости, длины очереди и P(n)
+// накапливаются за O(1) без прохода по ядрам и без хранения траектории
 void Simulator::update_busy_statistics() {
     if (last_busy_check_time_ < current_time_) {
         double time_since_last_check = current_time_ - last_busy_check_time_;
-        int busy_cores = count_busy_cores();
+        int in_system = static_cast<int>(active_jobs_.size());
+        int busy_cores = cores_.busy_count();
         total_busy_time_ += time_since_last_check * busy_cores;
+        queue_area_ += time_since_last_check * (in_system - busy_cores);
+        system_state_.add(static_cast<size_t>(in_system), time_since_last_check);
+        if (intervals_) intervals_->add_time(last_busy_check_time_, current_time_, in_system, busy_cores);
         last_busy_check_time_ = current_time_;
     }
 }
 
 // ==================== ГЛАВНЫЙ ЦИКЛ МОДЕЛИРОВАНИЯ ====================
 
+Simulator::StopCondition Simulator::StopCondition::at_time(double time) {
+    return StopCondition{time, numeric_limits<int>::max(), nullptr};
+}
+
+Simulator::StopCondition Simulator::StopCondition::after_jobs(int jobs) {
+    return StopCondition{numeric_limits<double>::infinity(), jobs, nullptr};
+}
+
+Simulator::StopCondition Simulator::StopCondition::when(function<bool(const Simulator&)> predicate) {
+    return StopCondition{numeric_limits<double>::infinity(), numeric_limits<int>::max(), std::move(predicate)};
+}
+
 void Simulator::run(double simulation_time) {
-    auto start_time = chrono::high_resolution_clock::now();
-    
-    initialize();
-    
-    // Планируем первое прибытие
-    schedule_next_arrival();
-    
-    long long iteration_count = 0;
-    const long long MAX_ITERATIONS = 100000000;
-    
-    // Главный цикл событий
-    while (!event_queue_.empty() && current_time_ < simulation_time) {
-        iteration_count++;
-        
-        if (iteration_count > MAX_ITERATIONS) {
-            cout << "Прервано: достигнуто максимальное количество итераций\n";
-            break;
-        }
-        
-        // Извлекаем ближайшее событие
-        Event next_event = event_queue_.top();
-        event_queue_.pop();
-        
-        // Обновляем время
-        current_time_ = next_event.time;
-        
-        // Обновляем статистику занятости
-        update_busy_statistics();
-        
-        // Обрабатываем событие
-        switch (next_event.type) {
-            case Event::ARRIVAL:
-                process_arrival();
-                break;
-            case Event::DEPARTURE:
-                process_departure(next_event.job_id, next_event.core_id);
-                break;
-        }
-    }
-    
-    // Финальный сбор статистики
-    update_busy_statistics();
-    
-    auto end_time = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::milliseconds>(end_time - start_time);
+    run_until(StopCondition::at_time(simulation_time));
 }
 
 void Simulator::run_until_jobs(int jobs_to_process) {
-    auto start_time = chrono::high_resolution_clock::now();
-    
-    initialize();
-    
-    // Планируем первое прибытие
-    schedule_next_arrival();
+    run_until(StopCondition::after_jobs(jobs_to_process));
+}
+
+void Simulator::run_until(const StopCondition& stop) {
+    (this->*kernel_.start)();
+    advance(stop);
+}
+
+void Simulator::resume(const StopCondition& stop) {
+    if (!started_) (this->*kernel_.start)();
+    advance(stop);
+}
+
+void Simulator::advance(const StopCondition& stop) {
+    (this->*(profile_ ? kernel_.advance_profiled : kernel_.advance))(stop);
+}
+
+Simulator::PrecisionResult Simulator::run_until_precision(double rel_half_width, double confidence,
+                                                          int max_jobs) {
+    if (rel_half_width <= 0.0) {
+        throw invalid_argument("Требуемая точность должна быть положительной");
+    }
+    if (confidence <= 0.0 || confidence >= 1.0) {
+        throw invalid_argument("Доверительная вероятность должна лежать в (0, 1)");
+    }
     
-    long long iteration_count = 0;
-    const long long MAX_ITERATIONS = 100000000;
+    const int MIN_CHECKPOINT = 2000;      // заданий до первой проверки
+    const size_t CI_BATCHES = 20;         // групп для доверительного интервала
+    constexpr double CHECKPOINT_GROWTH = 1.25;
+    
+    PrecisionResult result{false, 0.0, 0, 0, {0.0, 0.0, confidence, 0}};
+    enable_warmup_detection(true);
+    (this->*kernel_.start)();
+    
+    auto next_checkpoint = [max_jobs](long long done, long long base) {
+        long long next = max(static_cast<long long>(done * CHECKPOINT_GROWTH), done + base);
+        return static_cast<int>(min(next, static_cast<long long>(max_jobs)));
+    };
+    
+    // Фаза 1: поиск конца разгона
+    int processed = 0;
+    int target = min(MIN_CHECKPOINT, max_jobs);
+    Statistics::MserTruncation::Result warmup{0, 0, false, 0.0};
+    while (true) {
+        advance(StopCondition::after_jobs(target));
+        processed = jobs_completed_;
+        warmup = warmup_->evaluate();
+        if (warmup.reliable || processed >= max_jobs || event_queue_->empty()) break;
+        target = next_checkpoint(processed, MIN_CHECKPOINT);
+    }
+    result.warmup_jobs = static_cast<long long>(warmup.truncated_observations);
+    if (!warmup.reliable) {
+        result.jobs_observed = jobs_completed_;
+        result.wait_time = warmup_->batch_means_interval(0, CI_BATCHES, confidence);
+        return result;
+    }
     
-    // Главный цикл событий
-    while (!event_queue_.empty() && jobs_completed_ < jobs_to_process) {
-        iteration_count++;
-        
-        if (iteration_count > MAX_ITERATIONS) {
-            cout << "Прервано: достигнуто максимальное количество итераций\n";
+    // Всё до текущего момента отбрасывается: отсечение по MSER-5 не позже него
+    result.warmup_deleted_time = current_time_;
+    reset_statistics();
+    
+    // Фаза 2: накопление до требуемой точности
+    int remaining = max_jobs - processed;
+    target = min(MIN_CHECKPOINT, remaining);
+    while (true) {
+        advance(StopCondition::after_jobs(target));
+        result.wait_time = warmup_->batch_means_interval(0, CI_BATCHES, confidence);
+        if (warmup_->batch_count() >= CI_BATCHES &&
+            result.wait_time.relative_half_width() <= rel_half_width) {
+            result.converged = true;
             break;
         }
-        
-        // Извлекаем ближайшее событие
-        Event next_event = event_queue_.top();
-        event_queue_.pop();
-        
-        // Обновляем время
-        current_time_ = next_event.time;
-        
-        // Обновляем статистику занятости
-        update_busy_statistics();
-        
-        // Обрабатываем событие
-        switch (next_event.type) {
-            case Event::ARRIVAL:
-                process_arrival();
-                break;
-            case Event::DEPARTURE:
-                process_departure(next_event.job_id, next_event.core_id);
-                break;
-        }
+        if (jobs_completed_ >= remaining || event_queue_->empty()) break;
+        target = min(next_checkpoint(jobs_completed_, MIN_CHECKPOINT), remaining);
     }
-    
-    // Финальный сбор статистики
+    result.jobs_observed = jobs_completed_;
+    return result;
+}
+
+void Simulator::reset_statistics() {
     update_busy_statistics();
+    stats_start_time_ = current_time_;
     
-    auto end_time = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::milliseconds>(end_time - start_time);
+    jobs_completed_ = 0;
+    jobs_lost_ = 0;
+    total_arrivals_ = 0;
+    total_busy_time_ = 0.0;
+    queue_area_ = 0.0;
+    service_work_ = 0.0;
+    system_state_.reset();
+    cores_.restart_accounting(current_time_);
+    
+    wait_stats_.reset();
+    system_stats_.reset();
+    if (wait_sketch_) wait_sketch_->reset();
+    if (system_sketch_) system_sketch_->reset();
+    if (warmup_) warmup_->reset();
+    if (intervals_) intervals_->reset();
+    if (sensitivity_) sensitivity_->reset_statistics(current_time_);
+    wait_times_.clear();
+    system_times_.clear();
 }
 
-// ==================== ОБРАБОТКА СОБЫТИЙ ====================
+// ==================== КОНТРОЛЬНЫЕ ТОЧКИ ====================
 
-void Simulator::process_arrival() {
-    total_arrivals_++;
-    
-    // Генерируем время обслуживания
-    double service_time = service_generator_->generate();
-    
-    // Создаем задание
-    Job new_job(next_job_id_++, current_time_, service_time);
-    add_job(new_job);
-    
-    // Ищем свободное ядро
-    int free_core = find_free_core();
+namespace {
+
+const uint32_t CHECKPOINT_MAGIC = 0x4B434753;   // "SGCK"
+const uint32_t CHECKPOINT_VERSION = 5;       // 5: производные по параметрам
+
+}
+
+// Конфигурация, с которой совместима контрольная точка
+std::string Simulator::checkpoint_signature() const {
+    return arrival_generator_->name() + "|" + service_generator_->name() + "|" +
+           to_string(num_cores_) + "|" + to_string(buffer_capacity_) + "|" +
+           queue_strategy_->name() + "|" + event_queue_->name();
+}
+
+std::vector<uint8_t> Simulator::checkpoint() const {
+    Serialization::Writer out;
+    out.write(CHECKPOINT_MAGIC);
+    out.write(CHECKPOINT_VERSION);
+    out.write_string(checkpoint_signature());
+    
+    // Системные переменные
+    out.write(current_time_);
+    out.write(jobs_completed_);
+    out.write(jobs_lost_);
+    out.write(next_job_id_);
+    out.write(total_arrivals_);
+    out.write(next_event_seq_);
+    out.write(events_processed_);
+    out.write(started_);
+    
+    // Случайные потоки вместе с предвыбранными значениями
+    arrival_generator_->save_state(out);
+    service_generator_->save_state(out);
+    arrival_variates_.save_state(out);
+    service_variates_.save_state(out);
+    
+    // Состояние системы
+    queue_strategy_->save(out);
+    vector<Event> events;
+    events.reserve(event_queue_->size());
+    event_queue_->collect(events);
+    out.write_vector(events);
+    active_jobs_.save(out);
+    cores_.save(out);
+    
+    // Статистика
+    out.write(sample_mode_);
+    out.write(wait_stats_);
+    out.write(system_stats_);
+    out.write(wait_sketch_ != nullptr);
+    if (wait_sketch_) wait_sketch_->save(out);
+    out.write(system_sketch_ != nullptr);
+    if (system_sketch_) system_sketch_->save(out);
+    out.write_vector(wait_times_);
+    out.write_vector(system_times_);
+    out.write(warmup_ != nullptr);
+    if (warmup_) warmup_->save(out);
+    out.write(intervals_ != nullptr);
+    if (intervals_) intervals_->save(out);
+    out.write(sensitivity_ != nullptr);
+    if (sensitivity_) sensitivity_->save(out);
+    out.write(stats_start_time_);
+    out.write(total_busy_time_);
+    out.write(queue_area_);
+    out.write(service_work_);
+    out.write(last_busy_check_time_);
+    system_state_.save(out);
+    
+    return out.release();
+}
+
+void Simulator::restore(const std::vector<uint8_t>& blob) {
+    Serialization::Reader in(blob);
+    if (in.read<uint32_t>() != CHECKPOINT_MAGIC) {
+        throw invalid_argument("Данные не являются контрольной точкой симулятора");
+    }
+    if (in.read<uint32_t>() != CHECKPOINT_VERSION) {
+        throw invalid_argument("Неподдерживаемая версия контрольной точки");
+    }
+    std::string signature = in.read_string();
+    if (signature != checkpoint_signature()) {
+        throw invalid_argument("Контрольная точка несовместима с конфигурацией: " + signature);
+    }
     
-    if (free_core != -1) {
-        // Начинаем обслуживание немедленно
-        active_jobs_[new_job.id].start_time = current_time_;
-        occupy_core(free_core, new_job.id, current_time_ + service_time);
-        schedule_departure(new_job.id, free_core, service_time);
-    } else {
-        // Все ядра заняты - проверяем буфер
-        if (buffer_full()) {
-            // Буфер полон - теряем задание
-            jobs_lost_++;
-            active_jobs_.erase(new_job.id);
-        } else {
-            // Помещаем в очередь
-            queue_strategy_->push(new_job);
+    in.read(current_time_);
+    in.read(jobs_completed_);
+    in.read(jobs_lost_);
+    in.read(next_job_id_);
+    in.read(total_arrivals_);
+    in.read(next_event_seq_);
+    in.read(events_processed_);
+    in.read(started_);
+    
+    arrival_generator_->load_state(in);
+    service_generator_->load_state(in);
+    arrival_variates_.load_state(in);
+    service_variates_.load_state(in);
+    
+    queue_strategy_->load(in);
+    vector<Event> events;
+    in.read_vector(events);
+    event_queue_->clear();
+    for (const Event& event : events) event_queue_->push(event);
+    active_jobs_.load(in);
+    cores_.load(in);
+    
+    in.read(sample_mode_);
+    in.read(wait_stats_);
+    in.read(system_stats_);
+    enable_quantiles(in.read<bool>());
+    if (wait_sketch_) wait_sketch_->load(in);
+    if (in.read<bool>() != (system_sketch_ != nullptr)) {
+        throw runtime_error("Контрольная точка повреждена: гистограммы квантилей");
+    }
+    if (system_sketch_) system_sketch_->load(in);
+    in.read_vector(wait_times_);
+    in.read_vector(system_times_);
+    enable_warmup_detection(in.read<bool>());
+    if (warmup_) warmup_->load(in);
+    if (in.read<bool>() != (intervals_ != nullptr)) {
+        throw invalid_argument("Контрольная точка несовместима: статистика по интервалам");
+    }
+    if (intervals_) intervals_->load(in);
+    if (in.read<bool>() != (sensitivity_ != nullptr)) {
+        throw invalid_argument("Контрольная точка несовместима: оценка чувствительности");
+    }
+    if (sensitivity_) sensitivity_->load(in);
+    in.read(stats_start_time_);
+    in.read(total_busy_time_);
+    in.read(queue_area_);
+    in.read(service_work_);
+    in.read(last_busy_check_time_);
+    system_state_.load(in);
+    
+    if (!in.at_end()) {
+        throw runtime_error("Контрольная точка повреждена: лишние данные в конце");
+    }
+}
+
+void Simulator::redraw_unrevealed() {
+    bool arrived_now = false;
+    active_jobs_.for_each([this, &arrived_now](int, Job& job) {
+        if (job.arrival_time == current_time_) arrived_now = true;
+        if (job.start_time >= 0) return;
+        double work = service_variates_.next(*service_generator_);
+        service_work_ += work - job.service_time;
+        job.service_time = work;
+    });
+    if (!arrived_now) return;
+    
+    // Множество событий не умеет менять ключ: пересобираем его с тем же seq
+    vector<Event> events;
+    events.reserve(event_queue_->size());
+    event_queue_->collect(events);
+    event_queue_->clear();
+    for (Event& event : events) {
+        if (event.type == Event::ARRIVAL) {
+            event.time = current_time_ + arrival_variates_.next(*arrival_generator_);
         }
+        event_queue_->push(event);
     }
-    
-    // Планируем следующее прибытие
-    schedule_next_arrival();
 }
 
-void Simulator::process_departure(int job_id, int core_id) {
-    // Находим задание
-    auto it = active_jobs_.find(job_id);
-    if (it == active_jobs_.end()) {
-        cerr << "Ошибка: задание " << job_id << " не найдено\n";
-        return;
+void Simulator::save_checkpoint(const std::string& filename) const {
+    std::vector<uint8_t> blob = checkpoint();
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Не удалось открыть файл " + filename);
     }
+    file.write(reinterpret_cast<const char*>(blob.data()), static_cast<streamsize>(blob.size()));
+    if (!file) {
+        throw runtime_error("Ошибка записи контрольной точки в " + filename);
+    }
+}
+
+void Simulator::load_checkpoint(const std::string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Не удалось открыть файл " + filename);
+    }
+    std::vector<uint8_t> blob((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    restore(blob);
+}
+
+// ==================== ВЫБОР ЯДРА ЦИКЛА СОБЫТИЙ ====================
+
+namespace {
+
+template<typename T, typename Base>
+bool is_exactly(const Base& object) {
+    return dynamic_cast<const T*>(&object) != nullptr;
+}
+
+} // namespace
+
+void Simulator::select_kernel() {
+    using FIFO = QueueDisciplines::FIFOStrategy<int>;
     
-    Job& job = it->second;
-    job.finish_time = current_time_;
-    
-    // Записываем статистику
-    record_wait_time(job.wait_time());
-    record_system_time(job.system_time());
-    
-    // Освобождаем ядро
-    release_core(core_id);
-    
-    // Увеличиваем счетчик обработанных заданий
-    jobs_completed_++;
-    
-    // Удаляем задание
-    active_jobs_.erase(it);
-    
-    // Проверяем очередь
-    if (!queue_strategy_->empty()) {
-        Job next_job = queue_strategy_->pop();
-        
-        // Начинаем обслуживание следующего задания
-        auto next_it = active_jobs_.find(next_job.id);
-        if (next_it != active_jobs_.end()) {
-            Job& job_to_start = next_it->second;
-            job_to_start.start_time = current_time_;
-            
-            double service_time = job_to_start.service_time;
-            occupy_core(core_id, job_to_start.id, current_time_ + service_time);
-            schedule_departure(job_to_start.id, core_id, service_time);
+    // Частые конфигурации получают полностью встроенные экземпляры цикла
+    if (is_exactly<FIFO>(*queue_strategy_) && is_exactly<ExponentialGenerator>(*arrival_generator_)) {
+        const RandomGenerator& service = *service_generator_;
+        if (is_exactly<ExponentialGenerator>(service)) {
+            bind_kernel<ExponentialGenerator, ExponentialGenerator, FIFO>("M/M/c FIFO");
+            return;
+        }
+        if (is_exactly<DeterministicGenerator>(service)) {
+            bind_kernel<ExponentialGenerator, DeterministicGenerator, FIFO>("M/D/c FIFO");
+            return;
+        }
+        if (is_exactly<ErlangGenerator>(service)) {
+            bind_kernel<ExponentialGenerator, ErlangGenerator, FIFO>("M/Ek/c FIFO");
+            return;
+        }
+        if (is_exactly<UniformGenerator>(service)) {
+            bind_kernel<ExponentialGenerator, UniformGenerator, FIFO>("M/U/c FIFO");
+            return;
         }
     }
+    
+    // Остальное - через виртуальные вызовы
+    bind_kernel<RandomGenerator, RandomGenerator, QueueDisciplines::QueueStrategy<int>>("универсальное");
 }
 
 // ==================== ПЛАНИРОВАНИЕ СОБЫТИЙ ====================
 
-void Simulator::schedule_next_arrival() {
-    double interval = arrival_generator_->generate();
-    double arrival_time = current_time_ + interval;
-    
-    event_queue_.push(Event(arrival_time, Event::ARRIVAL));
+// ==================== РАБОТА С ЯДРАМИ ====================
+
+// ==================== РАБОТА С ЗАДАНИЯМИ И СТАТИСТИКОЙ ====================
+
+int Simulator::add_job(double service_time) {
+    int handle = active_jobs_.emplace(next_job_id_++, current_time_, service_time);
+    active_jobs_[handle].handle = handle;
+    return handle;
 }
 
-void Simulator::schedule_departure(int job_id, int core_id, double service_time) {
-    double departure_time = current_time_ + service_time;
-    event_queue_.push(Event(departure_time, job_id, core_id));
+void Simulator::record_wait_time(double time) {
+    wait_stats_.add(time);
+    if (wait_sketch_) wait_sketch_->add(time);
+    if (warmup_) warmup_->add(time);
+    if (sample_mode_ == Statistics::SampleMode::EXACT) wait_times_.push_back(time);
+    if (telemetry_) telemetry_->add_wait(time);
 }
 
-// ==================== РАБОТА С ЯДРАМИ ====================
+void Simulator::record_system_time(double time) {
+    system_stats_.add(time);
+    if (system_sketch_) system_sketch_->add(time);
+    if (sample_mode_ == Statistics::SampleMode::EXACT) system_times_.push_back(time);
+}
 
-int Simulator::find_free_core() const {
-    for (int i = 0; i < num_cores_; i++) {
-        if (!cores_busy_[i]) {
-            return i;
-        }
+void Simulator::enable_quantiles(bool enabled) {
+    if (enabled) {
+        if (!wait_sketch_) wait_sketch_ = make_unique<Statistics::QuantileSketch>();
+        if (!system_sketch_) system_sketch_ = make_unique<Statistics::QuantileSketch>();
+    } else {
+        wait_sketch_.reset();
+        system_sketch_.reset();
     }
-    return -1;
 }
 
-int Simulator::count_busy_cores() const {
-    int count = 0;
-    for (bool busy : cores_busy_) {
-        if (busy) count++;
+void Simulator::enable_profiling(bool enabled) {
+    if (!enabled) {
+        profile_.reset();
+        return;
+    }
+    if (!Profiling::ENABLED) {
+        throw logic_error("Профилирование исключено при сборке (SIMULATOR_PROFILING=0)");
     }
-    return count;
+    if (!profile_) profile_ = make_unique<Profiling::Profile>();
 }
 
-void Simulator::occupy_core(int core_id, int job_id, double finish_time) {
-    if (core_id < 0 || core_id >= num_cores_) {
-        throw out_of_range("Неверный идентификатор ядра");
+const Profiling::Profile& Simulator::profile() const {
+    if (!profile_) {
+        throw logic_error("Профиль недоступен: включите enable_profiling()");
     }
-    
-    cores_busy_[core_id] = true;
-    cores_finish_time_[core_id] = finish_time;
-    cores_current_job_[core_id] = job_id;
+    return *profile_;
 }
 
-void Simulator::release_core(int core_id) {
-    if (core_id < 0 || core_id >= num_cores_) {
-        throw out_of_range("Неверный идентификатор ядра");
+void Simulator::enable_telemetry(double interval, size_t capacity) {
+    if (interval == 0.0) {
+        telemetry_.reset();
+        return;
     }
-    
-    cores_busy_[core_id] = false;
-    cores_finish_time_[core_id] = 0.0;
-    cores_current_job_[core_id] = -1;
+    telemetry_ = make_shared<Telemetry::Recorder>(interval, capacity);
 }
 
-// ==================== РАБОТА С ЗАДАНИЯМИ И СТАТИСТИКОЙ ====================
-
-void Simulator::add_job(const Job& job) {
-    active_jobs_[job.id] = job;
+// Точки ряда до until при состоянии после последнего события; true - из
+// другого потока запрошена остановка прогона
+bool Simulator::sample_telemetry(double until, bool inclusive) {
+    int in_system = static_cast<int>(active_jobs_.size());
+    int busy = cores_.busy_count();
+    telemetry_->record(until, inclusive, in_system - busy, in_system, busy, events_processed_);
+    return telemetry_->take_stop_request();
 }
 
-void Simulator::record_wait_time(double time) {
-    wait_times_.push_back(time);
+void Simulator::enable_interval_statistics(double width, double period) {
+    if (width == 0.0) {
+        intervals_.reset();
+        return;
+    }
+    intervals_ = make_unique<Statistics::IntervalStatistics>(width, period);
 }
 
-void Simulator::record_system_time(double time) {
-    system_times_.push_back(time);
+void Simulator::enable_sensitivity(bool enabled) {
+    if (!enabled) {
+        sensitivity_.reset();
+        return;
+    }
+    if (dynamic_cast<const NhppGenerator*>(arrival_generator_.get())) {
+        throw invalid_argument("Производные по λ для нестационарного потока не определены");
+    }
+    if (!sensitivity_) {
+        sensitivity_ = make_unique<Sensitivity::Tracker>(*arrival_generator_, *service_generator_);
+    }
 }
 
-// ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
+Sensitivity::Estimates Simulator::sensitivity() const {
+    if (!sensitivity_) {
+        throw logic_error("Оценка чувствительности недоступна: включите enable_sensitivity()");
+    }
+    Sensitivity::Estimates estimates = sensitivity_->estimates(num_cores_);
+    if (buffer_capacity_ == -1) {
+        estimates.utilization_core_step = -server_utilization() / (num_cores_ + 1);
+    }
+    return estimates;
+}
 
-bool Simulator::buffer_full() const {
-    if (buffer_capacity_ == -1) return false;
-    return static_cast<int>(queue_strategy_->size()) >= buffer_capacity_;
+void Simulator::enable_warmup_detection(bool enabled) {
+    if (enabled) {
+        if (!warmup_) warmup_ = make_unique<Statistics::MserTruncation>();
+    } else {
+        warmup_.reset();
+    }
 }
 
+// ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
+
 double Simulator::calculate_rho() const {
     double arrival_intensity = 1.0 / arrival_generator_->mean();
     double service_intensity = 1.0 / service_generator_->mean();
@@ -361,28 +633,26 @@ double Simulator::calculate_rho() const {
 // ==================== СТАТИСТИЧЕСКИЕ МЕТОДЫ ====================
 
 double Simulator::avg_wait_time() const {
-    if (wait_times_.empty()) return 0.0;
-    
-    double sum = 0.0;
-    for (double time : wait_times_) {
-        sum += time;
-    }
-    return sum / wait_times_.size();
+    return wait_stats_.mean();
 }
 
 double Simulator::avg_system_time() const {
-    if (system_times_.empty()) return 0.0;
-    
-    double sum = 0.0;
-    for (double time : system_times_) {
-        sum += time;
-    }
-    return sum / system_times_.size();
+    return system_stats_.mean();
 }
 
 double Simulator::server_utilization() const {
-    if (current_time_ == 0.0) return 0.0;
-    return total_busy_time_ / (current_time_ * num_cores_);
+    if (observed_time() <= 0.0) return 0.0;
+    return total_busy_time_ / (observed_time() * num_cores_);
+}
+
+double Simulator::sampled_interarrival_time() const {
+    if (total_arrivals_ == 0) return 0.0;
+    return observed_time() / total_arrivals_;
+}
+
+double Simulator::sampled_service_time() const {
+    if (total_arrivals_ == 0) return 0.0;
+    return service_work_ / total_arrivals_;
 }
 
 double Simulator::loss_probability() const {
@@ -391,56 +661,64 @@ double Simulator::loss_probability() const {
 }
 
 double Simulator::avg_queue_length() const {
-    // Упрощенный расчет: среднее количество заданий в системе
-    // Для точного расчета нужно было бы делать временные семплы
-    if (current_time_ == 0.0) return 0.0;
-    
-    // Приблизительная оценка по формуле Литтла: L = λW
-    double arrival_intensity = 1.0 / arrival_generator_->mean();
-    return arrival_intensity * avg_wait_time();
+    if (observed_time() <= 0.0) return 0.0;
+    return queue_area_ / observed_time();
+}
+
+double Simulator::avg_jobs_in_system() const {
+    if (observed_time() <= 0.0) return 0.0;
+    return system_state_.area() / observed_time();
+}
+
+double Simulator::state_probability(int n) const {
+    if (n < 0) return 0.0;
+    return system_state_.probability(static_cast<size_t>(n));
 }
 
 double Simulator::avg_busy_cores() const {
-    if (current_time_ == 0.0) return 0.0;
-    return total_busy_time_ / current_time_;
+    if (observed_time() <= 0.0) return 0.0;
+    return total_busy_time_ / observed_time();
+}
+
+double Simulator::core_utilization(int core) const {
+    if (observed_time() <= 0.0) return 0.0;
+    return cores_.busy_time(core, current_time_) / observed_time();
 }
 
 double Simulator::min_wait_time() const {
-    if (wait_times_.empty()) return 0.0;
-    return *min_element(wait_times_.begin(), wait_times_.end());
+    return wait_stats_.min();
 }
 
 double Simulator::max_wait_time() const {
-    if (wait_times_.empty()) return 0.0;
-    return *max_element(wait_times_.begin(), wait_times_.end());
+    return wait_stats_.max();
 }
 
 double Simulator::wait_time_variance() const {
-    if (wait_times_.size() < 2) return 0.0;
-    
-    double mean = avg_wait_time();
-    double sum_sq = 0.0;
-    
-    for (double time : wait_times_) {
-        double diff = time - mean;
-        sum_sq += diff * diff;
-    }
-    
-    return sum_sq / (wait_times_.size() - 1);
+    return wait_stats_.variance();
 }
 
 double Simulator::system_time_variance() const {
-    if (system_times_.size() < 2) return 0.0;
-    
-    double mean = avg_system_time();
-    double sum_sq = 0.0;
-    
-    for (double time : system_times_) {
-        double diff = time - mean;
-        sum_sq += diff * diff;
+    return system_stats_.variance();
+}
+
+double Simulator::wait_time_quantile(double p) const {
+    if (sample_mode_ == Statistics::SampleMode::EXACT) {
+        return Statistics::exact_quantile(wait_times_, p);
     }
-    
-    return sum_sq / (system_times_.size() - 1);
+    if (!wait_sketch_) {
+        throw logic_error("Квантили недоступны: включите enable_quantiles() или режим EXACT");
+    }
+    return wait_sketch_->quantile(p);
+}
+
+double Simulator::system_time_quantile(double p) const {
+    if (sample_mode_ == Statistics::SampleMode::EXACT) {
+        return Statistics::exact_quantile(system_times_, p);
+    }
+    if (!system_sketch_) {
+        throw logic_error("Квантили недоступны: включите enable_quantiles() или режим EXACT");
+    }
+    return system_sketch_->quantile(p);
 }
 
 // ==================== МЕТОДЫ ВЫВОДА ====================
@@ -452,7 +730,11 @@ void Simulator::print_configuration() const {
     cout << "  Распределение обслуживания: " << service_generator_->name() << "\n";
     cout << "  Количество ядер: " << num_cores_ << "\n";
     cout << "  Ёмкость буфера: " << (buffer_capacity_ == -1 ? "∞" : to_string(buffer_capacity_)) << "\n";
-    cout << "  Дисциплина очереди: FIFO\n";
+    cout << "  Дисциплина очереди: " << queue_strategy_->name() << "\n";
+    cout << "  Множество событий: " << event_queue_->name() << "\n";
+    cout << "  Выбор свободного ядра: " << CoreAllocators::policy_name(cores_.policy()) << "\n";
+    cout << "  Ядро цикла событий: " << kernel_.name
+         << (kernel_.specialized ? " (встроенные вызовы)" : " (виртуальные вызовы)") << "\n";
     
     double rho_value = calculate_rho();
     cout << "  Загрузка системы ρ: " << rho_value;
@@ -470,6 +752,9 @@ void Simulator::print_statistics() const {
     cout << "ОСНОВНЫЕ ПОКАЗАТЕЛИ:\n";
     cout << fixed << setprecision(2);
     cout << "  Время моделирования: " << current_time_ << "\n";
+    if (stats_start_time_ > 0.0) {
+        cout << "  Отброшен разгон: статистика с момента " << stats_start_time_ << "\n";
+    }
     cout << "  Всего поступило заданий: " << total_arrivals_ << "\n";
     cout << "  Обработано заданий: " << jobs_completed_ << "\n";
     cout << "  Потеряно заданий: " << jobs_lost_ << "\n";
@@ -482,28 +767,97 @@ void Simulator::print_statistics() const {
     cout << "  Загрузка сервера: " << server_utilization() * 100 << "%\n";
     cout << "  Вероятность потери: " << loss_probability() * 100 << "%\n";
     cout << "  Среднее занятых ядер: " << avg_busy_cores() << " из " << num_cores_ << "\n";
+    if (num_cores_ > 1) {
+        double min_util = 1.0, max_util = 0.0;
+        for (int core = 0; core < num_cores_; core++) {
+            min_util = min(min_util, core_utilization(core));
+            max_util = max(max_util, core_utilization(core));
+        }
+        cout << "  Загрузка отдельных ядер (мин/макс): " << min_util * 100 << "% / " << max_util * 100 << "%\n";
+    }
+    cout << "  Выделений памяти под таблицу заданий: " << active_jobs_.allocations() << "\n";
     
-    double arrival_intensity = 1.0 / arrival_generator_->mean();
-    double lambdaW = arrival_intensity * avg_wait_time();
-    double L_approx = avg_queue_length(); // Упрощенная оценка
+    if (quantiles_enabled() || sample_mode_ == Statistics::SampleMode::EXACT) {
+        cout << "  Квантили времени ожидания p50/p99/p999: "
+             << wait_time_quantile(0.5) << " / "
+             << wait_time_quantile(0.99) << " / "
+             << wait_time_quantile(0.999) << "\n";
+    }
     
-    cout << "\nПРОВЕРКА ФОРМУЛЫ ЛИТТЛА (L ≈ λW):\n";
-    cout << "  λW = " << arrival_intensity << " × " << avg_wait_time() << " = " << lambdaW << "\n";
-    cout << "  L (приблизительно) = " << L_approx << "\n";
-    cout << "  Отклонение: " << abs(L_approx - lambdaW) / max(L_approx, 0.001) * 100 << "%\n";
+    if (profile_) {
+        const Profiling::Profile& p = *profile_;
+        cout << "\nПРОФИЛЬ ЦИКЛА СОБЫТИЙ:\n";
+        cout << "  Событий в секунду: " << setprecision(0) << p.events_per_second()
+             << setprecision(1) << " (" << p.ns_per_event() << " нс на событие)\n";
+        cout << "  Прибытие / уход: " << p.ns_per_event(Event::ARRIVAL) << " / "
+             << p.ns_per_event(Event::DEPARTURE) << " нс\n";
+        cout << "  Доли времени:";
+        for (int phase = 0; phase < Profiling::PHASE_COUNT; phase++) {
+            cout << " " << Profiling::phase_name(phase) << " "
+                 << p.phase_share(static_cast<Profiling::Phase>(phase)) * 100 << "%";
+        }
+        cout << " прочее " << p.other_share() * 100 << "%\n";
+        cout << "  Пик множества событий / очереди: " << p.peak_event_set() << " / " << p.peak_queue() << "\n";
+        cout << "  Выделений памяти за прогон: " << p.allocations() << "\n";
+        if (p.hardware_available()) {
+            using Counters = Profiling::HardwareCounters;
+            cout << "  Такты / промахи кэша / ошибки переходов на событие: "
+                 << static_cast<double>(p.hardware(Counters::CYCLES)) / p.events() << " / "
+                 << static_cast<double>(p.hardware(Counters::CACHE_MISSES)) / p.events() << " / "
+                 << static_cast<double>(p.hardware(Counters::BRANCH_MISSES)) / p.events() << "\n";
+        } else {
+            cout << "  Аппаратные счётчики недоступны (perf_event_open)\n";
+        }
+        cout << setprecision(4);
+    }
     
-    if (num_cores_ == 1 && calculate_rho() < 1.0) {
-        double rho = calculate_rho();
-        double mu = 1.0 / service_generator_->mean();
-        
-        double theoretical_wait = rho / (mu * (1 - rho));
-        double theoretical_queue = (rho * rho) / (1 - rho);
-        
-        cout << "\nСРАВНЕНИЕ С ТЕОРИЕЙ (M/M/1):\n";
-        cout << "  Теор. среднее время ожидания: " << theoretical_wait;
-        cout << " (отклонение: " << abs(avg_wait_time() - theoretical_wait) / theoretical_wait * 100 << "%)\n";
-        cout << "  Теор. средняя длина очереди: " << theoretical_queue;
-        cout << " (отклонение: " << abs(L_approx - theoretical_queue) / theoretical_queue * 100 << "%)\n";
+    // Формула Литтла проверяется по независимым оценкам: L и Lq - средние
+    // по времени, W и U - средние по заданиям, λ - интенсивность принятых заданий
+    double accepted_rate = observed_time() > 0.0 ? (total_arrivals_ - jobs_lost_) / observed_time() : 0.0;
+    double lambdaW = accepted_rate * avg_wait_time();
+    double lambdaU = accepted_rate * avg_system_time();
+    double Lq = avg_queue_length();
+    double L = avg_jobs_in_system();
+    
+    cout << "\nПРОВЕРКА ФОРМУЛЫ ЛИТТЛА (Lq = λW, L = λU):\n";
+    cout << "  λ принятых заданий: " << accepted_rate << "\n";
+    cout << "  Lq (среднее по времени) = " << Lq << ", λW = " << lambdaW;
+    cout << " (отклонение: " << abs(Lq - lambdaW) / max(Lq, 0.001) * 100 << "%)\n";
+    cout << "  L (среднее по времени) = " << L << ", λU = " << lambdaU;
+    cout << " (отклонение: " << abs(L - lambdaU) / max(L, 0.001) * 100 << "%)\n";
+    
+    // Распределение числа заданий: состояния до накопленной вероятности 0.999
+    cout << "\nРАСПРЕДЕЛЕНИЕ ЧИСЛА ЗАДАНИЙ В СИСТЕМЕ P(n):\n ";
+    const int MAX_PRINTED_STATES = 20;
+    double cumulative = 0.0;
+    size_t last_state = system_state_.max_observed();
+    for (size_t n = 0; n <= last_state && n < static_cast<size_t>(MAX_PRINTED_STATES); n++) {
+        double p = system_state_.probability(n);
+        cout << " P(" << n << ")=" << p;
+        cumulative += p;
+        if (cumulative >= 0.999) break;
+    }
+    cout << "\n";
+    
+    Analytic::Result theory = Analytic::solve(*arrival_generator_, *service_generator_,
+                                              num_cores_, buffer_capacity_);
+    if (theory.exact) {
+        auto deviation = [](double observed, double expected) {
+            return expected > 0.0 ? abs(observed - expected) / expected * 100 : 0.0;
+        };
+        cout << "\nСРАВНЕНИЕ С ТЕОРИЕЙ (" << theory.model << "):\n";
+        cout << "  Теор. среднее время ожидания: " << theory.wait_time;
+        cout << " (отклонение: " << deviation(avg_wait_time(), theory.wait_time) << "%)\n";
+        cout << "  Теор. средняя длина очереди: " << theory.queue_length;
+        cout << " (отклонение: " << deviation(Lq, theory.queue_length) << "%)\n";
+        cout << "  Теор. среднее число заданий в системе: " << theory.jobs_in_system;
+        cout << " (отклонение: " << deviation(L, theory.jobs_in_system) << "%)\n";
+        if (buffer_capacity_ != -1) {
+            cout << "  Теор. вероятность потери: " << theory.loss_probability;
+            cout << " (моделирование: " << loss_probability() << ")\n";
+        }
+        cout << "  Теор. P(0): " << theory.p0;
+        cout << " (моделирование: " << state_probability(0) << ")\n";
     }
 }
 
@@ -517,6 +871,7 @@ void Simulator::save_statistics(const std::string& filename) const {
     file << fixed << setprecision(6);
     file << "parameter,value\n";
     file << "simulation_time," << current_time_ << "\n";
+    file << "statistics_start_time," << stats_start_time_ << "\n";
     file << "total_arrivals," << total_arrivals_ << "\n";
     file << "jobs_completed," << jobs_completed_ << "\n";
     file << "jobs_lost," << jobs_lost_ << "\n";
@@ -524,10 +879,43 @@ void Simulator::save_statistics(const std::string& filename) const {
     file << "avg_system_time," << avg_system_time() << "\n";
     file << "server_utilization," << server_utilization() << "\n";
     file << "loss_probability," << loss_probability() << "\n";
+    file << "avg_queue_length," << avg_queue_length() << "\n";
+    file << "avg_jobs_in_system," << avg_jobs_in_system() << "\n";
     file << "arrival_intensity," << 1.0/arrival_generator_->mean() << "\n";
     file << "service_intensity," << 1.0/service_generator_->mean() << "\n";
     file << "rho," << calculate_rho() << "\n";
+    file << "job_table_allocations," << active_jobs_.allocations() << "\n";
+    file << "wait_time_variance," << wait_time_variance() << "\n";
+    file << "min_wait_time," << min_wait_time() << "\n";
+    file << "max_wait_time," << max_wait_time() << "\n";
+    if (quantiles_enabled() || sample_mode_ == Statistics::SampleMode::EXACT) {
+        file << "wait_time_p50," << wait_time_quantile(0.5) << "\n";
+        file << "wait_time_p99," << wait_time_quantile(0.99) << "\n";
+        file << "wait_time_p999," << wait_time_quantile(0.999) << "\n";
+    }
+    for (size_t n = 0; n <= system_state_.max_observed(); n++) {
+        file << "state_probability_" << n << "," << system_state_.probability(n) << "\n";
+    }
     
     file.close();
     cout << "Статистика сохранена в " << filename << "\n";
+    
+    if (profile_) {
+        size_t dot = filename.find_last_of('.');
+        size_t slash = filename.find_last_of('/');
+        bool has_extension = dot != string::npos && (slash == string::npos || dot > slash);
+        save_profile((has_extension ? filename.substr(0, dot) : filename) + ".profile.json");
+    }
+}
+
+void Simulator::save_profile(const std::string& filename) const {
+    const Profiling::Profile& p = profile();
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: не удалось открыть файл " << filename << "\n";
+        return;
+    }
+    const char* type_names[Profiling::Profile::EVENT_TYPES] = {"arrival", "departure"};
+    p.write_json(file, type_names);
+    cout << "Профиль сохранён в " << filename << "\n";
 }
\ No newline at end of file
@@ -3,11 +3,19 @@
 
 #include "common/random_generator.h"
 #include "common/queue_disciplines.h"
+#include "common/event_set.h"
+#include "common/job_table.h"
+#include "common/core_allocator.h"
+#include "common/statistics.h"
+#include "common/profiler.h"
+#include "common/sensitivity.h"
+#include "common/telemetry.h"
 #include <queue>
 #include <memory>
 #include <vector>
-#include <map>
 #include <string>
+#include <functional>
+#include <cstdint>
 
 // ==================== ОСНОВНЫЕ СТРУКТУРЫ ДАННЫХ ====================
 
@@ -24,12 +32,14 @@ struct Job {
     // Добавляем приоритет для дисциплины PRIORITY
     int priority;             // приоритет задания (меньше = выше приоритет)
     
+    int handle;               // дескриптор записи в таблице активных заданий
+    
     Job() : id(-1), arrival_time(0), service_time(0), 
-            start_time(-1), finish_time(-1), priority(0) {}
+            start_time(-1), finish_time(-1), priority(0), handle(-1) {}
     
     Job(int _id, double arrival, double service, int _priority = 0)
         : id(_id), arrival_time(arrival), service_time(service),
-          start_time(-1.0), finish_time(-1.0), priority(_priority) {}
+          start_time(-1.0), finish_time(-1.0), priority(_priority), handle(-1) {}
     
     double wait_time() const {
         return (start_time >= 0) ? start_time - arrival_time : 0.0;
@@ -48,24 +58,48 @@ struct Event {
     
     double time;        // время события
     Type type;          // тип события
-    int job_id;         // идентификатор задания (для DEPARTURE)
+    int job_handle;     // дескриптор задания в таблице активных заданий (для DEPARTURE)
     int core_id;        // идентификатор ядра (для DEPARTURE)
+    unsigned long long seq;  // порядковый номер планирования (разрешает равенство времён)
     
-    Event(double t, Type tp) : time(t), type(tp), job_id(-1), core_id(-1) {}
-    Event(double t, int jid, int cid) : time(t), type(DEPARTURE), job_id(jid), core_id(cid) {}
+    Event() : time(0.0), type(ARRIVAL), job_handle(-1), core_id(-1), seq(0) {}
+    Event(double t, Type tp) : time(t), type(tp), job_handle(-1), core_id(-1), seq(0) {}
+    Event(double t, int handle, int cid) : time(t), type(DEPARTURE), job_handle(handle), core_id(cid), seq(0) {}
     
-    // Для приоритетной очереди (раньше время → выше приоритет)
+    // Для приоритетной очереди (раньше время → выше приоритет).
+    // При равных временах раньше обрабатывается раньше запланированное событие,
+    // поэтому все реализации EventSet дают одинаковую траекторию.
     bool operator>(const Event& other) const {
-        return time > other.time;
+        if (time != other.time) return time > other.time;
+        return seq > other.seq;
     }
 };
 
+using EventSetType = EventSets::EventSetFactory<Event>::Type;
+
 // ==================== КЛАСС СИМУЛЯТОРА ====================
 
 /**
  * Событийно-ориентированный симулятор системы массового обслуживания
  */
 class Simulator {
+public:
+    /**
+     * Условие остановки цикла событий: срабатывает первое из заданных.
+     * По времени обрабатываются события с меткой не позже time_limit, после
+     * чего модельное время доводится до time_limit; predicate проверяется
+     * после каждого события (пустой - не проверяется).
+     */
+    struct StopCondition {
+        double time_limit;
+        int jobs_limit;
+        std::function<bool(const Simulator&)> predicate;
+        
+        static StopCondition at_time(double time);
+        static StopCondition after_jobs(int jobs);
+        static StopCondition when(std::function<bool(const Simulator&)> predicate);
+    };
+    
 private:
     // Системные переменные
     double current_time_;          // текущее системное время
@@ -77,47 +111,109 @@ private:
     // Конфигурация системы
     std::unique_ptr<RandomGenerator> arrival_generator_;
     std::unique_ptr<RandomGenerator> service_generator_;
+    VariateBuffer arrival_variates_;    // предвыборка интервалов между прибытиями
+    VariateBuffer service_variates_;    // предвыборка времён обслуживания
     int num_cores_;                // количество ядер сервера
     int buffer_capacity_;          // ёмкость буфера (-1 = бесконечный)
     
     // Дисциплина очереди 
-    std::unique_ptr<QueueDisciplines::QueueStrategy<Job>> queue_strategy_;
+    std::unique_ptr<QueueDisciplines::QueueStrategy<int>> queue_strategy_;
     
     // Состояние системы
-    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> event_queue_;
+    std::unique_ptr<EventSets::EventSet<Event>> event_queue_;
+    unsigned long long next_event_seq_;      // следующий порядковый номер события
+    long long events_processed_;             // обработано событий за прогон
     
-    std::vector<bool> cores_busy_;           // занятость ядер
-    std::vector<double> cores_finish_time_;  // время завершения на ядрах
-    std::vector<int> cores_current_job_;     // текущие задания на ядрах
+    CoreAllocators::CoreAllocator cores_;    // занятость, задания и время завершения на ядрах
     
-    std::map<int, Job> active_jobs_;         // активные задания
+    JobTables::SlabTable<Job> active_jobs_;  // активные задания (по дескриптору)
     
     // Статистика
-    std::vector<double> wait_times_;         // времена ожидания
-    std::vector<double> system_times_;       // времена пребывания в системе
+    Statistics::SampleMode sample_mode_;     // хранить ли выборку целиком
+    Statistics::StreamingAccumulator wait_stats_;
+    Statistics::StreamingAccumulator system_stats_;
+    std::unique_ptr<Statistics::QuantileSketch> wait_sketch_;    // nullptr = квантили выключены
+    std::unique_ptr<Statistics::QuantileSketch> system_sketch_;
+    std::vector<double> wait_times_;         // времена ожидания (только SampleMode::EXACT)
+    std::vector<double> system_times_;       // времена пребывания (только SampleMode::EXACT)
+    std::unique_ptr<Statistics::MserTruncation> warmup_;   // nullptr = определение разгона выключено
+    std::unique_ptr<Statistics::IntervalStatistics> intervals_;   // nullptr = по интервалам выключено
+    std::unique_ptr<Sensitivity::Tracker> sensitivity_;          // nullptr = производные выключены
+    double stats_start_time_;                // начало окна статистики (после отброса разгона)
+    std::unique_ptr<Profiling::Profile> profile_;          // nullptr = профилирование выключено
+    // nullptr = телеметрия выключена; общий с читающими потоками
+    std::shared_ptr<Telemetry::Recorder> telemetry_;
     double total_busy_time_;                 // суммарное время занятости ядер
+    double queue_area_;                      // интеграл длины очереди по времени
+    double service_work_;                    // суммарная работа поступивших заданий
     double last_busy_check_time_;            // последняя проверка занятости
+    Statistics::StateHistogram system_state_;   // время пребывания системы в состоянии n
+    
+    // Корзин гистограммы P(n) сверх числа ядер при бесконечном буфере
+    static constexpr size_t UNBOUNDED_STATE_LIMIT = 1024;
+    
+    /**
+     * Ядро цикла событий: экземпляр шаблонного цикла для конкретных типов
+     * генераторов и дисциплины (см. basic_simulator.h). Выбирается один раз
+     * при конструировании, поэтому виртуальная диспетчеризация стоит один
+     * вызов на прогон, а не несколько на каждое событие. Профилирующий
+     * экземпляр того же цикла с замерами фаз выбирается при включённом
+     * профилировании; в обычном замеров нет вовсе.
+     */
+    struct EventKernel {
+        void (Simulator::*start)();                           // initialize() и первое прибытие
+        void (Simulator::*advance)(const StopCondition&);     // продолжить до условия остановки
+        void (Simulator::*advance_profiled)(const StopCondition&);
+        const char* name;
+        bool specialized;   // все вызовы в цикле разрешены статически
+    };
+    EventKernel kernel_;
+    bool started_;                           // прогон начат: resume() продолжает его
     
     // Приватные методы
     void initialize();
+    void select_kernel();
+    bool sample_telemetry(double until, bool inclusive);
+    void advance(const StopCondition& stop);
+    
+    template<typename ArrivalDist, typename Events>
+    void start_events();
+    template<typename ArrivalDist, typename ServiceDist, typename Discipline, typename Events, bool Profiled>
+    void advance_events(const StopCondition& stop);
+    template<typename ArrivalDist, typename ServiceDist, typename Discipline, typename Events, bool Profiled>
     void process_arrival();
-    void process_departure(int job_id, int core_id);
-    
+    template<typename Discipline, typename Events, bool Profiled>
+    void process_departure(int job_handle, int core_id);
+    template<typename ArrivalDist, typename Events, bool Profiled>
     void schedule_next_arrival();
-    void schedule_departure(int job_id, int core_id, double service_time);
+    template<typename Events, bool Profiled>
+    void schedule_departure(int job_handle, int core_id, double service_time);
+    template<typename Events, bool Profiled>
+    void push_event(Event event);
     
-    int find_free_core() const;
-    void occupy_core(int core_id, int job_id, double finish_time);
-    void release_core(int core_id);
-    int count_busy_cores() const;
     void update_busy_statistics();
     
-    void add_job(const Job& job);
+    int add_job(double service_time);   // новое задание, поступившее в current_time_
     void record_wait_time(double time);
     void record_system_time(double time);
     
+    template<typename Discipline>
     bool buffer_full() const;
     double calculate_rho() const;
+    double observed_time() const { return current_time_ - stats_start_time_; }
+    std::string checkpoint_signature() const;
+    
+protected:
+    // Привязка ядра к точным типам (используется фабрикой и BasicSimulator);
+    // бинарная куча событий по умолчанию тоже вызывается статически
+    template<typename ArrivalDist, typename ServiceDist, typename Discipline>
+    void bind_kernel(const char* name);
+    template<typename ArrivalDist, typename ServiceDist, typename Discipline, typename Events>
+    void bind_kernel_with_events(const char* name);
+    
+    RandomGenerator& arrival_generator() { return *arrival_generator_; }
+    RandomGenerator& service_generator() { return *service_generator_; }
+    QueueDisciplines::QueueStrategy<int>& queue_strategy() { return *queue_strategy_; }
     
 public:
     /**
@@ -127,20 +223,25 @@ public:
      * @param num_cores количество ядер сервера
      * @param buffer_cap ёмкость буфера (-1 = бесконечный)
      * @param queue_type тип дисциплины очереди (по умолчанию FIFO)
+     * @param event_set_type реализация множества событий (по умолчанию бинарная куча)
      */
     Simulator(std::unique_ptr<RandomGenerator> arrival_gen,
               std::unique_ptr<RandomGenerator> service_gen,
               int num_cores = 1,
               int buffer_cap = -1,
               QueueDisciplines::QueueStrategyFactory<Job>::Type queue_type = 
-                  QueueDisciplines::QueueStrategyFactory<Job>::Type::FIFO);
+                  QueueDisciplines::QueueStrategyFactory<Job>::Type::FIFO,
+              EventSetType event_set_type = EventSetType::BINARY_HEAP);
     
     // Альтернативный конструктор с явной стратегией
     Simulator(std::unique_ptr<RandomGenerator> arrival_gen,
               std::unique_ptr<RandomGenerator> service_gen,
-              std::unique_ptr<QueueDisciplines::QueueStrategy<Job>> queue_strategy,
+              std::unique_ptr<QueueDisciplines::QueueStrategy<int>> queue_strategy,
               int num_cores = 1,
-              int buffer_cap = -1);
+              int buffer_cap = -1,
+              EventSetType event_set_type = EventSetType::BINARY_HEAP);
+    
+    virtual ~Simulator() = default;
     
     // Запрет копирования
     Simulator(const Simulator&) = delete;
@@ -158,11 +259,162 @@ public:
      */
     void run_until_jobs(int jobs_to_process);
     
+    // Запуск с начала до произвольного условия остановки
+    void run_until(const StopCondition& stop);
+    
+    /**
+     * Продолжение прогона с текущего состояния (очередь, события, статистика
+     * сохраняются). Пределы условия абсолютные: время модели и число
+     * обработанных заданий. Непочатый прогон сначала начинается.
+     */
+    void resume(const StopCondition& stop);
+    void resume_for(double duration) { resume(StopCondition::at_time(current_time_ + duration)); }
+    
+    /**
+     * Контрольная точка: полное состояние симулятора в двоичном блоке -
+     * множество событий, таблица заданий, очередь, ядра, состояния
+     * генераторов и вся статистика. restore() принимает блок симулятором
+     * той же конфигурации (распределения, ядра, буфер, дисциплина, множество
+     * событий), после чего resume() продолжает прогон так, будто перерыва
+     * не было. Блок привязан к платформе и версии формата; заголовок и
+     * конфигурация проверяются до изменения состояния.
+     */
+    std::vector<uint8_t> checkpoint() const;
+    void restore(const std::vector<uint8_t>& blob);
+    
+    /**
+     * Заново выбирает величины, ещё не повлиявшие на траекторию: работу
+     * ожидающих заданий (она выбирается при прибытии, а дисциплины Simulator
+     * не смотрят на длительность) и, если в текущий момент пришло задание,
+     * интервал до следующего прибытия (его возраст нулевой для любого
+     * потока восстановления). Уходы начатых заданий не меняются. После
+     * restore() и seed() копии состояния получают независимое будущее
+     * (RareEvent::Splitting).
+     */
+    void redraw_unrevealed();
+    void save_checkpoint(const std::string& filename) const;
+    void load_checkpoint(const std::string& filename);
+    
+    // Итог прогона до заданной точности
+    struct PrecisionResult {
+        bool converged;                           // точность достигнута до max_jobs
+        double warmup_deleted_time;               // модельное время отброшенного начала
+        long long warmup_jobs;                    // длина разгона по MSER-5 (в заданиях)
+        long long jobs_observed;                  // заданий в окне статистики
+        Statistics::ConfidenceInterval wait_time; // интервал для W методом групповых средних
+    };
+    
+    /**
+     * Запуск до заданной точности с автоматическим отбросом разгона
+     *
+     * Фаза 1: моделирование до тех пор, пока MSER-5 по временам ожидания
+     * не найдёт надёжную точку отсечения; всё накопленное к этому моменту
+     * отбрасывается (reset_statistics()). Фаза 2: моделирование продолжается,
+     * пока относительная полуширина доверительного интервала W по 20 групповым
+     * средним не станет не больше rel_half_width. Проверки выполняются через
+     * геометрически растущее число заданий, поэтому их стоимость мала.
+     * @param rel_half_width требуемая относительная полуширина интервала W
+     * @param confidence доверительная вероятность
+     * @param max_jobs предел обработанных заданий (в сумме по фазам)
+     */
+    PrecisionResult run_until_precision(double rel_half_width, double confidence = 0.95,
+                                        int max_jobs = 20000000);
+    
+    /**
+     * Отбрасывает накопленную статистику, не меняя состояния системы:
+     * средние по времени и по заданиям далее считаются от текущего момента
+     */
+    void reset_statistics();
+    
     // ============= МЕТОДЫ УПРАВЛЕНИЯ =============
     
+    /**
+     * Детерминированная инициализация всех случайных потоков симулятора:
+     * прибытия - поток 0, обслуживание - поток 1, дисциплина очереди - поток 2
+     * (см. GeneratorFactory::derive_seed)
+     */
+    void seed(uint64_t seed);
+    
+    // Антитетическая репликация: прибытия и обслуживание из отражённых
+    // равномерных 1 - U при том же зерне (см. ReplicationRunner::run_antithetic)
+    void set_antithetic(bool enabled);
+    
     void set_queue_strategy(QueueDisciplines::QueueStrategyFactory<Job>::Type queue_type);
-    void set_queue_strategy(std::unique_ptr<QueueDisciplines::QueueStrategy<Job>> strategy);
+    void set_queue_strategy(std::unique_ptr<QueueDisciplines::QueueStrategy<int>> strategy);
     std::string current_queue_discipline() const;
+    std::string current_event_set() const { return event_queue_->name(); }
+    
+    // Правило выбора свободного ядра (по умолчанию LOWEST_INDEX)
+    void set_core_policy(CoreAllocators::Policy policy) { cores_.set_policy(policy); }
+    CoreAllocators::Policy core_policy() const { return cores_.policy(); }
+    const CoreAllocators::CoreAllocator& core_allocator() const { return cores_; }
+    
+    // Ядро цикла событий: встроенное для M/M/c, M/D/c, M/Ek/c, M/U/c с FIFO,
+    // иначе универсальное с виртуальными вызовами
+    std::string event_kernel() const { return kernel_.name; }
+    bool kernel_specialized() const { return kernel_.specialized; }
+    
+    /**
+     * Режим накопления статистики. По умолчанию STREAMING: хранятся только
+     * потоковые накопители (O(1) памяти). EXACT дополнительно сохраняет все
+     * времена ожидания и пребывания.
+     */
+    void set_sample_mode(Statistics::SampleMode mode) { sample_mode_ = mode; }
+    Statistics::SampleMode sample_mode() const { return sample_mode_; }
+    
+    // Включает гистограммы для квантилей в режиме STREAMING
+    void enable_quantiles(bool enabled = true);
+    bool quantiles_enabled() const { return wait_sketch_ != nullptr; }
+    
+    // Подаёт времена ожидания в детектор разгона MSER-5 (включается run_until_precision)
+    void enable_warmup_detection(bool enabled = true);
+    const Statistics::MserTruncation* warmup_detector() const { return warmup_.get(); }
+    
+    /**
+     * Показатели по интервалам модельного времени ширины width (см.
+     * Statistics::IntervalStatistics): при period > 0 - профиль цикла, общий
+     * для всех периодов прогона (сутки нестационарного потока NhppGenerator).
+     * width = 0 выключает. Копится с начала прогона или reset_statistics().
+     */
+    void enable_interval_statistics(double width, double period = 0.0);
+    const Statistics::IntervalStatistics* interval_statistics() const { return intervals_.get(); }
+    
+    /**
+     * Производные W, T и загрузки по λ и μ за тот же прогон (см.
+     * Sensitivity): IPA для FIFO с бесконечным буфером, отношение
+     * правдоподобия по циклам регенерации - для любой конфигурации с
+     * экспоненциальными или эрланговскими распределениями. Включается до
+     * прогона; копится с его начала или reset_statistics(). Нестационарный
+     * поток не поддерживается.
+     */
+    void enable_sensitivity(bool enabled = true);
+    bool sensitivity_enabled() const { return sensitivity_ != nullptr; }
+    Sensitivity::Estimates sensitivity() const;
+    double statistics_start_time() const { return stats_start_time_; }
+    
+    /**
+     * Профилирование цикла событий: события в секунду и нс на событие по
+     * типам, доли времени множества событий, генераторов, дисциплины и
+     * статистики, пиковые размеры, выделения памяти и счётчики perf_event.
+     * Профиль сбрасывается в начале каждого прогона и копится по resume().
+     * При сборке с SIMULATOR_PROFILING=0 профилирующих экземпляров нет.
+     */
+    void enable_profiling(bool enabled = true);
+    bool profiling_enabled() const { return profile_ != nullptr; }
+    const Profiling::Profile& profile() const;
+    
+    /**
+     * Телеметрия прогона (см. Telemetry::Recorder): раз в interval модельного
+     * времени - длина очереди, занятые ядра, среднее ожидание за окно и
+     * события в секунду в буфер из capacity точек с прореживанием. Ряд
+     * читается из другого потока через telemetry()->snapshot(), там же
+     * request_stop() прерывает прогон в ближайший момент записи. Ряд
+     * сбрасывается в начале прогона и в контрольную точку не входит.
+     * interval = 0 выключает; выключать, пока ряд читают, можно: читатели
+     * держат свой shared_ptr.
+     */
+    void enable_telemetry(double interval, size_t capacity = Telemetry::Recorder::DEFAULT_CAPACITY);
+    std::shared_ptr<const Telemetry::Recorder> telemetry() const { return telemetry_; }
     
     // ============= СТАТИСТИЧЕСКИЕ МЕТОДЫ =============
     
@@ -170,14 +422,39 @@ public:
     double avg_system_time() const;
     double server_utilization() const;
     double loss_probability() const;
-    double avg_queue_length() const;
     double avg_busy_cores() const;
+    double core_utilization(int core) const;    // загрузка отдельного ядра
+    
+    // Средние по времени длина очереди Lq и число заданий в системе L
+    double avg_queue_length() const;
+    double avg_jobs_in_system() const;
+    
+    // Доля времени с n заданиями в системе; при бесконечном буфере последняя
+    // корзина (num_cores + UNBOUNDED_STATE_LIMIT) собирает все большие состояния
+    double state_probability(int n) const;
+    std::vector<double> state_probabilities() const { return system_state_.probabilities(); }
+    const Statistics::StateHistogram& system_state_histogram() const { return system_state_; }
     
     double min_wait_time() const;
     double max_wait_time() const;
     double wait_time_variance() const;
     double system_time_variance() const;
     
+    // Квантили (p ∈ [0,1]): точные в режиме EXACT, иначе по гистограмме
+    double wait_time_quantile(double p) const;
+    double system_time_quantile(double p) const;
+    
+    const Statistics::StreamingAccumulator& wait_time_stats() const { return wait_stats_; }
+    const Statistics::StreamingAccumulator& system_time_stats() const { return system_stats_; }
+    const Statistics::QuantileSketch* wait_time_sketch() const { return wait_sketch_.get(); }
+    const std::vector<double>& wait_time_samples() const { return wait_times_; }
+    const std::vector<double>& system_time_samples() const { return system_times_; }
+    
+    // Выборочные средние входных потоков за окно статистики: управляющие
+    // переменные с известными E[A] и E[S] (ReplicationRunner::input_controls)
+    double sampled_interarrival_time() const;
+    double sampled_service_time() const;
+    
     double rho() const { return calculate_rho(); }
     bool is_stationary() const { return calculate_rho() < 1.0; }
     
@@ -185,7 +462,9 @@ public:
     
     void print_configuration() const;
     void print_statistics() const;
+    // При включённом профилировании рядом пишется профиль <имя>.profile.json
     void save_statistics(const std::string& filename) const;
+    void save_profile(const std::string& filename) const;
     
     // ============= GETTERS =============
     
@@ -193,9 +472,12 @@ public:
     int jobs_completed() const { return jobs_completed_; }
     int jobs_lost() const { return jobs_lost_; }
     int total_arrivals() const { return total_arrivals_; }
+    long long events_processed() const { return events_processed_; }
     int jobs_in_system() const { return active_jobs_.size(); }
+    size_t job_table_allocations() const { return active_jobs_.allocations(); }
     int queue_length() const { return queue_strategy_->size(); }
-    bool is_server_busy() const { return count_busy_cores() > 0; }
+    bool is_server_busy() const { return cores_.busy_count() > 0; }
+    int busy_cores() const { return cores_.busy_count(); }
 };
 
 #endif // SIMULATOR_H
\ No newline at end of file
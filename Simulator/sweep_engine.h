@@ -0,0 +1,638 @@
+#ifndef SWEEP_ENGINE_H
+#define SWEEP_ENGINE_H
+
+#include "simulator.h"
+#include "replication_runner.h"
+#include "analytic.h"
+#include "common/thread_pool.h"
+#include "common/statistics.h"
+#include "common/results.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+// ==================== ПЛАН ЭКСПЕРИМЕНТА ====================
+
+namespace Sweep {
+
+using QueueType = QueueDisciplines::QueueStrategyFactory<Job>::Type;
+
+// Семейство распределения, параметризованное интенсивностью (среднее 1 / rate)
+enum class Distribution {
+    EXPONENTIAL,
+    DETERMINISTIC,
+    ERLANG2,
+    UNIFORM          // на [0.5 / rate, 1.5 / rate]
+};
+
+inline std::string distribution_name(Distribution d) {
+    switch (d) {
+        case Distribution::EXPONENTIAL: return "M";
+        case Distribution::DETERMINISTIC: return "D";
+        case Distribution::ERLANG2: return "E2";
+        case Distribution::UNIFORM: return "U";
+    }
+    return "?";
+}
+
+inline std::unique_ptr<RandomGenerator> make_generator(Distribution d, double rate) {
+    switch (d) {
+        case Distribution::EXPONENTIAL: return GeneratorFactory::create_exponential(rate);
+        case Distribution::DETERMINISTIC: return GeneratorFactory::create_deterministic(1.0 / rate);
+        case Distribution::ERLANG2: return GeneratorFactory::create_erlang(2, 2.0 * rate);
+        case Distribution::UNIFORM: return GeneratorFactory::create_uniform(0.5 / rate, 1.5 / rate);
+    }
+    throw std::invalid_argument("Неизвестное распределение");
+}
+
+/**
+ * Точка плана: одна конфигурация G/G/c/K
+ */
+struct Point {
+    double lambda;
+    double mu;
+    int cores;
+    int buffer;                  // -1 = бесконечный
+    QueueType discipline;
+    Distribution arrival;
+    Distribution service;
+
+    double rho() const { return lambda / (mu * cores); }
+
+    // Аналитическое решение конфигурации (см. Analytic::solve)
+    Analytic::Result solve() const {
+        return Analytic::solve(*make_generator(arrival, lambda), *make_generator(service, mu), cores, buffer);
+    }
+
+    std::string name() const {
+        return distribution_name(arrival) + "/" + distribution_name(service) + "/" +
+               std::to_string(cores) + (buffer == -1 ? "" : "/" + std::to_string(buffer)) + " " +
+               QueueDisciplines::QueueStrategyFactory<Job>::type_to_string(discipline);
+    }
+};
+
+/**
+ * Множества уровней факторов плана
+ *
+ * Интенсивность прибытий задаётся либо прямо (lambdas), либо загрузкой
+ * (loads): λ = ρ·μ·c. grid() строит полный факторный план, latin_hypercube()
+ * - латинский гиперкуб: λ (или ρ) и μ выбираются непрерывно в диапазоне
+ * своих уровней, дискретные факторы - по стратам уровней.
+ */
+struct Design {
+    std::vector<double> lambdas;
+    std::vector<double> loads;
+    std::vector<double> mus = {1.0};
+    std::vector<int> cores = {1};
+    std::vector<int> buffers = {-1};
+    std::vector<QueueType> disciplines = {QueueType::FIFO};
+    std::vector<Distribution> arrivals = {Distribution::EXPONENTIAL};
+    std::vector<Distribution> services = {Distribution::EXPONENTIAL};
+
+    std::vector<Point> grid() const {
+        validate();
+        bool by_load = !loads.empty();
+        const std::vector<double>& rates = by_load ? loads : lambdas;
+        std::vector<Point> points;
+        for (Distribution a : arrivals)
+        for (Distribution s : services)
+        for (QueueType q : disciplines)
+        for (int k : buffers)
+        for (int c : cores)
+        for (double mu : mus)
+        for (double r : rates) {
+            points.push_back(Point{by_load ? r * mu * c : r, mu, c, k, q, a, s});
+        }
+        return points;
+    }
+
+    std::vector<Point> latin_hypercube(size_t samples, uint64_t seed) const {
+        validate();
+        if (samples == 0) throw std::invalid_argument("Число точек плана должно быть положительным");
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        // Для каждого фактора - своя перестановка номеров страт
+        auto strata = [&]() {
+            std::vector<size_t> order(samples);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), rng);
+            return order;
+        };
+        auto continuous = [&](const std::vector<double>& levels, size_t stratum) {
+            auto [lo, hi] = std::minmax_element(levels.begin(), levels.end());
+            return *lo + (*hi - *lo) * (stratum + unit(rng)) / samples;
+        };
+        auto discrete = [&](auto const& levels, size_t stratum) {
+            return levels[stratum * levels.size() / samples];
+        };
+
+        bool by_load = !loads.empty();
+        std::vector<size_t> s_rate = strata(), s_mu = strata(), s_cores = strata(), s_buffer = strata(),
+                            s_queue = strata(), s_arrival = strata(), s_service = strata();
+        std::vector<Point> points;
+        for (size_t i = 0; i < samples; ++i) {
+            double mu = continuous(mus, s_mu[i]);
+            int c = discrete(cores, s_cores[i]);
+            double r = continuous(by_load ? loads : lambdas, s_rate[i]);
+            points.push_back(Point{by_load ? r * mu * c : r, mu, c, discrete(buffers, s_buffer[i]),
+                                   discrete(disciplines, s_queue[i]), discrete(arrivals, s_arrival[i]),
+                                   discrete(services, s_service[i])});
+        }
+        return points;
+    }
+
+private:
+    void validate() const {
+        if (lambdas.empty() == loads.empty()) {
+            throw std::invalid_argument("План: задайте ровно одно из lambdas или loads");
+        }
+        if (mus.empty() || cores.empty() || buffers.empty() || disciplines.empty() ||
+            arrivals.empty() || services.empty()) {
+            throw std::invalid_argument("План: у каждого фактора должен быть хотя бы один уровень");
+        }
+    }
+};
+
+/**
+ * Сводка точки плана: накопители показателей по репликациям и, если задана
+ * опорная точка, накопители парных разностей с ней (та же репликация)
+ *
+ * Точка с точным решением при аналитическом обходе не моделируется
+ * (analytic = true): показатели берутся из exact. С управляющей переменной
+ * каждый показатель накапливается в паре с загрузкой ядер, E[загрузки]
+ * которой известна: control_mean.
+ */
+struct PointSummary {
+    Point point;
+    size_t replications = 0;
+    double cpu_time_ms = 0.0;          // сумма времён репликаций точки
+    std::map<std::string, Statistics::StreamingAccumulator> metrics;
+    std::map<std::string, Statistics::StreamingAccumulator> differences;
+    bool analytic = false;
+    ReplicationMetrics exact;
+    double control_mean = 0.0;
+    std::map<std::string, Statistics::ControlVariateAccumulator> controlled;
+};
+
+struct Report {
+    std::vector<PointSummary> points;
+    size_t rows_written = 0;
+    double wall_time_ms = 0.0;
+    double confidence = 0.95;
+    int baseline = -1;
+
+    Statistics::ConfidenceInterval interval(size_t point, const std::string& metric) const {
+        const PointSummary& summary = points.at(point);
+        if (summary.analytic) {
+            auto it = summary.exact.find(metric);
+            if (it == summary.exact.end()) throw std::invalid_argument("Неизвестная метрика: " + metric);
+            return Statistics::ConfidenceInterval{it->second, 0.0, confidence, 0};
+        }
+        return find(summary.metrics, metric);
+    }
+
+    // Интервал с управляющей переменной; если она не накапливалась - обычный
+    Statistics::ConfidenceInterval controlled_interval(size_t point, const std::string& metric) const {
+        const PointSummary& summary = points.at(point);
+        auto it = summary.controlled.find(metric);
+        if (it == summary.controlled.end()) return interval(point, metric);
+        return it->second.interval(summary.control_mean, confidence);
+    }
+
+    // Интервал для разности «точка − опорная точка» по парам репликаций
+    Statistics::ConfidenceInterval difference_interval(size_t point, const std::string& metric) const {
+        if (baseline < 0) throw std::logic_error("Опорная точка плана не задана");
+        return find(points.at(point).differences, metric);
+    }
+
+    double mean(size_t point, const std::string& metric) const { return interval(point, metric).mean; }
+
+private:
+    Statistics::ConfidenceInterval find(const std::map<std::string, Statistics::StreamingAccumulator>& map,
+                                        const std::string& metric) const {
+        auto it = map.find(metric);
+        if (it == map.end()) throw std::invalid_argument("Неизвестная метрика: " + metric);
+        return Statistics::confidence_interval(it->second, confidence);
+    }
+};
+
+} // namespace Sweep
+
+// ==================== ДВИЖОК ПЕРЕБОРА ====================
+
+/**
+ * Прогон плана эксперимента: все точки × репликации на пуле потоков
+ *
+ * Работники ничего не разделяют, кроме счётчика заданий и сводок:
+ * каждая репликация строит собственный Simulator. Задания упорядочены по
+ * оценке стоимости (ожидаемое число событий) по убыванию и разбираются
+ * работниками из общего счётчика - длинные прогоны стартуют первыми, короткие
+ * заполняют хвост.
+ *
+ * Общие случайные числа (по умолчанию): репликация r во всех точках получает
+ * одно зерно derive_seed(master, r). Генераторы обращают одно и то же
+ * равномерное число, поэтому соседние точки видят согласованные потоки и
+ * парные разности показателей имеют малую дисперсию. Без общих чисел зерно
+ * выводится из (master, точка · R + r).
+ *
+ * Аналитический обход (set_short_circuit): точки, для которых Analytic::solve
+ * даёт точное решение, не моделируются. Решение предполагает стандартную
+ * модель Point, поэтому обход включается только для репликаций, которые её
+ * не меняют. Управляющая переменная (set_control_variate): в точках, где
+ * известна E[загрузки] ядер, оценки показателей корректируются по
+ * наблюдаемой загрузке той же репликации; в G/G/c с бесконечным буфером
+ * E[загрузки] = ρ, поэтому поправка работает и там, где точного решения нет.
+ * Загрузка считается по наблюдаемому интервалу, и смещение разгона делает
+ * поправку приближённой: горизонт должен быть много больше времени разгона.
+ *
+ * Строки (конфигурация точки, репликация, зерно, показатели) пишутся в
+ * столбцовый файл Results (set_output): каждый работник копит свой пакет
+ * строк без замков, а фоновый поток Results::Sink дописывает готовые пакеты
+ * (у точек с аналитическим решением строк нет). Столбцы показателей берутся
+ * из первой завершённой репликации; CSV - Results::export_csv(). В памяти
+ * остаются только накопители по точкам;
+ * они пополняются в порядке номеров репликаций (опережающие результаты
+ * ненадолго ждут предшественников), поэтому сводка не зависит от числа
+ * потоков и совпадает с run_sequential().
+ */
+class SweepEngine {
+public:
+    using Simulate = std::function<ReplicationMetrics(const Sweep::Point&, uint64_t seed)>;
+
+    // Стандартная репликация: прогон до горизонта time или до jobs заданий.
+    // Одно ядро, FIFO и бесконечный буфер считаются рекурсией Линдли
+    // (Lindley::BatchEngine) с теми же зёрнами, остальное - Simulator.
+    static Simulate standard(double time, int jobs = 0) {
+        return [time, jobs](const Sweep::Point& p, uint64_t seed) {
+            if (Lindley::applicable(p.cores, p.buffer, p.discipline)) {
+                Lindley::BatchEngine engine(*Sweep::make_generator(p.arrival, p.lambda),
+                                            *Sweep::make_generator(p.service, p.mu));
+                std::vector<Lindley::Replication> lanes =
+                    jobs > 0 ? engine.run_until_jobs({seed}, jobs) : engine.run({seed}, time);
+                return lanes[0].metrics();
+            }
+            Simulator sim(Sweep::make_generator(p.arrival, p.lambda),
+                          Sweep::make_generator(p.service, p.mu),
+                          p.cores, p.buffer, p.discipline);
+            sim.seed(seed);
+            if (jobs > 0) {
+                sim.run_until_jobs(jobs);
+            } else {
+                sim.run(time);
+            }
+            return ReplicationRunner::collect_metrics(sim);
+        };
+    }
+
+private:
+    Parallel::ThreadPool& pool_;
+    uint64_t master_seed_;
+    size_t replications_;
+    bool common_random_numbers_;
+    bool short_circuit_;
+    bool control_variate_;
+    int baseline_;
+    double confidence_;
+    std::string output_path_;
+
+    struct Task {
+        size_t point;
+        size_t replication;
+        double cost;
+    };
+
+    // Пополнение сводок по точкам под одним замком
+    class Collector {
+    private:
+        const std::vector<Sweep::Point>& points_;
+        size_t replications_;
+        int baseline_;
+        std::mutex mutex_;
+        std::vector<std::map<size_t, ReplicationMetrics>> pending_;   // по точкам
+        std::vector<size_t> next_;                // следующая репликация к учёту
+        std::vector<char> controlled_;            // точка с управляющей переменной
+        std::vector<ReplicationMetrics> baseline_values_;
+        std::vector<char> baseline_ready_;
+
+    public:
+        Sweep::Report report;
+
+        Collector(const std::vector<Sweep::Point>& points, const std::vector<Analytic::Result>& solutions,
+                  bool short_circuit, bool control_variate, size_t replications, int baseline,
+                  double confidence)
+            : points_(points), replications_(replications), baseline_(baseline),
+              pending_(points.size()), next_(points.size(), 0),
+              controlled_(points.size(), 0),
+              baseline_values_(baseline >= 0 ? replications : 0),
+              baseline_ready_(baseline >= 0 ? replications : 0, 0) {
+            report.points.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                Sweep::PointSummary& summary = report.points[i];
+                summary.point = points[i];
+                if (short_circuit && solutions[i].exact) {
+                    summary.analytic = true;
+                    summary.exact = solutions[i].metrics();
+                } else if (control_variate && solutions[i].utilization_known) {
+                    summary.control_mean = solutions[i].utilization;
+                    controlled_[i] = 1;
+                }
+            }
+            report.confidence = confidence;
+            report.baseline = baseline;
+        }
+
+        void add(size_t point, size_t replication, double ms, ReplicationMetrics metrics) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            report.points[point].cpu_time_ms += ms;
+
+            if (static_cast<int>(point) == baseline_) {
+                baseline_values_[replication] = metrics;
+                baseline_ready_[replication] = 1;
+            }
+            pending_[point].emplace(replication, std::move(metrics));
+            drain(point);
+            // Ожидавшие опорную репликацию точки могут продвинуться
+            if (static_cast<int>(point) == baseline_) {
+                for (size_t p = 0; p < points_.size(); ++p) drain(p);
+            }
+        }
+
+    private:
+        void drain(size_t point) {
+            auto& pending = pending_[point];
+            Sweep::PointSummary& summary = report.points[point];
+            while (!pending.empty() && pending.begin()->first == next_[point]) {
+                size_t r = next_[point];
+                if (baseline_ >= 0 && !baseline_ready_[r]) return;
+                const ReplicationMetrics& metrics = pending.begin()->second;
+                auto control = metrics.find("server_utilization");
+                bool controlled = controlled_[point] && control != metrics.end();
+                for (const auto& [name, value] : metrics) {
+                    summary.metrics[name].add(value);
+                    if (controlled) summary.controlled[name].add(value, control->second);
+                    if (baseline_ >= 0) {
+                        auto base = baseline_values_[r].find(name);
+                        if (base != baseline_values_[r].end()) {
+                            summary.differences[name].add(value - base->second);
+                        }
+                    }
+                }
+                summary.replications++;
+                pending.erase(pending.begin());
+                next_[point]++;
+            }
+        }
+    };
+
+    // Файл строк результатов: схема создаётся по первой готовой репликации
+    class Output {
+    private:
+        std::string path_;
+        std::once_flag once_;
+        std::vector<std::string> metrics_;        // показатели в порядке столбцов
+        std::unique_ptr<Results::Sink> sink_;
+
+    public:
+        explicit Output(const std::string& path) : path_(path) {}
+
+        bool enabled() const { return !path_.empty(); }
+
+        Results::Sink& sink(const ReplicationMetrics& first) {
+            std::call_once(once_, [&]() {
+                using Results::Type;
+                Results::Schema schema = {
+                    {"point", Type::UINT64}, {"replication", Type::UINT64}, {"seed", Type::UINT64},
+                    {"lambda", Type::FLOAT64}, {"mu", Type::FLOAT64}, {"cores", Type::INT64},
+                    {"buffer", Type::INT64}, {"discipline", Type::UTF8}, {"arrival", Type::UTF8},
+                    {"service", Type::UTF8}, {"offered_load", Type::FLOAT64}, {"time_ms", Type::FLOAT64}
+                };
+                for (const auto& entry : first) {
+                    metrics_.push_back(entry.first);
+                    schema.push_back({entry.first, Type::FLOAT64});
+                }
+                sink_ = std::make_unique<Results::Sink>(path_, std::move(schema));
+            });
+            return *sink_;
+        }
+
+        // Строка репликации; показателя нет в этой репликации - NaN
+        void write(Results::Producer& out, const Sweep::Point& p, size_t point, size_t replication,
+                   uint64_t seed, double ms, const ReplicationMetrics& metrics) const {
+            out.put(point).put(replication).put(seed)
+               .put(p.lambda).put(p.mu).put(p.cores).put(p.buffer)
+               .put(QueueDisciplines::QueueStrategyFactory<Job>::type_to_string(p.discipline))
+               .put(Sweep::distribution_name(p.arrival)).put(Sweep::distribution_name(p.service))
+               .put(p.rho()).put(ms);
+            for (const auto& name : metrics_) {
+                auto it = metrics.find(name);
+                out.put(it != metrics.end() ? it->second : std::numeric_limits<double>::quiet_NaN());
+            }
+            out.end_row();
+        }
+
+        // Дописывает строки; все Producer к этому моменту уничтожены
+        size_t close() {
+            if (!sink_) return 0;
+            sink_->close();
+            return sink_->rows_written();
+        }
+    };
+
+    std::vector<Task> schedule(const std::vector<Sweep::Point>& points,
+                               const std::vector<Analytic::Result>& solutions, double time, int jobs) const {
+        std::vector<Task> tasks;
+        tasks.reserve(points.size() * replications_);
+        for (size_t p = 0; p < points.size(); ++p) {
+            if (short_circuit_ && solutions[p].exact) continue;
+            for (size_t r = 0; r < replications_; ++r) {
+                tasks.push_back(Task{p, r, cost(points[p], time, jobs)});
+            }
+        }
+        std::stable_sort(tasks.begin(), tasks.end(),
+                         [](const Task& a, const Task& b) { return a.cost > b.cost; });
+        return tasks;
+    }
+
+    // Решения нужны только при обходе или управляющей переменной
+    std::vector<Analytic::Result> solve(const std::vector<Sweep::Point>& points) const {
+        std::vector<Analytic::Result> solutions(points.size());
+        if (!short_circuit_ && !control_variate_) return solutions;
+        for (size_t p = 0; p < points.size(); ++p) solutions[p] = points[p].solve();
+        return solutions;
+    }
+
+    void check(const std::vector<Sweep::Point>& points, const std::vector<Analytic::Result>& solutions) const {
+        if (baseline_ >= static_cast<int>(points.size())) {
+            throw std::invalid_argument("Опорная точка за пределами плана");
+        }
+        if (baseline_ >= 0 && short_circuit_) {
+            for (const auto& solution : solutions) {
+                if (solution.exact) {
+                    throw std::invalid_argument("Парные разности требуют моделирования всех точек: "
+                                                "отключите аналитический обход");
+                }
+            }
+        }
+    }
+
+    // producer - пакет строк работника, создаётся при первой его репликации
+    void execute(const Task& task, const std::vector<Sweep::Point>& points, const Simulate& simulate,
+                 Collector& collector, Output& output, std::unique_ptr<Results::Producer>& producer) const {
+        uint64_t seed = seed_for(task.point, task.replication);
+        auto start = std::chrono::steady_clock::now();
+        ReplicationMetrics metrics = simulate(points[task.point], seed);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (output.enabled()) {
+            if (!producer) producer = std::make_unique<Results::Producer>(output.sink(metrics));
+            output.write(*producer, points[task.point], task.point, task.replication, seed, ms, metrics);
+        }
+        collector.add(task.point, task.replication, ms, std::move(metrics));
+    }
+
+public:
+    /**
+     * @param pool пул потоков (например, ReplicationRunner::pool())
+     * @param master_seed главное зерно
+     * @param replications репликаций на точку
+     */
+    SweepEngine(Parallel::ThreadPool& pool, uint64_t master_seed, size_t replications)
+        : pool_(pool), master_seed_(master_seed), replications_(replications),
+          common_random_numbers_(true), short_circuit_(false), control_variate_(false),
+          baseline_(-1), confidence_(0.95) {
+        if (replications == 0) throw std::invalid_argument("Число репликаций должно быть положительным");
+    }
+
+    void set_common_random_numbers(bool enabled) { common_random_numbers_ = enabled; }
+    bool common_random_numbers() const { return common_random_numbers_; }
+
+    // Не моделировать точки с точным аналитическим решением
+    void set_short_circuit(bool enabled) { short_circuit_ = enabled; }
+    bool short_circuit() const { return short_circuit_; }
+
+    // Корректировать оценки по загрузке ядер с известным средним
+    void set_control_variate(bool enabled) { control_variate_ = enabled; }
+    bool control_variate() const { return control_variate_; }
+
+    // Точка, относительно которой накапливаются парные разности (-1 - нет)
+    void set_baseline(int point) { baseline_ = point; }
+
+    void set_confidence(double confidence) {
+        if (confidence <= 0.0 || confidence >= 1.0) {
+            throw std::invalid_argument("Доверительная вероятность должна лежать в (0, 1)");
+        }
+        confidence_ = confidence;
+    }
+
+    // Столбцовый файл строк результатов Results (пустая строка - не писать)
+    void set_output(const std::string& path) { output_path_ = path; }
+
+    size_t replications() const { return replications_; }
+    uint64_t master_seed() const { return master_seed_; }
+    double confidence() const { return confidence_; }
+    int baseline() const { return baseline_; }
+
+    /**
+     * Зерно репликации зависит только от (точка, репликация), поэтому потоки
+     * разных потоков и узлов (Distributed::Coordinator) не пересекаются, а
+     * результат не зависит от того, где выполнена репликация
+     */
+    static uint64_t seed_for(uint64_t master_seed, size_t replications, bool common_random_numbers,
+                             size_t point, size_t replication) {
+        size_t index = common_random_numbers ? replication : point * replications + replication;
+        return GeneratorFactory::derive_seed(master_seed, index);
+    }
+
+    uint64_t seed_for(size_t point, size_t replication) const {
+        return seed_for(master_seed_, replications_, common_random_numbers_, point, replication);
+    }
+
+    // Оценка стоимости репликации - ожидаемое число событий
+    static double cost(const Sweep::Point& p, double time, int jobs) {
+        return jobs > 0 ? 2.0 * jobs : 2.0 * p.lambda * time;
+    }
+
+    /**
+     * Параллельный прогон плана
+     * @param time горизонт моделирования (для оценки стоимости и standard())
+     * @param jobs предел заданий вместо горизонта (0 - по времени)
+     */
+    Sweep::Report run(const std::vector<Sweep::Point>& points, const Simulate& simulate,
+                      double time, int jobs = 0) {
+        std::vector<Analytic::Result> solutions = solve(points);
+        check(points, solutions);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Task> tasks = schedule(points, solutions, time, jobs);
+        Collector collector(points, solutions, short_circuit_, control_variate_, replications_, baseline_,
+                            confidence_);
+        Output output(output_path_);
+
+        std::atomic<size_t> next(0);
+        std::vector<std::future<void>> workers;
+        size_t count = std::min(pool_.size(), tasks.size());
+        for (size_t w = 0; w < count; ++w) {
+            workers.push_back(pool_.submit([&]() {
+                std::unique_ptr<Results::Producer> producer;
+                for (size_t i = next.fetch_add(1); i < tasks.size(); i = next.fetch_add(1)) {
+                    execute(tasks[i], points, simulate, collector, output, producer);
+                }
+            }));
+        }
+        // Все работники дожидаются до выхода: исключение одного не оставляет
+        // остальных со ссылками на локальные переменные
+        std::exception_ptr failure;
+        for (auto& worker : workers) {
+            try {
+                worker.get();
+            } catch (...) {
+                if (!failure) failure = std::current_exception();
+                next = tasks.size();
+            }
+        }
+        if (failure) std::rethrow_exception(failure);
+        collector.report.rows_written = output.close();
+
+        collector.report.wall_time_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return std::move(collector.report);
+    }
+
+    Sweep::Report run(const std::vector<Sweep::Point>& points, double time, int jobs = 0) {
+        return run(points, standard(time, jobs), time, jobs);
+    }
+
+    // Тот же план в вызывающем потоке в том же порядке заданий (эталон для сравнения)
+    Sweep::Report run_sequential(const std::vector<Sweep::Point>& points, const Simulate& simulate,
+                                 double time, int jobs = 0) {
+        std::vector<Analytic::Result> solutions = solve(points);
+        check(points, solutions);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Task> tasks = schedule(points, solutions, time, jobs);
+        Collector collector(points, solutions, short_circuit_, control_variate_, replications_, baseline_,
+                            confidence_);
+        Output output(output_path_);
+        {
+            std::unique_ptr<Results::Producer> producer;
+            for (const Task& task : tasks) execute(task, points, simulate, collector, output, producer);
+        }
+        collector.report.rows_written = output.close();
+        collector.report.wall_time_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return std::move(collector.report);
+    }
+
+    Sweep::Report run_sequential(const std::vector<Sweep::Point>& points, double time, int jobs = 0) {
+        return run_sequential(points, standard(time, jobs), time, jobs);
+    }
+};
+
+#endif // SWEEP_ENGINE_H
@@ -0,0 +1,37 @@
+// Выгрузка столбцового файла строк результатов (Results::Sink) в CSV.
+//
+//   results_export <вход.rslt> <выход.csv>
+//
+// Печатает схему файла; оборванный последний пакет (прерванная запись)
+// пропускается.
+
+#include "common/results.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+static void usage() {
+    cerr << "Использование: results_export <вход.rslt> <выход.csv>\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        usage();
+        return 2;
+    }
+
+    try {
+        Results::Reader reader(argv[1]);
+        for (const Results::Field& field : reader.schema()) {
+            cout << "  " << left << setw(28) << field.name << right << Results::type_name(field.type) << "\n";
+        }
+        size_t rows = Results::export_csv(argv[1], argv[2]);
+        cout << "Столбцов: " << reader.schema().size() << ", строк: " << rows << "\n";
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Вычислительный узел распределённого перебора (Distributed::Worker).
+//
+//   sweep_worker <хост координатора> <порт> [--processes N]
+//
+// Узел - один поток моделирования; --processes запускает N узлов на этой
+// машине (обычно по числу ядер). Модель - SweepEngine::standard из плана.
+
+#include "distributed/cluster.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static void usage() {
+    cerr << "Использование: sweep_worker <хост> <порт> [--processes N]\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 5) {
+        usage();
+        return 2;
+    }
+    size_t processes = 1;
+    if (argc == 5) {
+        if (string(argv[3]) != "--processes") {
+            usage();
+            return 2;
+        }
+        processes = stoul(argv[4]);
+    }
+
+    try {
+        string host = argv[1];
+        uint16_t port = static_cast<uint16_t>(stoul(argv[2]));
+        if (processes == 1) {
+            size_t done = Distributed::Worker(host, port).serve();
+            cout << "Выполнено репликаций: " << done << "\n";
+            return 0;
+        }
+        Distributed::LocalWorkers workers(processes, port, {}, host);
+        if (!workers.wait()) {
+            cerr << "Ошибка: часть узлов завершилась с ошибкой\n";
+            return 1;
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}